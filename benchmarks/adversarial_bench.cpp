@@ -0,0 +1,138 @@
+/**
+ * @file adversarial_bench.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Lexing time per byte on pathological inputs
+ * @version 0.1
+ * @date 2023-06-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Project files
+#include "../src/lexer/lexer.h"
+#include "../src/lexer/scanner.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Generator of an adversarial input of a given size
+     * @struct Case
+     */
+    struct Case
+    {
+        const char *name;
+        std::function<std::string(std::size_t)> generate;
+    };
+
+    /**
+     * @brief
+     * Repeats a pattern until a size is reached
+     * @param pattern Pattern to repeat
+     * @param size Size of the result
+     * @return std::string Repeated pattern
+     */
+    std::string repeat(const std::string_view &pattern, std::size_t size)
+    {
+        std::string result;
+        result.reserve(size + pattern.size());
+
+        while (result.size() < size)
+            result.append(pattern);
+
+        result.resize(size);
+        return result;
+    }
+
+    /**
+     * @brief
+     * Measures a function in nanoseconds per byte of input
+     * @param bytes Size of the input
+     * @param func Function to measure
+     * @return double Nanoseconds per byte
+     */
+    double ns_per_byte(std::size_t bytes, const std::function<void()> &func)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::nano>(end - start).count() /
+               static_cast<double>(bytes);
+    }
+
+    const std::vector<Case> cases{
+        {"minified_line", [](std::size_t size)
+         { return repeat("if(a==b){c=d+1.5;}else{e=f[g]-0x2;}", size); }},
+        {"giant_string", [](std::size_t size)
+         { return "\"" + repeat("a", size - 2) + "\""; }},
+        {"unterminated_string", [](std::size_t size)
+         { return "\"" + repeat("ab cd ", size - 1); }},
+        {"unterminated_string_lines", [](std::size_t size)
+         { return repeat("\"ab cd\n", size); }},
+        {"giant_comment", [](std::size_t size)
+         { return "/*" + repeat("x *\n", size - 4) + "*/"; }},
+        {"unterminated_comment", [](std::size_t size)
+         { return "/*" + repeat("x ", size - 2); }},
+        {"repeated_comment_open", [](std::size_t size)
+         { return repeat("/* ", size); }},
+        {"repeated_punctuation", [](std::size_t size)
+         { return repeat("{}()[];,.:?<>+-*%&=!", size); }},
+        {"repeated_numbers", [](std::size_t size)
+         { return repeat("1.2.", size); }},
+    };
+}
+
+/**
+ * @brief
+ * Prints the time per byte of every adversarial case at growing sizes.
+ * Linear lexing shows the same time per byte at every size.
+ * @param argc Number of arguments
+ * @param argv Optional largest input size in bytes
+ * @return int 0
+ */
+int main(int argc, char **argv)
+{
+    const std::size_t max_size = argc > 1 ? std::strtoull(argv[1], nullptr, 10)
+                                          : 4 * 1024 * 1024;
+    Lexer lexer;
+
+    std::printf("%-28s %12s %14s %14s\n", "case", "bytes", "scan ns/B",
+                "lex ns/B");
+
+    for (const auto &test : cases)
+    {
+        for (std::size_t size = 256 * 1024; size <= max_size; size *= 2)
+        {
+            const auto source = test.generate(size);
+            std::size_t count{};
+
+            const auto scan = ns_per_byte(size, [&]()
+                                          {
+                Scanner scanner(source);
+                std::string_view token;
+
+                while (scanner.next(token))
+                    ++count; });
+
+            const auto lex = ns_per_byte(size, [&]()
+                                         { lexer.highlight(source, OutputFormat::Tokens); });
+
+            std::printf("%-28s %12zu %14.2f %14.2f\n", test.name, size, scan,
+                        lex);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+/**
+ * @file small_files_bench.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Per-file cost of the parallel lexer on many tiny files
+ * @version 0.1
+ * @date 2023-06-20
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Project files
+#include "../src/lexer/lexer.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Small C# file, about 600 bytes once numbered
+     */
+    constexpr const char *sample =
+        "using System;\n"
+        "\n"
+        "namespace Samples\n"
+        "{\n"
+        "    // Prints a greeting and a running total\n"
+        "    public class Program%zu\n"
+        "    {\n"
+        "        public static void Main(string[] args)\n"
+        "        {\n"
+        "            int total = 0;\n"
+        "            for (int i = 0; i < 10; i++)\n"
+        "            {\n"
+        "                total += i * 2;\n"
+        "            }\n"
+        "            /* The total is printed once */\n"
+        "            Console.WriteLine(\"Total: \" + total);\n"
+        "        }\n"
+        "    }\n"
+        "}\n";
+
+    /**
+     * @brief
+     * Writes the sample files, each with its own class name so that none
+     * of them is deduplicated
+     * @param directory Directory to write to
+     * @param count Number of files
+     * @return std::vector<std::string> Paths of the files
+     */
+    std::vector<std::string> write_samples(const std::filesystem::path &directory,
+                                           std::size_t count)
+    {
+        std::vector<std::string> filenames;
+        char buffer[1024];
+
+        for (std::size_t i{}; i < count; ++i)
+        {
+            const auto path = directory / ("sample" + std::to_string(i) + ".cs");
+            const auto length = std::snprintf(buffer, sizeof(buffer), sample, i);
+
+            std::ofstream(path, std::ios::binary).write(buffer, length);
+            filenames.push_back(path.string());
+        }
+
+        return filenames;
+    }
+}
+
+/**
+ * @brief
+ * Measures the best time of several runs
+ * @param repetitions Number of runs
+ * @param func Function to measure
+ * @return double Best time in milliseconds
+ */
+template <class F>
+double best_of(int repetitions, F &&func)
+{
+    double best{};
+
+    for (int run{}; run < repetitions; ++run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+        const double elapsed =
+            std::chrono::duration<double, std::milli>(end - start).count();
+
+        best = run == 0 ? elapsed : std::min(best, elapsed);
+    }
+
+    return best;
+}
+
+/**
+ * @brief
+ * Prints the cost of dispatching one task per file against one task per
+ * group of files, then lexes the same set of tiny files both ways
+ * @param argc Number of arguments
+ * @param argv Optional number of files, number of repetitions and
+ *        scratch directory, preferably on tmpfs
+ * @return int 0
+ */
+int main(int argc, char **argv)
+{
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000;
+    const int repetitions = argc > 2 ? std::atoi(argv[2]) : 5;
+    const std::filesystem::path scratch =
+        argc > 3 ? std::filesystem::path(argv[3])
+                 : std::filesystem::temp_directory_path();
+    const std::vector<std::size_t> group_sizes{0, 64 * 1024, 256 * 1024};
+
+    // Scheduling alone: the work of a file is a counter increment
+    std::printf("Dispatch of %zu empty files, best of %d runs\n", count,
+                repetitions);
+    std::printf("%-12s %12s %14s\n", "group size", "total ms", "us per file");
+
+    {
+        ThreadPool pool(std::thread::hardware_concurrency());
+        std::atomic<std::size_t> done{0};
+
+        for (const auto group_size : group_sizes)
+        {
+            // Files of 600 bytes, as in the lexing run below
+            const std::size_t per_task =
+                group_size == 0 ? 1 : std::max<std::size_t>(group_size / 600, 1);
+
+            const auto elapsed = best_of(repetitions, [&]()
+                                         {
+                Batch batch(pool);
+
+                for (std::size_t first{}; first < count; first += per_task)
+                {
+                    const auto last = std::min(count, first + per_task);
+                    batch.submit([&done, first, last]()
+                                 { done += last - first; });
+                }
+
+                batch.wait(); });
+
+            std::printf("%-12zu %12.3f %14.3f\n", group_size, elapsed,
+                        elapsed * 1000.0 / static_cast<double>(count));
+        }
+    }
+
+    // Outputs are written relative to the working directory
+    const auto root = scratch / "small_files_bench";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "in");
+    std::filesystem::create_directories(root / "work");
+    std::filesystem::create_directories(root / "outputParallel");
+    std::filesystem::current_path(root / "work");
+
+    const auto filenames = write_samples(root / "in", count);
+
+    std::printf("\nLexing %zu files in %s, best of %d runs\n", count,
+                scratch.c_str(), repetitions);
+    std::printf("%-12s %12s %14s\n", "group size", "total ms", "us per file");
+
+    for (const auto group_size : group_sizes)
+    {
+        Lexer lexer;
+        lexer.set_group_size(group_size);
+        lexer.start_multi(filenames);
+
+        const auto elapsed = best_of(repetitions, [&]()
+                                     { lexer.start_multi(filenames); });
+
+        std::printf("%-12zu %12.2f %14.2f\n", group_size, elapsed,
+                    elapsed * 1000.0 / static_cast<double>(count));
+    }
+
+    std::filesystem::current_path(scratch);
+    std::filesystem::remove_all(root);
+
+    return 0;
+}
@@ -0,0 +1,499 @@
+/**
+ * @file identifier_index.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the IndexBuilder and IdentifierIndex classes
+ * @version 0.1
+ * @date 2023-06-30
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Project files
+#include "identifier_index.h"
+#include "../utils/binary.h"
+
+namespace
+{
+    /**
+     * @brief
+     * First bytes of every index, the last one is the format version
+     */
+    constexpr std::string_view index_magic{"LEXIDX01", 8};
+
+    /**
+     * @brief
+     * Size of the header: magic, file, identifier and posting counts, and
+     * the offsets of the files, identifiers, postings and strings
+     */
+    constexpr std::uint64_t header_size = 8 + 7 * sizeof(std::uint64_t);
+
+    /**
+     * @brief
+     * Size of a file entry: offset and size of its name in the strings
+     */
+    constexpr std::uint64_t file_entry_size = 2 * sizeof(std::uint64_t);
+
+    /**
+     * @brief
+     * Size of an identifier entry: offset and size of its name in the
+     * strings, first posting and number of postings
+     */
+    constexpr std::uint64_t term_entry_size = 4 * sizeof(std::uint64_t);
+
+    /**
+     * @brief
+     * Source of the identifiers of the IndexBuilder instances
+     */
+    std::atomic<std::uint64_t> next_id{1};
+
+    /**
+     * @brief
+     * Slot of the calling thread in the last builder it added to
+     */
+    thread_local std::uint64_t cached_id{0};
+    thread_local void *cached_slot{nullptr};
+
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Index Builder:: Index Builder object, without postings
+ */
+IndexBuilder::IndexBuilder()
+    : m_id(next_id++)
+{
+}
+
+// Access methods
+/**
+ * @brief
+ * Gets the number of postings added so far, without the copies of the
+ * linked files
+ * @return std::size_t Number of postings
+ */
+std::size_t IndexBuilder::get_posting_count() const
+{
+    std::lock_guard<std::mutex> lock(m_slots_mutex);
+    std::size_t count{};
+
+    for (const auto &slot : m_slots)
+        count += slot->entries.size();
+
+    return count;
+}
+
+// Methods
+/**
+ * @brief
+ * Adds an occurrence of an identifier. Can be called from any thread
+ * @param id Id of the identifier in the intern table
+ * @param file Index of the file in the run
+ * @param offset Offset of the identifier in the file. Offsets past 4 GiB
+ *        are not indexed
+ */
+void IndexBuilder::add(std::uint32_t id, std::size_t file, std::size_t offset)
+{
+    constexpr auto max_offset = std::numeric_limits<std::uint32_t>::max();
+
+    if (offset > max_offset || file > max_offset)
+        return;
+
+    get_slot().entries.push_back(
+        {id, {static_cast<std::uint32_t>(file), static_cast<std::uint32_t>(offset)}});
+}
+
+/**
+ * @brief
+ * Records that a file is a copy of another one, so that it gets the same
+ * postings without being lexed. Can be called from any thread
+ * @param file Index of the copy in the run
+ * @param source Index of the file it copies
+ */
+void IndexBuilder::link(std::size_t file, std::size_t source)
+{
+    std::lock_guard<std::mutex> lock(m_slots_mutex);
+    m_links.emplace_back(static_cast<std::uint32_t>(file),
+                         static_cast<std::uint32_t>(source));
+}
+
+/**
+ * @brief
+ * Merges the postings of every thread and writes the index, which then
+ * replaces the previous one. Must not run while postings are added
+ * @param filename Index file
+ * @param filenames Files of the run, by index
+ * @param identifiers Intern table the ids of the postings belong to
+ * @throw std::runtime_error If the index cannot be written
+ */
+void IndexBuilder::write(const std::string &filename,
+                         const std::vector<std::string> &filenames,
+                         const InternTable &identifiers) const
+{
+    std::vector<Entry> entries;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> links;
+
+    {
+        std::lock_guard<std::mutex> lock(m_slots_mutex);
+        std::size_t count{};
+
+        for (const auto &slot : m_slots)
+            count += slot->entries.size();
+
+        entries.reserve(count);
+
+        for (const auto &slot : m_slots)
+            entries.insert(entries.end(), slot->entries.begin(), slot->entries.end());
+
+        links = m_links;
+    }
+
+    // Copies get the postings of the file they copy
+    if (!links.empty())
+    {
+        std::sort(links.begin(), links.end(), [](const auto &lhs, const auto &rhs)
+                  { return lhs.second < rhs.second; });
+
+        const auto original = entries.size();
+
+        for (std::size_t i{}; i < original; ++i)
+        {
+            auto copy = std::lower_bound(links.begin(), links.end(), entries[i].posting.file,
+                                         [](const auto &link, std::uint32_t source)
+                                         { return link.second < source; });
+
+            for (; copy != links.end() && copy->second == entries[i].posting.file; ++copy)
+                entries.push_back({entries[i].id, {copy->first, entries[i].posting.offset}});
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs)
+              { return std::tie(lhs.id, lhs.posting.file, lhs.posting.offset) <
+                       std::tie(rhs.id, rhs.posting.file, rhs.posting.offset); });
+
+    // Postings of one identifier among the sorted entries
+    struct Term
+    {
+        std::string_view name;
+        std::size_t begin;
+        std::size_t count;
+    };
+
+    std::vector<Term> terms;
+
+    for (std::size_t begin{}; begin < entries.size();)
+    {
+        auto end = begin + 1;
+
+        while (end < entries.size() && entries[end].id == entries[begin].id)
+            ++end;
+
+        terms.push_back({identifiers.lookup(entries[begin].id), begin, end - begin});
+        begin = end;
+    }
+
+    std::sort(terms.begin(), terms.end(), [](const Term &lhs, const Term &rhs)
+              { return lhs.name < rhs.name; });
+
+    const std::uint64_t files_offset = header_size;
+    const std::uint64_t terms_offset = files_offset + filenames.size() * file_entry_size;
+    const std::uint64_t postings_offset = terms_offset + terms.size() * term_entry_size;
+    const std::uint64_t strings_offset = postings_offset + entries.size() * sizeof(IndexPosting);
+
+    std::string index;
+    index.reserve(strings_offset);
+    index.append(index_magic);
+
+    for (const auto value : {std::uint64_t{filenames.size()}, std::uint64_t{terms.size()},
+                             std::uint64_t{entries.size()}, files_offset, terms_offset,
+                             postings_offset, strings_offset})
+        utils::append_integer(index, value);
+
+    std::uint64_t string_position{};
+
+    for (const auto &name : filenames)
+    {
+        utils::append_integer(index, string_position);
+        utils::append_integer(index, std::uint64_t{name.size()});
+        string_position += name.size();
+    }
+
+    std::uint64_t posting_position{};
+
+    for (const auto &term : terms)
+    {
+        utils::append_integer(index, string_position);
+        utils::append_integer(index, std::uint64_t{term.name.size()});
+        utils::append_integer(index, posting_position);
+        utils::append_integer(index, std::uint64_t{term.count});
+        string_position += term.name.size();
+        posting_position += term.count;
+    }
+
+    for (const auto &term : terms)
+    {
+        for (std::size_t i{}; i < term.count; ++i)
+        {
+            const auto &posting = entries[term.begin + i].posting;
+            utils::append_integer(index, posting.file);
+            utils::append_integer(index, posting.offset);
+        }
+    }
+
+    for (const auto &name : filenames)
+        index.append(name);
+
+    for (const auto &term : terms)
+        index.append(term.name);
+
+    const auto temporary = filename + ".tmp";
+    std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+
+    if (!output || !output.write(index.data(), static_cast<std::streamsize>(index.size())) ||
+        !output.flush())
+    {
+        std::filesystem::remove(temporary);
+        throw std::runtime_error("Cannot write file: " + filename);
+    }
+
+    output.close();
+    std::error_code error;
+    std::filesystem::rename(temporary, filename, error);
+
+    if (error)
+    {
+        std::filesystem::remove(temporary);
+        throw std::runtime_error("Cannot write file: " + filename + ": " +
+                                 error.message());
+    }
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Gets the slot of the calling thread, creating it on first use
+ * @return Slot& Slot of the thread
+ */
+IndexBuilder::Slot &IndexBuilder::get_slot()
+{
+    if (cached_id == m_id)
+        return *static_cast<Slot *>(cached_slot);
+
+    std::lock_guard<std::mutex> lock(m_slots_mutex);
+    const auto thread = std::this_thread::get_id();
+    Slot *slot{nullptr};
+
+    // The thread may have added to another instance in between
+    for (const auto &existing : m_slots)
+        if (existing->thread == thread)
+            slot = existing.get();
+
+    if (!slot)
+    {
+        slot = m_slots.emplace_back(std::make_unique<Slot>()).get();
+        slot->thread = thread;
+    }
+
+    cached_id = m_id;
+    cached_slot = slot;
+    return *slot;
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Identifier Index:: Identifier Index object, mapping an
+ * index and checking that its sections fit in it
+ * @param filename Index file
+ * @throw std::runtime_error If the file cannot be read or is not an index
+ */
+IdentifierIndex::IdentifierIndex(const std::string &filename)
+    : m_filename(filename)
+{
+    const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        throw std::runtime_error("Cannot open file: " + filename + ": " +
+                                 std::strerror(errno));
+
+    struct stat status
+    {
+    };
+
+    if (::fstat(fd, &status) != 0 ||
+        static_cast<std::uint64_t>(status.st_size) < header_size)
+    {
+        ::close(fd);
+        throw std::runtime_error("Not an identifier index: " + filename);
+    }
+
+    m_mapping_size = static_cast<std::size_t>(status.st_size);
+    m_mapping = ::mmap(nullptr, m_mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (m_mapping == MAP_FAILED)
+    {
+        m_mapping = nullptr;
+        throw std::runtime_error("Cannot map file: " + filename + ": " +
+                                 std::strerror(errno));
+    }
+
+    const auto *data = static_cast<const char *>(m_mapping);
+    const std::uint64_t size = m_mapping_size;
+
+    m_file_count = utils::load_integer<std::uint64_t>(data + 8);
+    m_term_count = utils::load_integer<std::uint64_t>(data + 16);
+    m_posting_count = utils::load_integer<std::uint64_t>(data + 24);
+    const auto files_offset = utils::load_integer<std::uint64_t>(data + 32);
+    const auto terms_offset = utils::load_integer<std::uint64_t>(data + 40);
+    const auto postings_offset = utils::load_integer<std::uint64_t>(data + 48);
+    const auto strings_offset = utils::load_integer<std::uint64_t>(data + 56);
+
+    // The counts are bounded first, so the section sizes cannot overflow
+    if (std::string_view(data, index_magic.size()) != index_magic ||
+        m_file_count > size / file_entry_size ||
+        m_term_count > size / term_entry_size ||
+        m_posting_count > size / sizeof(IndexPosting) ||
+        files_offset != header_size ||
+        terms_offset != files_offset + m_file_count * file_entry_size ||
+        postings_offset != terms_offset + m_term_count * term_entry_size ||
+        strings_offset != postings_offset + m_posting_count * sizeof(IndexPosting) ||
+        strings_offset > size)
+    {
+        ::munmap(m_mapping, m_mapping_size);
+        m_mapping = nullptr;
+        throw std::runtime_error("Not an identifier index: " + filename);
+    }
+
+    m_files = data + files_offset;
+    m_terms = data + terms_offset;
+    m_postings = reinterpret_cast<const IndexPosting *>(data + postings_offset);
+    m_strings = std::string_view(data + strings_offset, size - strings_offset);
+}
+
+/**
+ * @brief
+ * Destroy the Identifier Index object
+ */
+IdentifierIndex::~IdentifierIndex()
+{
+    if (m_mapping)
+        ::munmap(m_mapping, m_mapping_size);
+}
+
+// Access methods
+/**
+ * @brief
+ * Gets the number of distinct identifiers of the index
+ * @return std::size_t Number of identifiers
+ */
+std::size_t IdentifierIndex::size() const noexcept
+{
+    return static_cast<std::size_t>(m_term_count);
+}
+
+/**
+ * @brief
+ * Gets the number of files of the run that wrote the index
+ * @return std::size_t Number of files
+ */
+std::size_t IdentifierIndex::get_file_count() const noexcept
+{
+    return static_cast<std::size_t>(m_file_count);
+}
+
+/**
+ * @brief
+ * Gets the name of a file of the index, as given to the run
+ * @param file Index of the file, as in a posting
+ * @return std::string_view Name of the file, valid while the index is
+ * @throw std::out_of_range If the index has no such file
+ * @throw std::runtime_error If the name is outside the index
+ */
+std::string_view IdentifierIndex::get_file(std::uint32_t file) const
+{
+    if (file >= m_file_count)
+        throw std::out_of_range("No file " + std::to_string(file) + " in " +
+                                m_filename);
+
+    return get_string(m_files + file * file_entry_size);
+}
+
+// Methods
+/**
+ * @brief
+ * Finds the occurrences of an identifier, sorted by file then offset
+ * @param name Identifier to look for
+ * @return std::span<const IndexPosting> Postings of the identifier, empty
+ *         if it does not occur. Valid while the index is
+ * @throw std::runtime_error If the entries searched are outside the index
+ */
+std::span<const IndexPosting> IdentifierIndex::find(std::string_view name) const
+{
+    std::uint64_t low{};
+    std::uint64_t high = m_term_count;
+
+    while (low < high)
+    {
+        const auto middle = low + (high - low) / 2;
+
+        if (get_string(m_terms + middle * term_entry_size) < name)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    if (low == m_term_count)
+        return {};
+
+    const auto *entry = m_terms + low * term_entry_size;
+
+    if (get_string(entry) != name)
+        return {};
+
+    const auto first = utils::load_integer<std::uint64_t>(entry + 16);
+    const auto count = utils::load_integer<std::uint64_t>(entry + 24);
+
+    if (first > m_posting_count || count > m_posting_count - first)
+        throw std::runtime_error("Corrupt identifier index: " + m_filename);
+
+    return {m_postings + first, static_cast<std::size_t>(count)};
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Reads the name an entry points to in the strings
+ * @param entry Entry starting with the offset and size of the name
+ * @return std::string_view Name, valid while the index is
+ * @throw std::runtime_error If the name is outside the strings
+ */
+std::string_view IdentifierIndex::get_string(const char *entry) const
+{
+    const auto offset = utils::load_integer<std::uint64_t>(entry);
+    const auto size = utils::load_integer<std::uint64_t>(entry + 8);
+
+    if (offset > m_strings.size() || size > m_strings.size() - offset)
+        throw std::runtime_error("Corrupt identifier index: " + m_filename);
+
+    return m_strings.substr(offset, size);
+}
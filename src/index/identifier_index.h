@@ -0,0 +1,159 @@
+/**
+ * @file identifier_index.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the IndexBuilder and IdentifierIndex classes
+ * @version 0.1
+ * @date 2023-06-30
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef IDENTIFIER_INDEX_H
+#define IDENTIFIER_INDEX_H
+
+// C++ Standard Libraries
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Project files
+#include "../token/intern_table.h"
+
+/**
+ * @brief
+ * Occurrence of an identifier: the file of the run and the byte offset
+ * of the identifier in it. Offsets count the bytes of the UTF-8 text the
+ * lexer reads, after the BOM is removed and UTF-16 or Latin-1 files are
+ * converted, so they are file offsets only for UTF-8 files without a BOM
+ * @struct IndexPosting
+ */
+struct IndexPosting
+{
+    std::uint32_t file{0};
+    std::uint32_t offset{0};
+};
+
+static_assert(sizeof(IndexPosting) == 8, "postings are stored as they are");
+
+/**
+ * @class IndexBuilder
+ * @brief Collects the postings of the identifiers of a parallel run and
+ * writes them as an identifier index
+ * @details
+ * Every thread appends to a list of its own, found through a thread local
+ * cache, so workers never wait for each other while lexing. The lists are
+ * only merged by write(), once the run is over. Identifiers are the ids
+ * of the intern table of the lexer, resolved to their names when written.
+ */
+class IndexBuilder
+{
+public:
+    // Constructor
+    IndexBuilder();
+
+    IndexBuilder(const IndexBuilder &) = delete;
+    IndexBuilder &operator=(const IndexBuilder &) = delete;
+
+    // Access methods
+    std::size_t get_posting_count() const;
+
+    // Methods
+    void add(std::uint32_t, std::size_t, std::size_t);
+    void link(std::size_t, std::size_t);
+    void write(const std::string &, const std::vector<std::string> &,
+               const InternTable &) const;
+
+private:
+    /**
+     * @brief
+     * Occurrence of an identifier, as recorded during the run
+     * @struct Entry
+     */
+    struct Entry
+    {
+        std::uint32_t id;
+        IndexPosting posting;
+    };
+
+    /**
+     * @brief
+     * Postings of one thread, written by that thread only
+     * @struct Slot
+     */
+    struct Slot
+    {
+        std::thread::id thread;
+        std::vector<Entry> entries;
+    };
+
+    // Identifies the instance in the caches of the threads
+    std::uint64_t m_id;
+
+    mutable std::mutex m_slots_mutex;
+    std::vector<std::unique_ptr<Slot>> m_slots;
+
+    // Files that are copies of another one, with the file they copy
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> m_links;
+
+    // Methods
+    Slot &get_slot();
+};
+
+/**
+ * @class IdentifierIndex
+ * @brief Answers which files use an identifier, and where, from an index
+ * written by IndexBuilder
+ * @details
+ * The index is mapped into memory and read in place: a lookup is a binary
+ * search over the sorted identifiers, then a view of their postings, so
+ * it costs a few page reads whatever the size of the corpus.
+ */
+class IdentifierIndex
+{
+public:
+    // Constructor
+    explicit IdentifierIndex(const std::string &);
+
+    IdentifierIndex(const IdentifierIndex &) = delete;
+    IdentifierIndex &operator=(const IdentifierIndex &) = delete;
+
+    // Destructor
+    ~IdentifierIndex();
+
+    // Access methods
+    std::size_t size() const noexcept;
+    std::size_t get_file_count() const noexcept;
+    std::string_view get_file(std::uint32_t) const;
+
+    // Methods
+    std::span<const IndexPosting> find(std::string_view) const;
+
+private:
+    void *m_mapping{nullptr};
+    std::size_t m_mapping_size{0};
+    std::string m_filename;
+
+    // Sections of the mapping
+    const char *m_files{nullptr};
+    const char *m_terms{nullptr};
+    const IndexPosting *m_postings{nullptr};
+    std::string_view m_strings;
+
+    std::uint64_t m_file_count{0};
+    std::uint64_t m_term_count{0};
+    std::uint64_t m_posting_count{0};
+
+    // Methods
+    std::string_view get_string(const char *) const;
+};
+
+#endif //! IDENTIFIER_INDEX_H
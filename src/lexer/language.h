@@ -0,0 +1,385 @@
+/**
+ * @file language.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Descriptions of the languages the lexer highlights
+ * @version 0.1
+ * @date 2023-06-26
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef LANGUAGE_H
+#define LANGUAGE_H
+
+// C++ standard libraries
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+// Project files
+#include "../token/token_registry.h"
+#include "../utils/fsharp_language.h"
+#include "../utils/typescript_language.h"
+#include "../utils/vb_language.h"
+
+/**
+ * @brief
+ * Languages the lexer highlights
+ * @enum Language
+ */
+enum class Language
+{
+    CSharp,
+    VisualBasic,
+    FSharp,
+    TypeScript
+};
+
+/**
+ * @brief
+ * Number of values of the Language enumeration
+ */
+constexpr std::size_t language_count =
+    static_cast<std::size_t>(Language::TypeScript) + 1;
+
+/**
+ * @brief
+ * Classes of a character, as bit flags
+ * @enum CharClass
+ */
+enum CharClass : std::uint8_t
+{
+    WordChar = 1,
+    SpaceChar = 2,
+    PunctuationChar = 4
+};
+
+using CharClasses = std::array<std::uint8_t, 256>;
+
+/**
+ * @brief
+ * Builds the character classes of a language. ASCII letters, digits and
+ * the underscore are word characters, spaces are the \s of the C locale
+ * @param word Word characters besides letters, digits and underscore
+ * @param punctuation Characters that are single character tokens
+ * @return CharClasses Class of every byte
+ */
+consteval CharClasses make_char_classes(std::string_view word,
+                                        std::string_view punctuation)
+{
+    CharClasses classes{};
+
+    for (unsigned c{}; c < 256; ++c)
+    {
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+            (c >= '0' && c <= '9') || c == '_')
+            classes[c] |= WordChar;
+
+        if (c == ' ' || (c >= '\t' && c <= '\r'))
+            classes[c] |= SpaceChar;
+    }
+
+    for (const char c : word)
+        classes[static_cast<unsigned char>(c)] |= WordChar;
+
+    for (const char c : punctuation)
+        classes[static_cast<unsigned char>(c)] |= PunctuationChar;
+
+    return classes;
+}
+
+/**
+ * @brief
+ * How the strings of a language end
+ * @enum StringRule
+ */
+enum class StringRule
+{
+    // At the last quote of the line, as the original C# expression did
+    LastQuoteOfLine,
+
+    // At the first quote not escaped by a backslash
+    BackslashEscape,
+
+    // At the first quote not doubled, as in "say ""hi"""
+    DoubledQuote
+};
+
+/**
+ * @brief
+ * Source words classified as one token type
+ * @struct WordList
+ */
+struct WordList
+{
+    TokenType type;
+    std::span<const char *const> words;
+};
+
+/**
+ * @brief
+ * Compile-time description of a language: its character classes, the
+ * delimiters of its comments and strings, whether it has # directives,
+ * and its words. The scanner and the classification are instantiated once
+ * per description
+ * @concept LanguageDescription
+ */
+template <class T>
+concept LanguageDescription = requires {
+    { T::id } -> std::convertible_to<Language>;
+    { T::name } -> std::convertible_to<std::string_view>;
+    { T::extensions[0] } -> std::convertible_to<std::string_view>;
+    { T::classes } -> std::convertible_to<CharClasses>;
+    { T::line_comment } -> std::convertible_to<std::string_view>;
+    { T::block_comment_open } -> std::convertible_to<std::string_view>;
+    { T::block_comment_close } -> std::convertible_to<std::string_view>;
+    { T::quotes } -> std::convertible_to<std::string_view>;
+    { T::multiline_quotes } -> std::convertible_to<std::string_view>;
+    { T::strings } -> std::convertible_to<StringRule>;
+    { T::case_insensitive } -> std::convertible_to<bool>;
+    { T::directives } -> std::convertible_to<bool>;
+    { T::words[0] } -> std::convertible_to<WordList>;
+};
+
+namespace languages
+{
+    /**
+     * @brief
+     * Gets the C# words of the token registry as word lists
+     * @return std::array<WordList, token_type_count> Words of every type
+     */
+    consteval std::array<WordList, token_type_count> registry_words()
+    {
+        std::array<WordList, token_type_count> words{};
+
+        for (std::size_t i{}; i < token_type_count; ++i)
+            words[i] = {token_types[i].type, token_types[i].words};
+
+        return words;
+    }
+
+    /**
+     * @brief
+     * Checks that no word list has an empty slot, as left by an array
+     * declared larger than its initializer
+     * @param words Word lists to check
+     * @return true If every word is set
+     */
+    consteval bool has_all_words(std::span<const WordList> words)
+    {
+        for (const auto &list : words)
+            for (const auto word : list.words)
+                if (word == nullptr)
+                    return false;
+
+        return true;
+    }
+}
+
+/**
+ * @brief
+ * C#, the default language
+ * @struct CSharpLanguage
+ */
+struct CSharpLanguage
+{
+    static constexpr Language id = Language::CSharp;
+    static constexpr std::string_view name = "C#";
+    static constexpr std::array<std::string_view, 1> extensions{".cs"};
+    static constexpr CharClasses classes =
+        make_char_classes("", "{}()[];,.:?><+-*/%&=!@#$~_`\\|\"");
+    static constexpr std::string_view line_comment = "//";
+    static constexpr std::string_view block_comment_open = "/*";
+    static constexpr std::string_view block_comment_close = "*/";
+    static constexpr std::string_view quotes = "\"";
+    static constexpr std::string_view multiline_quotes = "";
+    static constexpr StringRule strings = StringRule::LastQuoteOfLine;
+    static constexpr bool case_insensitive = false;
+    static constexpr bool directives = true;
+    static constexpr auto words = languages::registry_words();
+};
+
+/**
+ * @brief
+ * Visual Basic .NET
+ * @struct VisualBasicLanguage
+ */
+struct VisualBasicLanguage
+{
+    static constexpr Language id = Language::VisualBasic;
+    static constexpr std::string_view name = "Visual Basic";
+    static constexpr std::array<std::string_view, 1> extensions{".vb"};
+    static constexpr CharClasses classes =
+        make_char_classes("", "{}()[];,.:?><+-*/\\%&=!@#$~^|\"");
+    static constexpr std::string_view line_comment = "'";
+    static constexpr std::string_view block_comment_open = "";
+    static constexpr std::string_view block_comment_close = "";
+    static constexpr std::string_view quotes = "\"";
+    static constexpr std::string_view multiline_quotes = "";
+    static constexpr StringRule strings = StringRule::DoubledQuote;
+    static constexpr bool case_insensitive = true;
+    static constexpr bool directives = false;
+    static constexpr std::array<WordList, 7> words{{
+        {TokenType::Keyword, vb::m_keywords},
+        {TokenType::Literal, vb::m_literals},
+        {TokenType::Operator, vb::m_operators},
+        {TokenType::Separator, vb::m_separators},
+        {TokenType::Comment, vb::m_comments},
+        {TokenType::ContextualKeyword, vb::m_contextual_keywords},
+        {TokenType::AccessSpecifier, vb::m_access_specifiers},
+    }};
+};
+
+/**
+ * @brief
+ * F#. The apostrophe is a word character, as in x' and 'T
+ * @struct FSharpLanguage
+ */
+struct FSharpLanguage
+{
+    static constexpr Language id = Language::FSharp;
+    static constexpr std::string_view name = "F#";
+    static constexpr std::array<std::string_view, 3> extensions{".fs", ".fsi", ".fsx"};
+    static constexpr CharClasses classes =
+        make_char_classes("'", "{}()[];,.:?><+-*/%&=!@#$~^|\\\"`");
+    static constexpr std::string_view line_comment = "//";
+    static constexpr std::string_view block_comment_open = "(*";
+    static constexpr std::string_view block_comment_close = "*)";
+    static constexpr std::string_view quotes = "\"";
+    static constexpr std::string_view multiline_quotes = "\"";
+    static constexpr StringRule strings = StringRule::BackslashEscape;
+    static constexpr bool case_insensitive = false;
+    static constexpr bool directives = true;
+    static constexpr std::array<WordList, 8> words{{
+        {TokenType::Keyword, fsharp::m_keywords},
+        {TokenType::Literal, fsharp::m_literals},
+        {TokenType::Operator, fsharp::m_operators},
+        {TokenType::Separator, fsharp::m_separators},
+        {TokenType::Comment, fsharp::m_comments},
+        {TokenType::Preprocessor, fsharp::m_preprocessor},
+        {TokenType::ContextualKeyword, fsharp::m_contextual_keywords},
+        {TokenType::AccessSpecifier, fsharp::m_access_specifiers},
+    }};
+};
+
+/**
+ * @brief
+ * TypeScript. Template strings may span lines
+ * @struct TypeScriptLanguage
+ */
+struct TypeScriptLanguage
+{
+    static constexpr Language id = Language::TypeScript;
+    static constexpr std::string_view name = "TypeScript";
+    static constexpr std::array<std::string_view, 4> extensions{".ts", ".tsx", ".mts", ".cts"};
+    static constexpr CharClasses classes =
+        make_char_classes("$", "{}()[];,.:?><+-*/%&=!@#~^|\\\"'`");
+    static constexpr std::string_view line_comment = "//";
+    static constexpr std::string_view block_comment_open = "/*";
+    static constexpr std::string_view block_comment_close = "*/";
+    static constexpr std::string_view quotes = "\"'`";
+    static constexpr std::string_view multiline_quotes = "`";
+    static constexpr StringRule strings = StringRule::BackslashEscape;
+    static constexpr bool case_insensitive = false;
+    static constexpr bool directives = false;
+    static constexpr std::array<WordList, 7> words{{
+        {TokenType::Keyword, typescript::m_keywords},
+        {TokenType::Literal, typescript::m_literals},
+        {TokenType::Operator, typescript::m_operators},
+        {TokenType::Separator, typescript::m_separators},
+        {TokenType::Comment, typescript::m_comments},
+        {TokenType::ContextualKeyword, typescript::m_contextual_keywords},
+        {TokenType::AccessSpecifier, typescript::m_access_specifiers},
+    }};
+};
+
+static_assert(LanguageDescription<CSharpLanguage>);
+static_assert(LanguageDescription<VisualBasicLanguage>);
+static_assert(LanguageDescription<FSharpLanguage>);
+static_assert(LanguageDescription<TypeScriptLanguage>);
+
+static_assert(languages::has_all_words(CSharpLanguage::words));
+static_assert(languages::has_all_words(VisualBasicLanguage::words));
+static_assert(languages::has_all_words(FSharpLanguage::words));
+static_assert(languages::has_all_words(TypeScriptLanguage::words));
+
+/**
+ * @brief
+ * Calls a function with the description of a language, so that code
+ * chosen at run time reaches the code specialized for the language
+ * @tparam Function Callable taking any language description
+ * @param language Language to dispatch on
+ * @param function Function to call
+ * @return decltype(auto) Result of the function
+ */
+template <class Function>
+decltype(auto) visit_language(Language language, Function &&function)
+{
+    switch (language)
+    {
+    case Language::VisualBasic:
+        return function(VisualBasicLanguage{});
+    case Language::FSharp:
+        return function(FSharpLanguage{});
+    case Language::TypeScript:
+        return function(TypeScriptLanguage{});
+    default:
+        return function(CSharpLanguage{});
+    }
+}
+
+/**
+ * @brief
+ * Gets the language of a source file from its extension
+ * @param filename Name or path of the file
+ * @return std::optional<Language> Language, none if no language uses the
+ *         extension
+ */
+inline std::optional<Language> language_of(std::string_view filename)
+{
+    const auto dot = filename.rfind('.');
+    const auto separator = filename.find_last_of("/\\");
+
+    if (dot == std::string_view::npos ||
+        (separator != std::string_view::npos && dot < separator))
+        return std::nullopt;
+
+    const auto extension = filename.substr(dot);
+
+    for (std::size_t i{}; i < language_count; ++i)
+    {
+        const auto language = static_cast<Language>(i);
+        const bool matches = visit_language(language, [extension](auto description)
+                                            {
+            for (const auto candidate : decltype(description)::extensions)
+                if (candidate == extension)
+                    return true;
+
+            return false; });
+
+        if (matches)
+            return language;
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * @brief
+ * Gets the display name of a language
+ * @param language Language
+ * @return std::string_view Name, as in "C#"
+ */
+inline std::string_view language_name(Language language)
+{
+    return visit_language(language, [](auto description)
+                          { return decltype(description)::name; });
+}
+
+#endif //! LANGUAGE_H
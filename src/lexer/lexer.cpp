@@ -14,87 +14,1234 @@
 #include <fstream>
 #include <filesystem>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <numeric>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 // Project files
 #include "lexer.h"
-#include "../threads/thread_pool.h"
+#include "scanner.h"
+#include "../threads/cpu_topology.h"
+#include "../utils/utils.h"
+#include "../utils/encoding.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Start of every html output
+     */
+    constexpr std::string_view html_header =
+        "<!DOCTYPE html>\n"
+        "<html lang=\"en\">\n"
+        "<head>\n"
+        "<meta charset=\"UTF-8\">\n"
+        "<meta http-equiv=\"X-UA-Compatible\" content=\"IE=edge\">\n"
+        "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n"
+        "<title>Highlighter</title>\n"
+        "<link rel=\"stylesheet\" href=\"../src/styles/styles.css\">\n"
+        "</head>\n"
+        "<body style=\"background-color: var(--background-color);\">\n"
+        "<pre><code>\n";
+
+    /**
+     * @brief
+     * End of every html output
+     */
+    constexpr std::string_view html_footer = "</code></pre>\n</body>\n</html>\n";
+
+    /**
+     * @brief
+     * Closing tag written after every token
+     */
+    constexpr std::string_view html_span_end = "</span>";
+
+    /**
+     * @brief
+     * Memory held while lexing a file, per byte of source: the buffer, its
+     * tokens and the pages of its mapped output
+     */
+    constexpr std::size_t memory_per_source_byte = 32;
+
+    /**
+     * @brief
+     * Memory held while lexing a file, whatever its size
+     */
+    constexpr std::size_t memory_per_file = 64 * 1024;
+
+    /**
+     * @brief
+     * Number of tokens rendered by one task of a mapped output
+     */
+    constexpr std::size_t render_range_tokens = 32 * 1024;
+
+    /**
+     * @brief
+     * Number of tokens scanned before they are identified, small enough
+     * for their views to stay in the L1 cache
+     */
+    constexpr std::size_t scan_block_tokens = 256;
+
+    /**
+     * @brief
+     * Identifies the contents of a file by its hash and size
+     */
+    using ContentKey = std::pair<std::uint64_t, std::size_t>;
+
+    /**
+     * @brief
+     * Gets the language a file is lexed as, C# when no language uses its
+     * extension
+     * @param filename Name of the file
+     * @return Language Language of the file
+     */
+    Language source_language(std::string_view filename)
+    {
+        return language_of(filename).value_or(Language::CSharp);
+    }
+
+    /**
+     * @brief
+     * Hash functor for ContentKey
+     */
+    struct ContentKeyHash
+    {
+        std::size_t operator()(const ContentKey &key) const noexcept
+        {
+            return static_cast<std::size_t>(key.first ^ key.second);
+        }
+    };
+
+    /**
+     * @brief
+     * Checks whether a token is made only of whitespace
+     * @param value Token to check
+     * @return true If every character is whitespace
+     */
+    bool is_blank(const std::string &value) noexcept
+    {
+        return std::all_of(value.begin(), value.end(), [](char c)
+                           { return std::isspace(static_cast<unsigned char>(c)); });
+    }
+
+    /**
+     * @brief
+     * Finds line starts where a source can be cut into independently
+     * lexable chunks of roughly chunk_size bytes.
+     * @details The source is scanned once, so line breaks inside strings
+     * and comments are never cut. A line break inside a whitespace run is
+     * a safe cut: the run is split in two and merged back when the chunks
+     * are joined, and a token after it is matched the same from the start
+     * of a chunk, since matching never looks back past a non-word
+     * character. Inactive regions are matched whole, so they are never
+     * cut.
+     * @tparam Description Language of the source
+     * @param source Source code
+     * @param chunk_size Target size of each chunk
+     * @param inactive Regions of the source left out by its directives
+     * @return std::vector<std::size_t> Chunk boundaries, starting with 0 and
+     *         ending with the size of the source
+     */
+    template <LanguageDescription Description>
+    std::vector<std::size_t> find_split_points(const std::string_view &source,
+                                               std::size_t chunk_size,
+                                               std::span<const SourceRange> inactive)
+    {
+        std::vector<std::size_t> bounds{0};
+        std::size_t next_split = chunk_size;
+        const std::size_t size = source.size();
+
+        BasicScanner<Description> scanner(source, inactive);
+        std::string_view token;
+        ScanKind kind;
+
+        while (scanner.next(token, kind))
+        {
+            if (kind != ScanKind::Token ||
+                !BasicScanner<Description>::is_space(token.front()))
+                continue;
+
+            const auto begin = scanner.get_position() - token.size();
+
+            for (auto line = token.find('\n'); line != std::string_view::npos;
+                 line = token.find('\n', line + 1))
+            {
+                const auto cut = begin + line + 1;
+
+                if (cut >= next_split && cut < size)
+                {
+                    bounds.push_back(cut);
+                    next_split = cut + chunk_size;
+                }
+            }
+        }
+
+        bounds.push_back(size);
+        return bounds;
+    }
+}
+
+/**
+ * @brief
+ * Html output split into pages that are rendered by several workers
+ * @struct Lexer::PagedOutput
+ */
+struct Lexer::PagedOutput
+{
+    // Destroyed last, once the pages are freed
+    MemoryBudget::Lease lease;
+
+    std::filesystem::path directory;
+    std::string name;
+    std::vector<std::vector<Token>> pages;
+};
+
+/**
+ * @brief
+ * Html output being rendered into a memory mapped file
+ * @struct Lexer::MappedOutput
+ */
+struct Lexer::MappedOutput
+{
+    // Destroyed last, once the tokens are freed
+    MemoryBudget::Lease lease;
+
+    std::string filename;
+    std::string temporary_filename;
+    std::vector<Token> tokens;
+
+    // Region and name of the output in a bundle, if it goes to one
+    BundleWriter::Region region;
+    std::string bundle_name;
+
+    // Byte offset of every range of tokens, then of the footer
+    std::vector<std::size_t> offsets;
+    std::size_t size{0};
+
+    int fd{-1};
+    char *data{nullptr};
+    std::atomic<std::size_t> remaining{0};
+    bool published{false};
+
+    /**
+     * @brief
+     * Unmaps the file and moves it over the target, or adds the region
+     * to the index of its bundle
+     * @throw std::runtime_error If the file cannot be renamed
+     */
+    void publish()
+    {
+        if (!bundle_name.empty())
+        {
+            data = nullptr;
+            region.commit(std::move(bundle_name));
+            published = true;
+            return;
+        }
+
+        release();
+        std::filesystem::rename(temporary_filename, filename);
+        published = true;
+    }
+
+    /**
+     * @brief
+     * Unmaps and closes the file
+     */
+    void release() noexcept
+    {
+        if (data && bundle_name.empty())
+            ::munmap(data, size);
+
+        region.release();
+
+        if (fd >= 0)
+            ::close(fd);
+
+        data = nullptr;
+        fd = -1;
+    }
+
+    /**
+     * @brief
+     * Destroy the Mapped Output object. An output whose ranges were not
+     * all rendered, because of an error or a cancelled batch, is removed
+     */
+    ~MappedOutput()
+    {
+        release();
+
+        if (!published && !temporary_filename.empty())
+        {
+            std::error_code error;
+            std::filesystem::remove(temporary_filename, error);
+        }
+    }
+};
+
+/**
+ * @brief
+ * State shared by the tasks of one parallel run
+ * @struct Lexer::ParallelRun
+ */
+struct Lexer::ParallelRun
+{
+    ParallelRun(const std::vector<std::string> &names, Batch tasks)
+        : filenames(names), batch(std::move(tasks))
+    {
+    }
+
+    const std::vector<std::string> &filenames;
+
+    // Tasks of the run, including chunk tasks. Unreadable files are
+    // skipped, so exceptions thrown by a task only count as failures
+    Batch batch;
+
+    // Content deduplication
+    std::unordered_map<ContentKey, std::size_t, ContentKeyHash> owners;
+    std::vector<std::pair<std::size_t, std::size_t>> duplicates;
+    std::mutex dedup_mutex;
+};
+
+/**
+ * @brief
+ * A large file lexed as several chunks in parallel
+ * @struct Lexer::SplitJob
+ */
+struct Lexer::SplitJob
+{
+    // Destroyed last, once the buffer and the chunks are freed
+    MemoryBudget::Lease lease;
+
+    std::size_t index;
+    Batch *batch;
+    std::string filename;
+    Language language;
+    std::string buffer;
+    std::vector<SourceRange> inactive;
+    std::vector<std::size_t> bounds;
+    std::vector<std::vector<Token>> parts;
+
+    // Statistics of every chunk, when they are collected
+    std::vector<TokenStats> stats;
+    std::atomic<std::size_t> remaining;
+};
+
+// Access Methods
+/**
+ * @brief
+ * Gets the tokens generated by the lexer
+ * @return std::vector<Token> Vector of tokens
+ */
+const std::vector<Token> Lexer::get_tokens() const noexcept
+{
+    return m_tokens;
+}
+
+/**
+ * @brief
+ * Gets the token statistics of the last run
+ * @return const CorpusStats& Statistics, empty if they were not enabled
+ */
+const CorpusStats &Lexer::get_stats() const noexcept
+{
+    return m_stats;
+}
+
+/**
+ * @brief
+ * Gets the timeline of the runs, recorded while tracing is enabled
+ * @return const Trace& Trace of the runs
+ */
+const Trace &Lexer::get_trace() const noexcept
+{
+    return m_trace;
+}
+
+/**
+ * @brief
+ * Gets the performance counters of the stages of the last run
+ * @return const PerfCounters& Counters, empty if they were not enabled
+ */
+const PerfCounters &Lexer::get_perf_counters() const noexcept
+{
+    return m_perf_counters;
+}
+
+/**
+ * @brief
+ * Gets the number of workers used by the parallel lexer
+ * @return std::size_t Configured number of workers, or the number of CPUs
+ *         available to the process when none was configured
+ */
+std::size_t Lexer::get_worker_count() const
+{
+    return m_worker_count != 0 ? m_worker_count
+                               : cpu::default_worker_count();
+}
+
+/**
+ * @brief
+ * Gets the thread pool shared by every run of the lexer, creating it on
+ * first use
+ * @return ThreadPool& Shared thread pool
+ */
+ThreadPool &Lexer::get_pool()
+{
+    std::lock_guard<std::mutex> lock(m_pool_mutex);
+
+    if (!m_pool)
+    {
+        m_pool = std::make_unique<ThreadPool>(get_worker_count(),
+                                              m_pin_workers);
+
+        if (m_trace.is_enabled())
+            m_pool->set_trace(&m_trace);
+    }
+
+    return *m_pool;
+}
+
+/**
+ * @brief
+ * Gets the memory budget of the parallel runs
+ * @return const MemoryBudget& Budget, with the peak of the last run
+ */
+const MemoryBudget &Lexer::get_memory_budget() const noexcept
+{
+    return m_memory_budget;
+}
+
+/**
+ * @brief
+ * Gets the number of files dropped by a cancellation or a deadline in
+ * the last run
+ * @return std::size_t Number of dropped files and chunks
+ */
+std::size_t Lexer::get_dropped_tasks() const noexcept
+{
+    return m_dropped_tasks;
+}
+
+/**
+ * @brief
+ * Gets the number of tokens produced by the last run. Duplicate files
+ * are only counted once, since they are only lexed once
+ * @return std::size_t Number of tokens
+ */
+std::size_t Lexer::get_token_count() const noexcept
+{
+    return m_token_count.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief
+ * Gets the name of the output of a source file, without its directory.
+ * It is also the name of the output in a bundle
+ * @param filename Source filename
+ * @return std::string Output name, as in a.html
+ */
+std::string Lexer::get_output_name(const std::string &filename) const
+{
+    std::filesystem::path path(filename);
+
+    // Other languages keep their extension, so a.cs and a.ts do not clash
+    return (source_language(filename) == Language::CSharp
+                ? path.stem().string()
+                : path.filename().string()) +
+           ".html";
+}
+
+// Mutator methods
+/**
+ * @brief
+ * Sets the number of workers of the parallel lexer. The shared pool is
+ * rebuilt on its next use, so this must not be called during a run
+ * @param count Number of workers, 0 to use the available CPUs
+ */
+void Lexer::set_worker_count(std::size_t count)
+{
+    std::lock_guard<std::mutex> lock(m_pool_mutex);
+    m_worker_count = count;
+    m_pool.reset();
+}
+
+/**
+ * @brief
+ * Enables or disables pinning each worker to its own CPU. The shared pool
+ * is rebuilt on its next use, so this must not be called during a run
+ * @param enabled Whether workers are pinned
+ */
+void Lexer::set_pin_workers(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_pool_mutex);
+    m_pin_workers = enabled;
+    m_pool.reset();
+}
+
+/**
+ * @brief
+ * Sets the length above which a token is stored as several pieces
+ * @param length Maximum token length in bytes, at least 1
+ */
+void Lexer::set_max_token_length(std::size_t length) noexcept
+{
+    m_max_token_length = std::max<std::size_t>(length, 1);
+}
+
+/**
+ * @brief
+ * Sets the number of lines of the pages an output is split into
+ * @param lines Lines per page, 0 to write every output as one document
+ */
+void Lexer::set_page_lines(std::size_t lines) noexcept
+{
+    m_page_lines = lines;
+}
+
+/**
+ * @brief
+ * Sets the memory the files in flight of a parallel run may hold
+ * @param bytes Budget in bytes, 0 for half of the available memory
+ */
+void Lexer::set_memory_budget(std::size_t bytes)
+{
+    m_memory_budget.set_capacity(bytes != 0 ? bytes
+                                            : MemoryBudget::default_capacity());
+}
+
+/**
+ * @brief
+ * Sets the bundle the outputs of the parallel runs are written to
+ * @param filename Bundle file, empty to write one file per input
+ */
+void Lexer::set_bundle(const std::string &filename)
+{
+    m_bundle_filename = filename;
+}
+
+/**
+ * @brief
+ * Sets the symbols defined for the conditional directives. Every other
+ * symbol is then undefined, so the regions it guards are inactive
+ * @param symbols Defined symbols
+ */
+void Lexer::set_defines(const std::vector<std::string> &symbols)
+{
+    m_preprocessor = Preprocessor(symbols);
+}
+
+/**
+ * @brief
+ * Sets the identifier index the parallel runs write
+ * @param filename Index file, empty to write none
+ */
+void Lexer::set_index(const std::string &filename)
+{
+    m_index_filename = filename;
+}
+
+/**
+ * @brief
+ * Sets the amount of source grouped in a single task of a parallel run
+ * @param size Group size in bytes, smaller files are grouped. 0 gives
+ *        every file its own task
+ */
+void Lexer::set_group_size(std::size_t size) noexcept
+{
+    m_group_size = size;
+}
+
+/**
+ * @brief
+ * Sets the chunk size used to lex large files in parallel
+ * @param size Chunk size in bytes, files of at least twice this size are
+ *        split. 0 disables splitting
+ */
+void Lexer::set_split_size(std::size_t size) noexcept
+{
+    m_split_size = size;
+}
+
+/**
+ * @brief
+ * Enables or disables the recording of a timeline of the following runs,
+ * including every task of the shared pool and its time in the queue
+ * @param enabled Whether the runs are traced
+ */
+void Lexer::set_trace(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_pool_mutex);
+    m_trace.set_enabled(enabled);
+
+    if (m_pool)
+        m_pool->set_trace(enabled ? &m_trace : nullptr);
+}
+
+/**
+ * @brief
+ * Enables or disables the performance counters of the following runs
+ * @param enabled Whether the stages are counted
+ * @return true If the counters are in the requested state, false if the
+ *         system does not let the process open perf events
+ */
+bool Lexer::set_perf_counters(bool enabled)
+{
+    return m_perf_counters.set_enabled(enabled);
+}
+
+/**
+ * @brief
+ * Enables or disables the token statistics of the following runs
+ * @param enabled Whether statistics are collected
+ */
+void Lexer::set_collect_stats(bool enabled) noexcept
+{
+    m_collect_stats = enabled;
+}
+
+// Methods (Public)
+/**
+ * @brief
+ * Starts the lexing of the files on the calling thread
+ * @param filenames Vector of filenames
+ * @param deadline Time after which the remaining files are skipped
+ */
+void Lexer::start_single(const std::vector<std::string> &filenames,
+                         std::optional<Batch::Clock::time_point> deadline)
+{
+    // The batch only carries the cancellation and the deadline, the files
+    // are still lexed one after the other on this thread
+    const auto batch = begin_batch(deadline);
+    Trace::Span run_span(m_trace, "start_single", "run");
+
+    try
+    {
+        m_stats.reset(m_collect_stats ? filenames.size() : 0);
+        m_dropped_tasks = 0;
+
+        for (std::size_t index{}; index < filenames.size(); ++index)
+        {
+            const auto &filename = filenames[index];
+
+            if (batch.should_stop())
+            {
+                m_dropped_tasks = filenames.size() - index;
+                break;
+            }
+
+            Trace::Span span(m_trace, "lex", "cpu", filename);
+
+            if (!m_collect_stats)
+            {
+                save_single(filename, lex_file(filename));
+                continue;
+            }
+
+            TokenStats stats;
+            save_single(filename, tokenize(read_file(filename),
+                                           source_language(filename), &stats));
+            m_stats.set_file(index, filename, std::move(stats));
+        }
+
+        if (m_collect_stats)
+            m_stats.merge();
+    }
+    catch (std::exception &e)
+    {
+        end_batch();
+        throw std::runtime_error(e.what());
+    }
+
+    end_batch();
+}
 
-// Regex
 /**
  * @brief
- * Regex for tokenizing the Csharp source code. Matches the following:
- * Words, numbers, strings, comments, operators, separators, etc.
- * @details uses the ECMAScript regex syntax for the regex
- * @details The regex is optimized for performance
+ * Starts the parallel lexer functionality on the shared thread pool. When
+ * a bundle is set, it replaces its previous contents once the run ends
+ * @param filenames Vector of filenames
+ * @param deadline Time after which the queued files are dropped
  */
-std::regex Lexer::m_regex_tokenizer(
-    R"(\".*\"|\b_?[0-9]+(?:\.[0-9]+)?\b|\w+|\s+|\/\/[^\n]*|\/\*[\s\S]*?\*\/|[{}()\[\];,.:?><+\-*/%&=!@#$~,_`\\|\"])",
-    std::regex::optimize | std::regex_constants::ECMAScript);
+void Lexer::start_multi(const std::vector<std::string> &filenames,
+                        std::optional<Batch::Clock::time_point> deadline)
+{
+    const auto batch = begin_batch(deadline);
+    Trace::Span run_span(m_trace, "start_multi", "run");
+
+    try
+    {
+        if (!m_bundle_filename.empty())
+            m_bundle = std::make_unique<BundleWriter>(m_bundle_filename);
+
+        if (!m_index_filename.empty())
+        {
+            m_identifiers = std::make_unique<InternTable>();
+            m_index = std::make_unique<IndexBuilder>();
+        }
+
+        lex_parallel(filenames, batch);
+
+        if (m_bundle)
+        {
+            PerfCounters::Scope scope(m_perf_counters, PerfCounters::Stage::Write);
+            Trace::Span span(m_trace, "finish bundle", "io", m_bundle_filename);
+            m_bundle->finish();
+        }
+
+        if (m_index)
+        {
+            PerfCounters::Scope scope(m_perf_counters, PerfCounters::Stage::Write);
+            Trace::Span span(m_trace, "write index", "io", m_index_filename);
+            m_index->write(m_index_filename, filenames, *m_identifiers);
+        }
+    }
+    catch (...)
+    {
+        m_bundle.reset();
+        m_index.reset();
+        m_identifiers.reset();
+        end_batch();
+        throw;
+    }
+
+    m_bundle.reset();
+    m_index.reset();
+    m_identifiers.reset();
+    m_dropped_tasks = batch.get_dropped();
+    end_batch();
+}
 
-// Access Methods
 /**
  * @brief
- * Gets the tokens generated by the lexer
- * @return std::vector<Token> Vector of tokens
+ * Cancels the run in progress, if any. The files that have not started
+ * yet are dropped. Can be called from any thread
  */
-const std::vector<Token> Lexer::get_tokens() const noexcept
+void Lexer::cancel() noexcept
 {
-    return m_tokens;
+    std::lock_guard<std::mutex> lock(m_batch_mutex);
+
+    if (m_batch)
+        m_batch->cancel();
+}
+
+/**
+ * @brief
+ * Highlights an in-memory source buffer
+ * @param source Source code to highlight
+ * @param format Output format of the result
+ * @param language Language of the source
+ * @return std::string Rendered output
+ */
+std::string Lexer::highlight(const std::string_view &source,
+                             OutputFormat format, Language language)
+{
+    return render(tokenize(source, language), format);
+}
+
+/**
+ * @brief
+ * Highlights a file without saving the result
+ * @param filename Filename to highlight
+ * @param format Output format of the result
+ * @return std::string Rendered output
+ * @throw std::runtime_error If the file cannot be opened
+ */
+std::string Lexer::highlight_file(const std::string &filename,
+                                  OutputFormat format)
+{
+    return render(lex_file(filename), format);
+}
+
+/**
+ * @brief
+ * Lexes a single file again and overwrites its parallel output, removing
+ * the pages a paginated run left for it
+ * @param filename Filename to lex
+ * @throw std::runtime_error If the file cannot be opened
+ */
+void Lexer::refresh(const std::string &filename)
+{
+    remove_pages(get_output_filename_multiple(filename));
+    lex_and_save(filename);
+}
+
+/**
+ * @brief
+ * Removes the parallel output of a source file and its pages, if they
+ * exist
+ * @param filename Source filename
+ */
+void Lexer::remove_output(const std::string &filename) const
+{
+    const auto output_filename = get_output_filename_multiple(filename);
+    std::error_code error;
+
+    std::filesystem::remove(output_filename, error);
+    remove_pages(output_filename);
+}
+
+/**
+ * @brief
+ * Removes the pages of an output, stopping at the first missing one
+ * @param output_filename Html file of the output
+ */
+void Lexer::remove_pages(const std::string &output_filename) const
+{
+    const std::filesystem::path path(output_filename);
+    const auto name = path.filename().string();
+    std::error_code error;
+    std::size_t page{1};
+
+    while (std::filesystem::remove(
+        path.parent_path() / utils::page_output_name(name, page), error))
+        ++page;
+}
+
+/**
+ * @brief
+ * Checks whether the parallel output of a file is missing or older than
+ * the file itself
+ * @param filename Source filename
+ * @return true If the file needs to be lexed again
+ */
+bool Lexer::is_stale(const std::string &filename) const
+{
+    std::error_code error;
+    const auto output_time = std::filesystem::last_write_time(
+        get_output_filename_multiple(filename), error);
+
+    if (error)
+        return true;
+
+    const auto source_time = std::filesystem::last_write_time(filename, error);
+
+    return error || source_time > output_time;
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Creates the batch of a new run on the shared pool and makes it the
+ * target of cancel()
+ * @param deadline Optional deadline of the run
+ * @return Batch Batch of the run
+ */
+Batch Lexer::begin_batch(std::optional<Batch::Clock::time_point> deadline)
+{
+    Batch batch(get_pool());
+    m_token_count.store(0, std::memory_order_relaxed);
+    m_perf_counters.reset();
+
+    if (deadline)
+        batch.set_deadline(*deadline);
+
+    std::lock_guard<std::mutex> lock(m_batch_mutex);
+    m_batch = batch;
+
+    return batch;
+}
+
+/**
+ * @brief
+ * Forgets the batch of the finished run
+ */
+void Lexer::end_batch() noexcept
+{
+    std::lock_guard<std::mutex> lock(m_batch_mutex);
+    m_batch.reset();
 }
 
-// Methods (Public)
 /**
  * @brief
- * Starts the lexing of the files
+ * Starts the parallel lexing of the files.
+ * @details Files are dispatched largest first, so a large file never
+ * starts last and keeps the other workers waiting. Small files are
+ * grouped into tasks of about the group size. Files much larger than
+ * the split size are lexed as several chunks. Files with byte-identical
+ * contents are only lexed and rendered once, the output of every
+ * duplicate is linked to the output of the first copy.
  * @param filenames Vector of filenames
+ * @param batch Batch the tasks of the run are added to
  */
-void Lexer::start_single(const std::vector<std::string> &filenames)
+void Lexer::lex_parallel(const std::vector<std::string> &filenames,
+                         Batch batch)
 {
+    m_stats.reset(m_collect_stats ? filenames.size() : 0);
+
+    // Sizes are only a scheduling hint, unreadable files count as empty
+    std::vector<std::uintmax_t> sizes(filenames.size());
+
+    for (std::size_t i{}; i < filenames.size(); ++i)
+    {
+        std::error_code error;
+        const auto size = std::filesystem::file_size(filenames[i], error);
+        sizes[i] = error ? 0 : size;
+    }
+
+    std::vector<std::size_t> order(filenames.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t lhs, std::size_t rhs)
+                     { return sizes[lhs] > sizes[rhs]; });
+
     try
     {
-        for (const auto &filename : filenames)
+        // Reading happens inside the task so that, with pinned workers,
+        // every buffer of a file lives on the NUMA node that lexes it
+        ParallelRun run(filenames, std::move(batch));
+
+        run.owners.reserve(filenames.size());
+        m_memory_budget.reset_peak();
+
+        // Files smaller than the group size share tasks, so that the cost
+        // of a task is paid per group instead of per file
+        std::vector<std::size_t> group;
+        std::size_t group_bytes{};
+
+        auto submit_group = [&]()
+        {
+            if (group.empty())
+                return;
+
+            auto lease = m_memory_budget.acquire(
+                group.size() * memory_per_file +
+                group_bytes * memory_per_source_byte);
+
+            run.batch.submit([this, &run, &sizes, files = std::move(group),
+                              lease = std::move(lease)]() mutable
+                             {
+                for (const auto index : files)
+                {
+                    if (run.batch.should_stop())
+                        break;
+
+                    // Each file takes its share of the lease along to the
+                    // tasks that render its output, which may outlive
+                    // this one
+                    auto share = lease.split(memory_per_file +
+                                             sizes[index] * memory_per_source_byte);
+
+                    try
+                    {
+                        lex_indexed(run, index, std::move(share));
+                    }
+                    catch (const std::exception &)
+                    {
+                        // Unreadable files are skipped, like single tasks
+                    }
+                } });
+
+            group = {};
+            group_bytes = 0;
+        };
+
+        for (const auto index : order)
         {
-            auto tokens = lex_file(filename);
-            save_single(filename, tokens);
+            if (sizes[index] < m_group_size)
+            {
+                group.push_back(index);
+                group_bytes += sizes[index];
+
+                if (group_bytes >= m_group_size)
+                    submit_group();
+
+                continue;
+            }
+
+            // Blocks while the files in flight use up the memory budget.
+            // The lease follows the file until its output is written
+            auto lease = m_memory_budget.acquire(
+                memory_per_file + sizes[index] * memory_per_source_byte);
+
+            run.batch.submit([this, &run, index, lease = std::move(lease)]() mutable
+                             { lex_indexed(run, index, std::move(lease)); });
         }
+
+        submit_group();
+        run.batch.wait();
+        link_duplicates(run);
     }
     catch (std::exception &e)
     {
         throw std::runtime_error(e.what());
     }
+
+    if (m_collect_stats)
+        m_stats.merge();
 }
 
 /**
  * @brief
- * Starts the parallel lexer functionality
- * @param filenames Vector of filenames
+ * Reads one file of a parallel run and lexes it, unless a file with the
+ * same contents was already seen, in which case it is linked later.
+ * Paginated runs lex every file
+ * @param run Parallel run the file belongs to
+ * @param index Index of the file in the run
+ * @param lease Memory budget held until the output is written
+ * @throw std::runtime_error If the file cannot be read
  */
-void Lexer::start_multi(const std::vector<std::string> &filenames)
+void Lexer::lex_indexed(ParallelRun &run, std::size_t index,
+                        MemoryBudget::Lease lease)
 {
-    lex_parallel(filenames);
+    auto buffer = read_file(run.filenames[index]);
+    const auto language = source_language(run.filenames[index]);
+
+    // The index page of a paginated output links the pages by the name of
+    // its own file, so a copy cannot share the output of the file it copies
+    if (m_page_lines != 0)
+    {
+        lex_buffer_and_save(run, index, std::move(buffer), std::move(lease));
+        return;
+    }
+
+    // Equal contents in different languages are lexed apart
+    const ContentKey key{utils::hash_bytes(buffer) ^ static_cast<std::uint64_t>(language),
+                         buffer.size()};
+
+    {
+        std::lock_guard<std::mutex> lock(run.dedup_mutex);
+        const auto [owner, inserted] = run.owners.try_emplace(key, index);
+
+        if (!inserted)
+        {
+            run.duplicates.emplace_back(index, owner->second);
+            return;
+        }
+    }
+
+    lex_buffer_and_save(run, index, std::move(buffer), std::move(lease));
 }
 
-// Methods (Private)
 /**
  * @brief
- * Starts the parallel lexing of the files
- * @param filenames Vector of filenames
+ * Writes the output of files whose contents match an already rendered
+ * file. The output is hard linked to the rendered copy, or copied when
+ * the filesystem does not support links. In a bundle, both names share
+ * one document. Hash collisions are detected by
+ * comparing the contents and fall back to lexing the file.
+ * @param run Finished parallel run
  */
-void Lexer::lex_parallel(const std::vector<std::string> &filenames)
+void Lexer::link_duplicates(ParallelRun &run)
 {
-    ThreadPool pool(std::thread::hardware_concurrency());
+    const auto &filenames = run.filenames;
+    auto &duplicates = run.duplicates;
 
-    try
+    // Group by owner so that every owner is read once
+    std::sort(duplicates.begin(), duplicates.end(),
+              [](const auto &lhs, const auto &rhs)
+              { return lhs.second < rhs.second; });
+
+    std::size_t owner_index = filenames.size();
+    std::string owner_buffer;
+
+    for (const auto &[index, owner] : duplicates)
     {
-        for (const auto &filename : filenames)
+        if (run.batch.should_stop())
+            break;
+
+        try
+        {
+            if (owner != owner_index)
+            {
+                owner_buffer = read_file(filenames[owner]);
+                owner_index = owner;
+            }
+
+            auto buffer = read_file(filenames[index]);
+
+            if (buffer == owner_buffer &&
+                link_output(get_output_filename_multiple(filenames[owner]),
+                            get_output_filename_multiple(filenames[index])))
+            {
+                if (m_index)
+                    m_index->link(index, owner);
+
+                if (m_collect_stats)
+                    m_stats.set_file(index, filenames[index],
+                                     m_stats.get_files()[owner].second);
+                continue;
+            }
+
+            // Lexed again, under the same budget as the parallel stage
+            auto lease = m_memory_budget.acquire(
+                memory_per_file + buffer.size() * memory_per_source_byte);
+
+            run.batch.submit(
+                [this, &run, index, buffer = std::move(buffer),
+                 lease = std::move(lease)]() mutable
+                { lex_buffer_and_save(run, index, std::move(buffer), std::move(lease)); });
+        }
+        catch (const std::exception &)
         {
-            pool.enqueue([&]()
-                         { lex_and_save(filename); });
+            // Unreadable files are skipped, like in the parallel stage
         }
     }
-    catch (std::exception &e)
+
+    run.batch.wait();
+}
+
+/**
+ * @brief
+ * Tokenizes a file that was already read and saves its parallel output,
+ * recording its statistics when they are enabled. Large files are handed
+ * to several workers as chunks.
+ * @param run Parallel run the file belongs to
+ * @param index Index of the file in the run
+ * @param buffer Contents of the file
+ * @param lease Memory budget held until the output is written
+ */
+void Lexer::lex_buffer_and_save(ParallelRun &run, std::size_t index,
+                                std::string buffer,
+                                MemoryBudget::Lease lease)
+{
+    const auto &filename = run.filenames[index];
+    const auto language = source_language(filename);
+    Trace::Span span(m_trace, "lex", "cpu", filename, buffer.size());
+
+    if (m_split_size != 0 && buffer.size() >= 2 * m_split_size)
     {
-        throw std::runtime_error(e.what());
+        std::vector<SourceRange> inactive;
+
+        auto bounds = visit_language(language, [&](auto description)
+                                     {
+                                         using Description = decltype(description);
+                                         inactive = find_inactive<Description>(buffer);
+                                         return find_split_points<Description>(
+                                             buffer, m_split_size, inactive); });
+
+        if (bounds.size() > 2)
+        {
+            auto job = std::make_shared<SplitJob>();
+            job->lease = std::move(lease);
+            job->index = index;
+            job->batch = &run.batch;
+            job->filename = filename;
+            job->language = language;
+            job->buffer = std::move(buffer);
+            job->inactive = std::move(inactive);
+            job->bounds = std::move(bounds);
+            job->parts.resize(job->bounds.size() - 1);
+            job->stats.resize(m_collect_stats ? job->parts.size() : 0);
+            job->remaining = job->parts.size();
+
+            run.batch.submit_bulk(1, job->parts.size(),
+                                  [this, job](std::size_t part)
+                                  { lex_part(*job, part); });
+
+            lex_part(*job, 0);
+            return;
+        }
+    }
+
+    const IndexedSource indexed{index, 0};
+    const auto *indexed_source = m_index ? &indexed : nullptr;
+
+    if (!m_collect_stats)
+    {
+        save_multiple(filename,
+                      tokenize(buffer, language, nullptr, nullptr, indexed_source),
+                      &run.batch, std::move(lease));
+        return;
+    }
+
+    TokenStats stats;
+    save_multiple(filename,
+                  tokenize(buffer, language, &stats, nullptr, indexed_source),
+                  &run.batch, std::move(lease));
+    m_stats.set_file(index, filename, std::move(stats));
+}
+
+/**
+ * @brief
+ * Lexes one chunk of a split file. The worker finishing the last chunk
+ * joins them and saves the output
+ * @param job Split file
+ * @param part Index of the chunk
+ */
+void Lexer::lex_part(SplitJob &job, std::size_t part)
+{
+    const std::string_view source{job.buffer};
+    const auto begin = job.bounds[part];
+    const auto end = job.bounds[part + 1];
+    Trace::Span span(m_trace, "lex part", "cpu", job.filename, end - begin);
+
+    // Chunks never cut an inactive region, so the regions of a chunk are
+    // whole
+    std::vector<SourceRange> inactive;
+    auto range = std::lower_bound(job.inactive.begin(), job.inactive.end(), begin,
+                                  [](const SourceRange &range, std::size_t offset)
+                                  { return range.begin < offset; });
+
+    for (; range != job.inactive.end() && range->end <= end; ++range)
+        inactive.push_back({range->begin - begin, range->end - begin});
+
+    const IndexedSource indexed{job.index, begin};
+    job.parts[part] = tokenize(source.substr(begin, end - begin), job.language,
+                               job.stats.empty() ? nullptr : &job.stats[part],
+                               &inactive, m_index ? &indexed : nullptr);
+
+    if (job.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        save_split(job);
+}
+
+/**
+ * @brief
+ * Joins the chunks of a split file, merging the whitespace runs cut at
+ * chunk boundaries, and saves the output. The statistics of the chunks,
+ * taken before long tokens were cut, are merged the same way
+ * @param job Split file whose chunks are all lexed
+ */
+void Lexer::save_split(SplitJob &job)
+{
+    std::vector<Token> tokens;
+    TokenStats stats;
+    std::size_t total{};
+
+    for (const auto &part : job.parts)
+        total += part.size();
+
+    for (const auto &part : job.stats)
+        stats.merge(part);
+
+    tokens.reserve(total);
+
+    for (auto &part : job.parts)
+    {
+        auto first = part.begin();
+
+        if (first != part.end() && !tokens.empty() &&
+            is_blank(tokens.back().get_value()) && is_blank(first->get_value()))
+        {
+            tokens.back().set_value(tokens.back().get_value() +
+                                    first->get_value());
+
+            if (m_collect_stats)
+                stats.join(first->get_type().value());
+
+            ++first;
+        }
+
+        tokens.insert(tokens.end(), std::make_move_iterator(first),
+                      std::make_move_iterator(part.end()));
+        part = {};
     }
+
+    if (m_collect_stats)
+        m_stats.set_file(job.index, job.filename, std::move(stats));
+
+    save_multiple(job.filename, std::move(tokens), job.batch,
+                  std::move(job.lease));
 }
 
 /**
@@ -104,38 +1251,55 @@ void Lexer::lex_parallel(const std::vector<std::string> &filenames)
  */
 void Lexer::lex_and_save(const std::string &filename)
 {
-    auto tokens = lex_file(filename);
-    save_multiple(filename, tokens);
+    save_multiple(filename, lex_file(filename));
 }
 
 /**
  * @brief
- * Lex a file and generate the tokens for said file
- * @param filename Filename to lex
- * @throw std::runtime_error If the file cannot be opened
+ * Reads the whole contents of a file and converts them to UTF-8
+ * @param filename Filename to read
+ * @return std::string Contents of the file, as UTF-8 without a BOM
+ * @throw std::runtime_error If the file cannot be opened or is empty
  */
-std::vector<Token> Lexer::lex_file(const std::string_view &filename)
+std::string Lexer::read_file(const std::string_view &filename) const
 {
-    try
+    PerfCounters::Scope scope(m_perf_counters, PerfCounters::Stage::Read);
+    Trace::Span span(m_trace, "read", "io", filename);
+    std::ifstream input_file(filename.data(),
+                             std::ios::in | std::ios::binary);
+
+    if (!input_file)
     {
-        std::ifstream input_file(filename.data(),
-                                 std::ios::in | std::ios::binary);
+        throw std::runtime_error("Cannot open file: " +
+                                 std::string(filename));
+    }
 
-        if (!input_file)
-        {
-            throw std::runtime_error("Cannot open file: " +
-                                     std::string(filename));
-        }
+    std::string buffer((std::istreambuf_iterator<char>(input_file)),
+                       std::istreambuf_iterator<char>());
 
-        std::string buffer((std::istreambuf_iterator<char>(input_file)),
-                           std::istreambuf_iterator<char>());
+    input_file.close();
+    span.set_bytes(buffer.size());
 
-        input_file.close();
+    // Lexing works on UTF-8, whatever the file was saved as
+    buffer = utils::to_utf8(std::move(buffer));
 
-        if (buffer.empty())
-            throw std::runtime_error("File is empty: " + std::string(filename));
+    if (buffer.empty())
+        throw std::runtime_error("File is empty: " + std::string(filename));
+
+    return buffer;
+}
 
-        return tokenize(buffer);
+/**
+ * @brief
+ * Lex a file and generate the tokens for said file
+ * @param filename Filename to lex
+ * @throw std::runtime_error If the file cannot be opened
+ */
+std::vector<Token> Lexer::lex_file(const std::string_view &filename)
+{
+    try
+    {
+        return tokenize(read_file(filename), source_language(filename));
     }
     catch (std::exception &e)
     {
@@ -145,38 +1309,161 @@ std::vector<Token> Lexer::lex_file(const std::string_view &filename)
 
 /**
  * @brief
- * Tokenizes the source code and generates the html code.
- * Uses regex to identify the m_separator tokens in order to highlight
- * them in the html code.
+ * Tokenizes source code with the scanner and the classification of its
+ * language
  * @param buffer Source code to tokenize
- * @return std::vector<Token> Vector of html code
- * @throw std::runtime_error If the file cannot be opened
+ * @param language Language of the source
+ * @param stats Statistics to update, if not null
+ * @param inactive Regions of the buffer left out by its directives,
+ *        searched in the buffer if null
+ * @param indexed Where the buffer is in the run, if its identifiers are
+ *        indexed
+ * @return std::vector<Token> Tokens of the source
+ * @throw std::runtime_error If the source cannot be tokenized
  */
-std::vector<Token> Lexer::tokenize(const std::string_view &buffer)
+std::vector<Token> Lexer::tokenize(const std::string_view &buffer,
+                                   Language language, TokenStats *stats,
+                                   const std::vector<SourceRange> *inactive,
+                                   const IndexedSource *indexed)
 {
-    try
+    return visit_language(language, [&](auto description)
+                          {
+                              using Description = decltype(description);
+
+                              if (inactive)
+                                  return tokenize_as<Description>(buffer, stats, *inactive,
+                                                                  indexed);
+
+                              return tokenize_as<Description>(
+                                  buffer, stats, find_inactive<Description>(buffer),
+                                  indexed); });
+}
+
+/**
+ * @brief
+ * Finds the regions of a source left out by its conditional directives,
+ * none for languages without directives. The directives of active code are
+ * found by the scanner, which passes over comments and strings
+ * @tparam Description Language of the source
+ * @param buffer Source code
+ * @return std::vector<SourceRange> Inactive regions, in order
+ */
+template <LanguageDescription Description>
+std::vector<SourceRange> Lexer::find_inactive(const std::string_view &buffer) const
+{
+    if constexpr (Description::directives)
     {
-        std::string buffer_str(buffer);
+        BasicScanner<Description> scanner(buffer);
 
-        auto token_begin = std::sregex_token_iterator(
-            buffer_str.begin(), buffer_str.end(),
-            m_regex_tokenizer);
+        return m_preprocessor.find_inactive(buffer, [&scanner](std::size_t begin)
+                                            { return scanner.find_directive(begin); });
+    }
+    else
+        return {};
+}
 
-        const auto token_end = std::sregex_token_iterator();
+/**
+ * @brief
+ * Tokenizes source code of one language. Instantiated once per language,
+ * so the scanning and classification loops are specialized for it
+ * @tparam Description Language of the source
+ * @param buffer Source code to tokenize
+ * @param stats Statistics to update, if not null
+ * @param inactive Regions of the buffer left out by its directives, each
+ *        kept as a single token
+ * @param indexed Where the buffer is in the run, if its identifiers are
+ *        added to the index
+ * @return std::vector<Token> Tokens of the source
+ * @throw std::runtime_error If the source cannot be tokenized
+ */
+template <LanguageDescription Description>
+std::vector<Token> Lexer::tokenize_as(const std::string_view &buffer,
+                                      TokenStats *stats,
+                                      std::span<const SourceRange> inactive,
+                                      const IndexedSource *indexed)
+{
+    try
+    {
+        Trace::Span span(m_trace, "tokenize", "cpu");
+        span.set_bytes(buffer.size());
 
+        BasicScanner<Description> scanner(buffer, inactive);
+        std::array<std::string_view, scan_block_tokens> block;
+        std::array<ScanKind, scan_block_tokens> kinds;
         std::vector<Token> tokens;
+        std::size_t count = block.size();
 
-        for (auto it{token_begin}; it != token_end; ++it)
+        // Tokens are scanned a block at a time, then identified, so the
+        // two stages can be counted apart
+        while (count == block.size())
         {
-            const std::string token = it->str();
+            count = 0;
+
+            {
+                PerfCounters::Scope scope(m_perf_counters,
+                                          PerfCounters::Stage::Scan);
+
+                while (count < block.size() &&
+                       scanner.next(block[count], kinds[count]))
+                    ++count;
+            }
+
+            PerfCounters::Scope scope(m_perf_counters,
+                                      PerfCounters::Stage::Identify);
 
-            if (!token.empty())
+            for (std::size_t i{}; i < count; ++i)
             {
-                TokenType token_type = identify_token(token);
-                tokens.emplace_back(Token{token, token_type});
+                const auto token = block[i];
+                TokenType token_type;
+
+                if (kinds[i] == ScanKind::Token)
+                    token_type = identify_token<Description>(token);
+                else if (kinds[i] == ScanKind::Directive)
+                    token_type = identify_directive<Description>(token);
+                else
+                    token_type = TokenType::InactiveCode;
+
+                if (token.size() <= m_max_token_length)
+                {
+                    auto &added = tokens.emplace_back(
+                        Token{std::string(token), token_type});
+
+                    // Only a run that builds an index interns identifiers
+                    if (indexed && token_type == TokenType::Other &&
+                        is_identifier(token))
+                    {
+                        added.set_id(m_identifiers->intern(token));
+                        m_index->add(added.get_id(), indexed->file,
+                                     indexed->offset +
+                                         static_cast<std::size_t>(token.data() - buffer.data()));
+                    }
+
+                    if (stats)
+                        stats->add(token, token_type);
+
+                    continue;
+                }
+
+                // Counted whole, the pieces are only for the output
+                if (stats)
+                    stats->add(token, token_type);
+
+                // Longer tokens are kept as pieces of the same type, so the
+                // text is highlighted the same but no single token grows
+                // unbounded
+                for (std::size_t offset{}; offset < token.size();
+                     offset += m_max_token_length)
+                    tokens.emplace_back(
+                        Token{std::string(token.substr(offset, m_max_token_length)),
+                              token_type});
             }
         }
 
+        if (stats)
+            stats->set_source_bytes(buffer.size());
+
+        m_perf_counters.add_source_bytes(buffer.size());
+        m_token_count.fetch_add(tokens.size(), std::memory_order_relaxed);
         return tokens;
     }
     catch (const std::exception &e)
@@ -187,96 +1474,86 @@ std::vector<Token> Lexer::tokenize(const std::string_view &buffer)
 
 /**
  * @brief
- * Creates the unordered map with the csharp constexpr arrays
- * @return std::unordered_map<std::string, std::string> Unordered map with the csharp constexpr arrays
+ * Creates the unordered map with the source words of a language. A word
+ * listed for several types keeps the first one
+ * @tparam Description Language of the words
+ * @return std::unordered_map<std::string_view, TokenType> Type of every word
  */
+template <LanguageDescription Description>
 std::unordered_map<std::string_view, TokenType> Lexer::create_token_map() const
 {
-    std::unordered_map<std::string_view, TokenType> token_map;
-
-    // Reserve space for the unordered map
-    std::size_t size = csharp::m_keywords.size() +
-                       csharp::m_operators.size() +
-                       csharp::m_separators.size() +
-                       csharp::m_comments.size() +
-                       csharp::m_literals.size() +
-                       csharp::m_preprocessor.size() +
-                       csharp::m_contextual_keywords.size() +
-                       csharp::m_access_specifiers.size() +
-                       csharp::m_attribute_targets.size() +
-                       csharp::m_attribute_usage.size() +
-                       csharp::m_escaped_identifiers.size() +
-                       csharp::m_interpolated_strings.size() +
-                       csharp::m_nullables.size() +
-                       csharp::m_verbatim_strings.size();
-
-    token_map.reserve(size);
-
-    /**
-     * @brief
-     * Inserts the elements of a container into the unordered map
-     * @param container Container to insert
-     * @param type TokenType of the container
-     * @return void
-     */
-    auto insert_range = [&](const auto &container, TokenType type)
-    {
-        for (const auto &item : container)
-            token_map.emplace_hint(token_map.end(),
-                                   item, type);
-    };
+    std::unordered_map<std::string_view, TokenType> token_map;
+    std::size_t size{};
+
+    for (const auto &list : Description::words)
+        size += list.words.size();
+
+    token_map.reserve(size);
 
-    insert_range(csharp::m_keywords, TokenType::Keyword);
-    insert_range(csharp::m_operators, TokenType::Operator);
-    insert_range(csharp::m_separators, TokenType::Separator);
-    insert_range(csharp::m_comments, TokenType::Comment);
-    insert_range(csharp::m_literals, TokenType::Literal);
-    insert_range(csharp::m_preprocessor,
-                 TokenType::Preprocessor);
-    insert_range(csharp::m_contextual_keywords,
-                 TokenType::ContextualKeyword);
-    insert_range(csharp::m_access_specifiers,
-                 TokenType::AccessSpecifier);
-    insert_range(csharp::m_attribute_targets,
-                 TokenType::AttributeTarget);
-    insert_range(csharp::m_attribute_usage,
-                 TokenType::AttributeUsage);
-    insert_range(csharp::m_escaped_identifiers,
-                 TokenType::EscapedIdentifier);
-    insert_range(csharp::m_interpolated_strings,
-                 TokenType::InterpolatedStringLiteral);
-    insert_range(csharp::m_nullables, TokenType::NullLiteral);
-    insert_range(csharp::m_verbatim_strings,
-                 TokenType::VerbatimStringLiteral);
+    for (const auto &list : Description::words)
+        for (const auto &word : list.words)
+            token_map.emplace(word, list.type);
 
     return token_map;
 }
 
 /**
  * @brief
- * Identify the token type based of the Token class
+ * Identify the token type of a raw token of a language: its words first,
+ * then comments, strings and numbers
+ * @tparam Description Language of the token
  * @param token Token to identify
  * @return TokenType Type of the token
  */
-TokenType Lexer::identify_token(const std::string_view &token)
+template <LanguageDescription Description>
+TokenType Lexer::identify_token(const std::string_view &token) const
 {
     static const std::unordered_map<std::string_view, TokenType>
-        token_map = create_token_map();
-    const auto it = token_map.find(token);
+        token_map = create_token_map<Description>();
+
+    // Words of case insensitive languages are listed in lowercase, and
+    // none is longer than a keyword
+    constexpr std::size_t max_folded_length = 32;
+    std::array<char, max_folded_length> folded;
+    std::string_view key = token;
+
+    if constexpr (Description::case_insensitive)
+    {
+        if (token.size() <= folded.size())
+        {
+            std::transform(token.begin(), token.end(), folded.begin(), [](char c)
+                           { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+            key = std::string_view(folded.data(), token.size());
+        }
+    }
+
+    const auto it = token_map.find(key);
 
     if (it != token_map.end())
         return it->second;
 
-    // If comment
-    if (token.find("//") != std::string::npos ||
-        token.find("/*") != std::string::npos ||
-        token.find("*/") != std::string::npos)
-        return TokenType::Comment;
+    if constexpr (Description::strings == StringRule::LastQuoteOfLine)
+    {
+        // A string up to the last quote of the line may swallow a comment,
+        // so the delimiters are looked for anywhere in the token
+        if (token.find(Description::line_comment) != std::string_view::npos ||
+            token.find(Description::block_comment_open) != std::string_view::npos ||
+            token.find(Description::block_comment_close) != std::string_view::npos)
+            return TokenType::Comment;
+
+        if (token.find_first_of(Description::quotes) != std::string_view::npos)
+            return TokenType::Literal;
+    }
+    else
+    {
+        if (token.starts_with(Description::line_comment) ||
+            (!Description::block_comment_open.empty() &&
+             token.starts_with(Description::block_comment_open)))
+            return TokenType::Comment;
 
-    // If literal
-    if (token.find("\"") != std::string::npos ||
-        token.find("\'") != std::string::npos)
-        return TokenType::Literal;
+        if (Description::quotes.find(token[0]) != std::string_view::npos)
+            return TokenType::Literal;
+    }
 
     // If number starting with underscore
     if (token.length() > 1 && token[0] == '_' && std::isdigit(token[1]))
@@ -289,6 +1566,54 @@ TokenType Lexer::identify_token(const std::string_view &token)
     return TokenType::Other;
 }
 
+/**
+ * @brief
+ * Identify the token type of a directive line of a language: the
+ * directives it lists are preprocessor tokens, as in "#if DEBUG" or
+ * "# region Setup"
+ * @tparam Description Language of the directive
+ * @param token Directive, from its '#' to the end of its line
+ * @return TokenType Preprocessor, or Other for an unknown directive
+ */
+template <LanguageDescription Description>
+TokenType Lexer::identify_directive(const std::string_view &token) const
+{
+    const auto begin = std::min(token.find_first_not_of(" \t", 1), token.size());
+    auto end = begin;
+
+    while (end < token.size() && BasicScanner<Description>::is_word(token[end]))
+        ++end;
+
+    const auto name = token.substr(begin, end - begin);
+
+    for (const auto &list : Description::words)
+    {
+        if (list.type != TokenType::Preprocessor)
+            continue;
+
+        for (const std::string_view word : list.words)
+            if (word.substr(1) == name)
+                return TokenType::Preprocessor;
+    }
+
+    return TokenType::Other;
+}
+
+/**
+ * @brief
+ * Checks whether an unclassified token is a name
+ * @param token Token to check
+ * @return true If the token starts with a letter or an underscore
+ */
+bool Lexer::is_identifier(const std::string_view &token) const noexcept
+{
+    const auto first = static_cast<unsigned char>(token.front());
+
+    return std::isalpha(first) ||
+           (first == '_' && (token.size() == 1 ||
+                             !std::isdigit(static_cast<unsigned char>(token[1]))));
+}
+
 /**
  * @brief
  * Utility function used to escape special characters in the html code.
@@ -297,35 +1622,126 @@ TokenType Lexer::identify_token(const std::string_view &token)
  */
 std::string Lexer::escape_html(const std::string &input) const
 {
-    std::string result;
-    result.reserve(input.size());
+    std::string result(escaped_size(input), '\0');
+    write_escaped(input, result.data());
+
+    return result;
+}
+
+/**
+ * @brief
+ * Computes the length of a string once escaped for html
+ * @param input String to escape
+ * @return std::size_t Length of the escaped string
+ */
+std::size_t Lexer::escaped_size(const std::string_view &input) const noexcept
+{
+    std::size_t size = input.size();
+
+    for (const char c : input)
+    {
+        switch (c)
+        {
+        case '&':
+            size += 4;
+            break;
+        case '\"':
+        case '\'':
+            size += 5;
+            break;
+        case '<':
+        case '>':
+            size += 3;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return size;
+}
+
+/**
+ * @brief
+ * Writes a string escaped for html
+ * @param input String to escape
+ * @param output Destination, with room for escaped_size(input) bytes
+ * @return char* End of the written bytes
+ */
+char *Lexer::write_escaped(const std::string_view &input, char *output) const
+{
+    auto append = [&output](const std::string_view &text)
+    {
+        output = std::copy(text.begin(), text.end(), output);
+    };
 
-    for (const auto &c : input)
+    for (const char c : input)
     {
         switch (c)
         {
         case '&':
-            result.append("&amp;");
+            append("&amp;");
             break;
         case '\"':
-            result.append("&quot;");
+            append("&quot;");
             break;
         case '\'':
-            result.append("&apos;");
+            append("&apos;");
             break;
         case '<':
-            result.append("&lt;");
+            append("&lt;");
             break;
         case '>':
-            result.append("&gt;");
+            append("&gt;");
             break;
         default:
-            result.append(&c, 1);
+            *output++ = c;
             break;
         }
     }
 
-    return result;
+    return output;
+}
+
+/**
+ * @brief
+ * Gets the opening tag of a token, from the table generated at compile
+ * time by the token registry. The classes are defined in styles.css
+ * @param type Type of the token
+ * @return std::string_view Opening span, empty for unclassified tokens
+ */
+std::string_view Lexer::html_tag(TokenType type) const
+{
+    return token_html_tags[static_cast<std::size_t>(type)];
+}
+
+/**
+ * @brief
+ * Computes the length of the html code of a token
+ * @param token Token to convert
+ * @return std::size_t Length of the html code
+ */
+std::size_t Lexer::html_size(const Token &token) const
+{
+    return html_tag(token.get_type().value()).size() +
+           escaped_size(token.get_value()) + html_span_end.size();
+}
+
+/**
+ * @brief
+ * Writes the html code of a token
+ * @param token Token to convert
+ * @param output Destination, with room for html_size(token) bytes
+ * @return char* End of the written bytes
+ */
+char *Lexer::write_html(const Token &token, char *output) const
+{
+    const auto tag = html_tag(token.get_type().value());
+
+    output = std::copy(tag.begin(), tag.end(), output);
+    output = write_escaped(token.get_value(), output);
+
+    return std::copy(html_span_end.begin(), html_span_end.end(), output);
 }
 
 /**
@@ -337,76 +1753,79 @@ std::string Lexer::escape_html(const std::string &input) const
  */
 std::string Lexer::token_to_html(const Token &token) const
 {
-    static const std::unordered_map<TokenType, std::string> html_tags = {
-        {TokenType::Keyword, "<span class=\"Keyword\">"},
-        {TokenType::Identifier, "<span class=\"Identifier\">"},
-        {TokenType::Literal, "<span class=\"Literal\">"},
-        {TokenType::Operator, "<span class=\"Operator\">"},
-        {TokenType::Separator, "<span class=\"Separator\">"},
-        {TokenType::Comment, "<span class=\"Comment\">"},
-        {TokenType::Preprocessor, "<span class=\"Preprocessor\">"},
-        {TokenType::ContextualKeyword, "<span class=\"ContextualKeyword\">"},
-        {TokenType::AccessSpecifier, "<span class=\"AccessSpecifier\">"},
-        {TokenType::AttributeTarget, "<span class=\"AttributeTarget\">"},
-        {TokenType::AttributeUsage, "<span class=\"AttributeUsage\">"},
-        {TokenType::EscapedIdentifier, "<span class=\"EscapedIdentifier\">"},
-        {TokenType::InterpolatedStringLiteral,
-         "<span class=\"InterpolatedStringLiteral\">"},
-        {TokenType::NullLiteral, "<span class=\"NullLiteral\">"},
-        {TokenType::VerbatimStringLiteral,
-         "<span class=\"VerbatimStringLiteral\">"},
-        {TokenType::RegularExpressionLiteral,
-         "<span class=\"RegularExpressionLiteral\">"},
-        {TokenType::NumericLiteral, "<span class=\"NumericLiteral\">"},
-        {TokenType::Other, "<span class=\"Other\">"}};
-
-    std::string html;
-    auto token_type = token.get_type();
-
-    if (token_type != TokenType::Other)
-        html += html_tags.at(token_type.value());
-
-    // Escape the token string
-    html += escape_html(token.get_value());
-    html += "</span>";
+    std::string html(html_size(token), '\0');
+    write_html(token, html.data());
 
     return html;
 }
 
 /**
  * @brief
- * Generates the HTML code from the tokens vector
+ * Generates the HTML code from the tokens vector. The exact size is
+ * computed first, so the document is written in a single allocation
  * @param tokens Tokens to convert
  * @return std::string Html code
  */
 std::string Lexer::generate_html(const std::vector<Token> &tokens) const
 {
-    std::string html;
+    PerfCounters::Scope scope(m_perf_counters, PerfCounters::Stage::Render);
+    Trace::Span span(m_trace, "render", "cpu");
+    std::size_t size = html_header.size() + html_footer.size();
 
-    // Reserve space for the html string
-    html.reserve(2048);
+    for (const auto &token : tokens)
+        size += html_size(token);
 
-    // Add the html header
-    html += "<!DOCTYPE html>\n"
-            "<html lang=\"en\">\n"
-            "<head>\n"
-            "<meta charset=\"UTF-8\">\n"
-            "<meta http-equiv=\"X-UA-Compatible\" content=\"IE=edge\">\n"
-            "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">\n"
-            "<title>Highlighter</title>\n"
-            "<link rel=\"stylesheet\" href=\"../src/styles/styles.css\">\n"
-            "</head>\n"
-            "<body style=\"background-color: var(--background-color);\">\n"
-            "<pre><code>\n";
+    std::string html(size, '\0');
+    char *output = std::copy(html_header.begin(), html_header.end(),
+                             html.data());
 
     for (const auto &token : tokens)
-        html += token_to_html(token);
+        output = write_html(token, output);
 
-    html += "</code></pre>\n</body>\n</html>\n";
+    std::copy(html_footer.begin(), html_footer.end(), output);
 
     return html;
 }
 
+/**
+ * @brief
+ * Generates a plain text listing of the tokens, one token per line
+ * @param tokens Tokens to convert
+ * @return std::string Token listing
+ */
+std::string Lexer::generate_text(const std::vector<Token> &tokens) const
+{
+    std::string text;
+
+    for (const auto &token : tokens)
+    {
+        text += token.to_string();
+        text += '\n';
+    }
+
+    return text;
+}
+
+/**
+ * @brief
+ * Renders the tokens in the requested output format
+ * @param tokens Tokens to render
+ * @param format Output format
+ * @return std::string Rendered output
+ */
+std::string Lexer::render(const std::vector<Token> &tokens,
+                          OutputFormat format) const
+{
+    switch (format)
+    {
+    case OutputFormat::Tokens:
+        return generate_text(tokens);
+    case OutputFormat::Html:
+    default:
+        return generate_html(tokens);
+    }
+}
+
 /**
  * @brief
  * Gets the output filename from the input filename
@@ -415,11 +1834,8 @@ std::string Lexer::generate_html(const std::vector<Token> &tokens) const
  */
 std::string Lexer::get_output_filename_single(const std::string &inputFilename) const
 {
-    std::filesystem::path path(inputFilename);
-    std::string filename = path.stem().string();
-
     std::filesystem::path outputPath =
-        "../outputSingle/" + filename + ".html";
+        "../outputSingle/" + get_output_name(inputFilename);
 
     return outputPath.string();
 }
@@ -433,11 +1849,8 @@ std::string Lexer::get_output_filename_single(const std::string &inputFilename)
 std::string Lexer::get_output_filename_multiple(
     const std::string &inputFilename) const
 {
-    std::filesystem::path path(inputFilename);
-    std::string filename = path.stem().string();
-
     std::filesystem::path outputPath =
-        "../outputParallel/" + filename + ".html";
+        "../outputParallel/" + get_output_name(inputFilename);
 
     return outputPath.string();
 }
@@ -446,54 +1859,419 @@ std::string Lexer::get_output_filename_multiple(
  * @brief
  * Saves the tokens in a HTML file
  * @param filename Filename to save the tokens
- * @throw std::runtime_error If the file cannot be opened
+ * @param tokens Tokens to save
+ * @throw std::runtime_error If the file cannot be written
  */
 void Lexer::save_single(const std::string &filename,
-                        const std::vector<Token> &tokens) const
+                        std::vector<Token> tokens) const
 {
-    try
+    save_output(get_output_filename_single(filename), std::move(tokens),
+                nullptr, {});
+}
+
+/**
+ * @brief
+ * Saves the tokens in a HTML file
+ * @param filename Filename to save the tokens
+ * @param tokens Tokens to save
+ * @param batch Batch that renders the ranges of large outputs in
+ *        parallel, nullptr to render on the calling thread
+ * @param lease Memory budget released once the output is written
+ * @throw std::runtime_error If the file cannot be written
+ */
+void Lexer::save_multiple(const std::string &filename,
+                          std::vector<Token> tokens, Batch *batch,
+                          MemoryBudget::Lease lease) const
+{
+    save_output(get_output_filename_multiple(filename), std::move(tokens),
+                batch, std::move(lease));
+}
+
+/**
+ * @brief
+ * Writes tokens as one html document, or as pages and an index page when
+ * they span more lines than a page holds
+ * @param output_filename Html file to write
+ * @param tokens Tokens to render
+ * @param batch Batch the pages or ranges are rendered in, nullptr to
+ *        render on the calling thread
+ * @param lease Memory budget released once the output is written
+ * @throw std::runtime_error If a file cannot be written
+ */
+void Lexer::save_output(const std::string &output_filename,
+                        std::vector<Token> tokens, Batch *batch,
+                        MemoryBudget::Lease lease) const
+{
+    if (m_page_lines != 0)
     {
-        std::string output_filename =
-            get_output_filename_single(filename);
-        std::ofstream output_file(output_filename,
-                                  std::ios::out | std::ios::trunc);
+        std::size_t line_count{};
+        auto pages = split_pages(std::move(tokens), line_count);
 
-        if (!output_file)
-            throw std::runtime_error("Cannot open file: " + output_filename);
+        if (pages.size() > 1)
+        {
+            write_pages(output_filename, std::move(pages), line_count, batch,
+                        std::move(lease));
+            return;
+        }
 
-        output_file << generate_html(tokens);
-        output_file.close();
+        tokens = std::move(pages.front());
     }
-    catch (std::exception &e)
+
+    write_output(output_filename, std::move(tokens), batch, std::move(lease));
+}
+
+/**
+ * @brief
+ * Splits tokens into pages of m_page_lines lines. A token that crosses
+ * the end of a page, such as a block comment or a verbatim string, is cut
+ * after the line break and both pieces keep its type, so the next page
+ * starts in the state the lexer was in at that line
+ * @param tokens Tokens to split
+ * @param line_count Set to the number of lines of the tokens
+ * @return std::vector<std::vector<Token>> Pages, at least one
+ */
+std::vector<std::vector<Token>> Lexer::split_pages(std::vector<Token> tokens,
+                                                   std::size_t &line_count) const
+{
+    PerfCounters::Scope scope(m_perf_counters, PerfCounters::Stage::Render);
+    Trace::Span span(m_trace, "paginate", "cpu");
+
+    std::vector<std::vector<Token>> pages(1);
+    std::size_t lines{};
+    std::size_t line_breaks{};
+    bool ends_line = true;
+
+    for (auto &token : tokens)
     {
-        throw std::runtime_error(e.what());
+        const std::string_view value = token.get_value();
+        const auto count = static_cast<std::size_t>(
+            std::count(value.begin(), value.end(), '\n'));
+
+        line_breaks += count;
+
+        if (!value.empty())
+            ends_line = value.back() == '\n';
+
+        if (lines + count < m_page_lines)
+        {
+            lines += count;
+            pages.back().push_back(std::move(token));
+            continue;
+        }
+
+        const auto type = token.get_type();
+        std::size_t begin{};
+
+        while (begin < value.size())
+        {
+            auto end = begin;
+
+            while (lines < m_page_lines && end < value.size())
+            {
+                const auto line_break = value.find('\n', end);
+
+                if (line_break == std::string_view::npos)
+                {
+                    end = value.size();
+                    break;
+                }
+
+                end = line_break + 1;
+                ++lines;
+            }
+
+            pages.back().emplace_back(std::string(value.substr(begin, end - begin)),
+                                      type);
+
+            if (lines == m_page_lines)
+            {
+                pages.emplace_back();
+                lines = 0;
+            }
+
+            begin = end;
+        }
     }
+
+    if (pages.size() > 1 && pages.back().empty())
+        pages.pop_back();
+
+    line_count = line_breaks + (ends_line ? 0 : 1);
+    return pages;
 }
 
 /**
  * @brief
- * Saves the tokens in a HTML file
- * @param filename Filename to save the tokens
- * @throw std::runtime_error If the file cannot be opened
+ * Writes the pages of an output, each as a document of its own named
+ * after the output, and an index page linking them under the name of the
+ * output. The pages are rendered in parallel when there is a batch
+ * @param output_filename Html file of the index page
+ * @param pages Tokens of every page
+ * @param line_count Number of lines of the whole output
+ * @param batch Batch the pages after the first are rendered in, nullptr
+ *        to render every page on the calling thread
+ * @param lease Memory budget released once every page is rendered
+ * @throw std::runtime_error If a file cannot be written
  */
-void Lexer::save_multiple(const std::string &filename,
-                          const std::vector<Token> &tokens) const
+void Lexer::write_pages(const std::string &output_filename,
+                        std::vector<std::vector<Token>> pages,
+                        std::size_t line_count, Batch *batch,
+                        MemoryBudget::Lease lease) const
 {
-    try
+    const std::filesystem::path path(output_filename);
+    const auto page_count = pages.size();
+
+    auto output = std::make_shared<PagedOutput>();
+    output->lease = std::move(lease);
+    output->directory = path.parent_path();
+    output->name = path.filename().string();
+    output->pages = std::move(pages);
+
+    std::string index(html_header);
+
+    for (std::size_t page{}; page < page_count; ++page)
+    {
+        const auto first = page * m_page_lines + 1;
+        const auto last = std::min(line_count, (page + 1) * m_page_lines);
+
+        index += "<a href=\"" +
+                 escape_html(utils::page_output_name(output->name, page + 1)) +
+                 "\">Lines " + std::to_string(first) + "-" +
+                 std::to_string(last) + "</a>\n";
+    }
+
+    index += html_footer;
+
+    auto write_page = [this, output](std::size_t page)
+    {
+        write_output((output->directory /
+                      utils::page_output_name(output->name, page + 1))
+                         .string(),
+                     std::move(output->pages[page]), nullptr, {});
+    };
+
+    if (batch)
+        batch->submit_bulk(1, page_count, write_page);
+    else
+    {
+        for (std::size_t page{1}; page < page_count; ++page)
+            write_page(page);
+    }
+
+    write_page(0);
+    write_document(output_filename, index);
+}
+
+/**
+ * @brief
+ * Writes a document that is already rendered, through a temporary file
+ * or into a region of the bundle of the run
+ * @param output_filename Html file to write
+ * @param document Contents of the file
+ * @throw std::runtime_error If the file cannot be written
+ */
+void Lexer::write_document(const std::string &output_filename,
+                           std::string_view document) const
+{
+    PerfCounters::Scope scope(m_perf_counters, PerfCounters::Stage::Write);
+    Trace::Span span(m_trace, "write", "io", output_filename, document.size());
+
+    if (m_bundle)
     {
-        std::string output_filename =
-            get_output_filename_multiple(filename);
-        std::ofstream output_file(output_filename,
-                                  std::ios::out | std::ios::trunc);
+        auto region = m_bundle->reserve(document.size());
+        std::copy(document.begin(), document.end(), region.data());
+        region.commit(std::filesystem::path(output_filename).filename().string());
+        return;
+    }
+
+    const auto temporary_filename = output_filename + ".tmp";
+
+    {
+        std::ofstream file(temporary_filename, std::ios::binary | std::ios::trunc);
+
+        if (!file.write(document.data(),
+                        static_cast<std::streamsize>(document.size())))
+            throw std::runtime_error("Cannot write file: " + output_filename);
+    }
+
+    std::filesystem::rename(temporary_filename, output_filename);
+}
+
+/**
+ * @brief
+ * Renders tokens as html straight into a memory mapped file.
+ * @details The size of the html of every range of tokens is computed
+ * first, so the file is created with its final size and each range is
+ * rendered at its own offset, possibly by several workers at once. The
+ * output is written to a temporary file that replaces the target once
+ * the last range is done, so a hard linked duplicate keeps its own
+ * contents when this output is replaced. During a run with a bundle, the
+ * output is rendered into a region reserved in the bundle instead.
+ * @param output_filename Html file to write
+ * @param tokens Tokens to render
+ * @param batch Batch the ranges after the first are rendered in, nullptr
+ *        to render every range on the calling thread
+ * @param lease Memory budget released once every range is rendered
+ * @throw std::runtime_error If the file cannot be created or mapped
+ */
+void Lexer::write_output(const std::string &output_filename,
+                         std::vector<Token> tokens, Batch *batch,
+                         MemoryBudget::Lease lease) const
+{
+    auto output = std::make_shared<MappedOutput>();
+    output->lease = std::move(lease);
+    output->filename = output_filename;
+    output->temporary_filename = output_filename + ".tmp";
+    output->tokens = std::move(tokens);
+
+    // First pass: offset of every range in the file
+    std::optional<PerfCounters::Scope> scope;
+    std::optional<Trace::Span> span;
+    scope.emplace(m_perf_counters, PerfCounters::Stage::Render);
+    span.emplace(m_trace, "size", "cpu", output_filename);
+
+    const auto &all_tokens = output->tokens;
+    const auto ranges = std::max<std::size_t>(
+        (all_tokens.size() + render_range_tokens - 1) / render_range_tokens, 1);
+    std::size_t offset = html_header.size();
+
+    output->offsets.reserve(ranges + 1);
 
-        if (!output_file)
+    for (std::size_t range{}; range < ranges; ++range)
+    {
+        output->offsets.push_back(offset);
+
+        const auto end = std::min(all_tokens.size(),
+                                  (range + 1) * render_range_tokens);
+
+        for (auto i = range * render_range_tokens; i < end; ++i)
+            offset += html_size(all_tokens[i]);
+    }
+
+    output->offsets.push_back(offset);
+    output->size = offset + html_footer.size();
+
+    scope.reset();
+    span.reset();
+    scope.emplace(m_perf_counters, PerfCounters::Stage::Write);
+
+    if (m_bundle)
+    {
+        // Named like the file it replaces, without its directory
+        span.emplace(m_trace, "reserve", "io", output_filename, output->size);
+        output->temporary_filename.clear();
+        output->bundle_name =
+            std::filesystem::path(output_filename).filename().string();
+        output->region = m_bundle->reserve(output->size);
+        output->data = output->region.data();
+    }
+    else
+    {
+        span.emplace(m_trace, "create", "io", output_filename, output->size);
+        output->fd = ::open(output->temporary_filename.c_str(),
+                            O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+        if (output->fd < 0)
             throw std::runtime_error("Cannot open file: " + output_filename);
 
-        output_file << generate_html(tokens);
-        output_file.close();
+        if (::ftruncate(output->fd, static_cast<off_t>(output->size)) != 0)
+            throw std::runtime_error("Cannot resize file: " + output_filename +
+                                     ": " + std::strerror(errno));
+
+        void *data = ::mmap(nullptr, output->size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, output->fd, 0);
+
+        if (data == MAP_FAILED)
+            throw std::runtime_error("Cannot map file: " + output_filename +
+                                     ": " + std::strerror(errno));
+
+        output->data = static_cast<char *>(data);
     }
-    catch (std::exception &e)
+    std::copy(html_header.begin(), html_header.end(), output->data);
+    std::copy(html_footer.begin(), html_footer.end(),
+              output->data + output->offsets.back());
+
+    // Second pass: ranges are rendered into their own slices
+    scope.reset();
+    span.reset();
+    output->remaining = ranges;
+
+    if (batch)
     {
-        throw std::runtime_error(e.what());
+        batch->submit_bulk(1, ranges, [this, output](std::size_t range)
+                           { render_range(*output, range); });
+    }
+    else
+    {
+        for (std::size_t range{1}; range < ranges; ++range)
+            render_range(*output, range);
+    }
+
+    render_range(*output, 0);
+}
+
+/**
+ * @brief
+ * Renders one range of tokens into its slice of a mapped output. The
+ * last range to finish publishes the file
+ * @param output Mapped output
+ * @param range Index of the range
+ * @throw std::runtime_error If the finished file cannot be renamed
+ */
+void Lexer::render_range(MappedOutput &output, std::size_t range) const
+{
+    const auto begin = range * render_range_tokens;
+    const auto end = std::min(output.tokens.size(), begin + render_range_tokens);
+    char *position = output.data + output.offsets[range];
+
+    {
+        PerfCounters::Scope scope(m_perf_counters, PerfCounters::Stage::Render);
+        Trace::Span span(m_trace, "render", "cpu", output.filename,
+                         output.offsets[range + 1] - output.offsets[range]);
+
+        for (auto i = begin; i < end; ++i)
+            position = write_html(output.tokens[i], position);
+    }
+
+    if (output.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        PerfCounters::Scope scope(m_perf_counters, PerfCounters::Stage::Write);
+        Trace::Span span(m_trace, "publish", "io", output.filename);
+        output.publish();
+    }
+}
+
+/**
+ * @brief
+ * Gives a rendered output a second name: a hard link, or a copy when the
+ * filesystem does not support links, or a second index entry of the
+ * same document during a run with a bundle
+ * @param source Output filename of the rendered copy
+ * @param target Output filename of the duplicate
+ * @return true If the duplicate has an output
+ */
+bool Lexer::link_output(const std::string &source,
+                        const std::string &target) const
+{
+    if (m_bundle)
+        return m_bundle->link(std::filesystem::path(target).filename().string(),
+                              std::filesystem::path(source).filename().string());
+
+    std::error_code error;
+
+    if (!std::filesystem::exists(source, error))
+        return false;
+
+    std::filesystem::remove(target, error);
+    std::filesystem::create_hard_link(source, target, error);
+
+    if (error)
+    {
+        error.clear();
+        std::filesystem::copy_file(
+            source, target, std::filesystem::copy_options::overwrite_existing,
+            error);
     }
-}
\ No newline at end of file
+
+    return !error;
+}
@@ -14,16 +14,40 @@
 #define LEXER_H
 
 // Standard libraries
+#include <atomic>
 #include <thread>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string_view>
 #include <vector>
 #include <string>
-#include <regex>
 #include <unordered_map>
 
 // Project files
 #include "../token/token.h"
-#include "../utils/csharp_language.h"
+#include "../token/intern_table.h"
+#include "../stats/token_stats.h"
+#include "../stats/perf_counters.h"
+#include "../stats/trace.h"
+#include "../threads/thread_pool.h"
+#include "../threads/batch.h"
+#include "../threads/memory_budget.h"
+#include "../output/bundle.h"
+#include "../index/identifier_index.h"
+#include "language.h"
+#include "preprocessor.h"
+
+/**
+ * @brief
+ * Output formats the lexer can render tokens to
+ * @enum OutputFormat
+ */
+enum class OutputFormat
+{
+    Html,
+    Tokens
+};
 
 /**
  * @brief
@@ -44,35 +68,190 @@ public:
 
     // Acess Methods
     const std::vector<Token> get_tokens() const noexcept;
+    const CorpusStats &get_stats() const noexcept;
+    const PerfCounters &get_perf_counters() const noexcept;
+    const Trace &get_trace() const noexcept;
+
+    std::size_t get_worker_count() const;
+    ThreadPool &get_pool();
+    std::size_t get_dropped_tasks() const noexcept;
+    std::size_t get_token_count() const noexcept;
+    const MemoryBudget &get_memory_budget() const noexcept;
+    std::string get_output_name(const std::string &) const;
+
+    // Mutator methods
+    void set_collect_stats(bool) noexcept;
+    bool set_perf_counters(bool);
+    void set_trace(bool);
+    void set_worker_count(std::size_t);
+    void set_pin_workers(bool);
+    void set_split_size(std::size_t) noexcept;
+    void set_group_size(std::size_t) noexcept;
+    void set_max_token_length(std::size_t) noexcept;
+    void set_page_lines(std::size_t) noexcept;
+    void set_memory_budget(std::size_t);
+    void set_bundle(const std::string &);
+    void set_defines(const std::vector<std::string> &);
+    void set_index(const std::string &);
 
     // Methods
-    void start_single(const std::vector<std::string> &);
-    void start_multi(const std::vector<std::string> &);
+    void start_single(const std::vector<std::string> &,
+                      std::optional<Batch::Clock::time_point> = std::nullopt);
+    void start_multi(const std::vector<std::string> &,
+                     std::optional<Batch::Clock::time_point> = std::nullopt);
+    void cancel() noexcept;
+    std::string highlight(const std::string_view &,
+                          OutputFormat = OutputFormat::Html,
+                          Language = Language::CSharp);
+    std::string highlight_file(const std::string &,
+                               OutputFormat = OutputFormat::Html);
+    void refresh(const std::string &);
+    void remove_output(const std::string &) const;
+    bool is_stale(const std::string &) const;
 
 private:
     std::vector<Token> m_tokens;
-    static std::regex m_regex_tokenizer;
+
+    // Shared by every worker of a run that builds an index, renewed with
+    // the index so a daemon or a watcher does not keep every name it saw
+    std::unique_ptr<InternTable> m_identifiers;
+
+    // Worker configuration, 0 workers picks the available CPUs
+    std::size_t m_worker_count{0};
+    bool m_pin_workers{false};
+
+    // Files larger than twice this size are lexed in chunks, 0 disables it
+    std::size_t m_split_size{1024 * 1024};
+
+    // Files smaller than this share tasks of about this much source
+    std::size_t m_group_size{256 * 1024};
+
+    // Tokens longer than this are stored as several pieces of the same type
+    std::size_t m_max_token_length{64 * 1024};
+
+    // Outputs of more lines than this are split into pages and an index
+    // page, 0 disables it
+    std::size_t m_page_lines{0};
+
+    // Token statistics of the last run
+    bool m_collect_stats{false};
+    CorpusStats m_stats;
+
+    // Hardware counters of the stages of the last run, when enabled
+    PerfCounters m_perf_counters;
+
+    // Timeline of the runs, when enabled. Used by the pool, so it is
+    // declared before it
+    Trace m_trace;
+
+    // Bounds the memory of the files in flight of a parallel run
+    MemoryBudget m_memory_budget{MemoryBudget::default_capacity()};
+
+    // Parallel outputs go to this bundle instead of one file each, when
+    // set. The writer only lives during a parallel run
+    std::string m_bundle_filename;
+    std::unique_ptr<BundleWriter> m_bundle;
+
+    // Parallel runs also write an index of their identifiers, when set.
+    // The builder only lives during a parallel run
+    std::string m_index_filename;
+    std::unique_ptr<IndexBuilder> m_index;
+
+    // Symbols of the conditional directives, unknown unless configured
+    Preprocessor m_preprocessor;
+
+    // Run in progress, the target of cancel()
+    std::optional<Batch> m_batch;
+    std::mutex m_batch_mutex;
+    std::size_t m_dropped_tasks{0};
+
+    // Tokens produced since the start of the last run
+    std::atomic<std::size_t> m_token_count{0};
+
+    // Shared by every run. Declared last so that the workers are joined
+    // before the state they use is destroyed
+    std::mutex m_pool_mutex;
+    std::unique_ptr<ThreadPool> m_pool;
+
+    // State of a parallel run, of a file lexed in chunks, of an output
+    // rendered in place and of an output split into pages
+    struct ParallelRun;
+    struct SplitJob;
+    struct MappedOutput;
+    struct PagedOutput;
 
     // Lexer methods
+    std::string read_file(const std::string_view &) const;
     std::vector<Token> lex_file(const std::string_view &);
-    void lex_parallel(const std::vector<std::string> &);
+    Batch begin_batch(std::optional<Batch::Clock::time_point>);
+    void end_batch() noexcept;
+    void lex_parallel(const std::vector<std::string> &, Batch);
     void lex_and_save(const std::string &);
+    void lex_indexed(ParallelRun &, std::size_t, MemoryBudget::Lease = {});
+    void link_duplicates(ParallelRun &);
+    void lex_buffer_and_save(ParallelRun &, std::size_t, std::string,
+                             MemoryBudget::Lease = {});
+    void lex_part(SplitJob &, std::size_t);
+    void save_split(SplitJob &);
+
+    /**
+     * @brief
+     * Where a buffer whose identifiers are indexed is in the run
+     * @struct IndexedSource
+     */
+    struct IndexedSource
+    {
+        std::size_t file;
+        std::size_t offset;
+    };
 
     // Token methods
-    std::vector<Token> tokenize(const std::string_view &);
+    std::vector<Token> tokenize(const std::string_view &, Language,
+                                TokenStats * = nullptr,
+                                const std::vector<SourceRange> * = nullptr,
+                                const IndexedSource * = nullptr);
+    template <LanguageDescription Description>
+    std::vector<SourceRange> find_inactive(const std::string_view &) const;
+    template <LanguageDescription Description>
+    std::vector<Token> tokenize_as(const std::string_view &, TokenStats *,
+                                   std::span<const SourceRange>,
+                                   const IndexedSource *);
+    template <LanguageDescription Description>
     std::unordered_map<std::string_view, TokenType> create_token_map() const;
-    TokenType identify_token(const std::string_view &);
+    template <LanguageDescription Description>
+    TokenType identify_token(const std::string_view &) const;
+    template <LanguageDescription Description>
+    TokenType identify_directive(const std::string_view &) const;
+    bool is_identifier(const std::string_view &) const noexcept;
 
     // HTML methods
     std::string escape_html(const std::string &) const;
+    std::size_t escaped_size(const std::string_view &) const noexcept;
+    char *write_escaped(const std::string_view &, char *) const;
+    std::string_view html_tag(TokenType) const;
+    std::size_t html_size(const Token &) const;
+    char *write_html(const Token &, char *) const;
     std::string token_to_html(const Token &) const;
     std::string generate_html(const std::vector<Token> &) const;
+    std::string generate_text(const std::vector<Token> &) const;
+    std::string render(const std::vector<Token> &, OutputFormat) const;
 
     // File methods
-    void save_single(const std::string &filename,
-                     const std::vector<Token> &) const;
-    void save_multiple(const std::string &filename,
-                       const std::vector<Token> &) const;
+    void save_single(const std::string &filename, std::vector<Token>) const;
+    void save_multiple(const std::string &filename, std::vector<Token>,
+                       Batch * = nullptr, MemoryBudget::Lease = {}) const;
+    void save_output(const std::string &, std::vector<Token>, Batch *,
+                     MemoryBudget::Lease) const;
+    std::vector<std::vector<Token>> split_pages(std::vector<Token>,
+                                                std::size_t &) const;
+    void write_pages(const std::string &, std::vector<std::vector<Token>>,
+                     std::size_t, Batch *, MemoryBudget::Lease) const;
+    void write_document(const std::string &, std::string_view) const;
+    void remove_pages(const std::string &) const;
+    void write_output(const std::string &, std::vector<Token>, Batch *,
+                      MemoryBudget::Lease) const;
+    void render_range(MappedOutput &, std::size_t) const;
+    bool link_output(const std::string &, const std::string &) const;
     std::string get_output_filename_single(const std::string &) const;
     std::string get_output_filename_multiple(const std::string &) const;
 };
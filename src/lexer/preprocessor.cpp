@@ -0,0 +1,512 @@
+/**
+ * @file preprocessor.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the Preprocessor class
+ * @version 0.1
+ * @date 2023-06-29
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard libraries
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+// Project files
+#include "preprocessor.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Value of a condition, ordered so that the larger of two values is
+     * the more likely to have taken a branch
+     * @enum Truth
+     */
+    enum class Truth
+    {
+        False,
+        Unknown,
+        True
+    };
+
+    using LocalSymbols = std::map<std::string, Truth, std::less<>>;
+
+    /**
+     * @brief
+     * Checks whether a character can be part of a symbol
+     * @param c Character to check
+     * @return true If the character is a letter, a digit or an underscore
+     */
+    constexpr bool is_symbol_char(char c) noexcept
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+               (c >= '0' && c <= '9') || c == '_' ||
+               static_cast<unsigned char>(c) >= 0x80;
+    }
+
+    /**
+     * @brief
+     * Checks whether a character is a space inside a line
+     * @param c Character to check
+     * @return true If the character is a space or a tab
+     */
+    constexpr bool is_blank(char c) noexcept
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    /**
+     * @brief
+     * Reads the symbol at the start of a text, after any blanks
+     * @param text Text to read
+     * @return std::string_view Symbol, empty if the text has none
+     */
+    std::string_view leading_symbol(std::string_view text)
+    {
+        std::size_t begin{};
+
+        while (begin < text.size() && is_blank(text[begin]))
+            ++begin;
+
+        auto end = begin;
+
+        while (end < text.size() && is_symbol_char(text[end]))
+            ++end;
+
+        return text.substr(begin, end - begin);
+    }
+
+    /**
+     * @class Condition
+     * @brief Recursive descent evaluator of the conditions of #if and
+     * #elif: symbols, true, false, !, ==, !=, &&, || and parentheses.
+     * A malformed condition is unknown
+     */
+    class Condition
+    {
+    public:
+        // Constructor
+        /**
+         * @brief
+         * Construct a new Condition object
+         * @param text Condition, without the directive
+         * @param symbols Symbols of the configuration
+         * @param has_symbols Whether the symbols not configured are
+         *        undefined rather than unknown
+         * @param local Symbols defined or undefined by the file so far
+         */
+        Condition(std::string_view text,
+                  const std::set<std::string, std::less<>> &symbols,
+                  bool has_symbols, const LocalSymbols &local)
+            : m_text(text), m_symbols(symbols), m_has_symbols(has_symbols),
+              m_local(local)
+        {
+        }
+
+        // Methods
+        /**
+         * @brief
+         * Evaluates the whole condition
+         * @return Truth Value of the condition
+         */
+        Truth evaluate()
+        {
+            const auto value = parse_or();
+            skip_blanks();
+
+            if (m_failed || m_position < m_text.size())
+                return Truth::Unknown;
+
+            return value;
+        }
+
+    private:
+        // Deeper nesting is not evaluated, so the stack use is bounded
+        static constexpr std::size_t max_depth = 64;
+
+        std::string_view m_text;
+        const std::set<std::string, std::less<>> &m_symbols;
+        bool m_has_symbols;
+        const LocalSymbols &m_local;
+
+        std::size_t m_position{0};
+        std::size_t m_depth{0};
+        bool m_failed{false};
+
+        // Methods (Private)
+        /**
+         * @brief
+         * Skips the blanks at the current position
+         */
+        void skip_blanks() noexcept
+        {
+            while (m_position < m_text.size() && is_blank(m_text[m_position]))
+                ++m_position;
+        }
+
+        /**
+         * @brief
+         * Consumes an operator if the text continues with it
+         * @param symbol Operator to consume
+         * @return true If it was consumed
+         */
+        bool consume(std::string_view symbol) noexcept
+        {
+            skip_blanks();
+
+            if (m_text.substr(m_position, symbol.size()) != symbol)
+                return false;
+
+            m_position += symbol.size();
+            return true;
+        }
+
+        /**
+         * @brief
+         * Parses a disjunction
+         * @return Truth Value of the disjunction
+         */
+        Truth parse_or()
+        {
+            auto value = parse_and();
+
+            while (!m_failed && consume("||"))
+            {
+                const auto right = parse_and();
+
+                if (value == Truth::True || right == Truth::True)
+                    value = Truth::True;
+                else if (value == Truth::False && right == Truth::False)
+                    value = Truth::False;
+                else
+                    value = Truth::Unknown;
+            }
+
+            return value;
+        }
+
+        /**
+         * @brief
+         * Parses a conjunction
+         * @return Truth Value of the conjunction
+         */
+        Truth parse_and()
+        {
+            auto value = parse_equality();
+
+            while (!m_failed && consume("&&"))
+            {
+                const auto right = parse_equality();
+
+                if (value == Truth::False || right == Truth::False)
+                    value = Truth::False;
+                else if (value == Truth::True && right == Truth::True)
+                    value = Truth::True;
+                else
+                    value = Truth::Unknown;
+            }
+
+            return value;
+        }
+
+        /**
+         * @brief
+         * Parses a comparison with == or !=
+         * @return Truth Value of the comparison
+         */
+        Truth parse_equality()
+        {
+            auto value = parse_unary();
+
+            while (!m_failed)
+            {
+                bool equal;
+
+                if (consume("=="))
+                    equal = true;
+                else if (consume("!="))
+                    equal = false;
+                else
+                    break;
+
+                const auto right = parse_unary();
+
+                if (value == Truth::Unknown || right == Truth::Unknown)
+                    value = Truth::Unknown;
+                else
+                    value = ((value == right) == equal) ? Truth::True : Truth::False;
+            }
+
+            return value;
+        }
+
+        /**
+         * @brief
+         * Parses a negation, or a primary expression
+         * @return Truth Value of the expression
+         */
+        Truth parse_unary()
+        {
+            if (++m_depth > max_depth)
+                m_failed = true;
+
+            auto value = Truth::Unknown;
+
+            if (m_failed)
+                value = Truth::Unknown;
+            else if (consume("!"))
+            {
+                value = parse_unary();
+
+                if (value != Truth::Unknown)
+                    value = value == Truth::True ? Truth::False : Truth::True;
+            }
+            else if (consume("("))
+            {
+                value = parse_or();
+
+                if (!consume(")"))
+                    m_failed = true;
+            }
+            else
+                value = parse_symbol();
+
+            --m_depth;
+            return value;
+        }
+
+        /**
+         * @brief
+         * Parses a symbol, true or false
+         * @return Truth Value of the symbol
+         */
+        Truth parse_symbol()
+        {
+            skip_blanks();
+            const auto symbol = leading_symbol(m_text.substr(m_position));
+            m_position += symbol.size();
+
+            if (symbol.empty())
+            {
+                m_failed = true;
+                return Truth::Unknown;
+            }
+
+            if (symbol == "true")
+                return Truth::True;
+
+            if (symbol == "false")
+                return Truth::False;
+
+            if (const auto it = m_local.find(symbol); it != m_local.end())
+                return it->second;
+
+            if (m_symbols.find(symbol) != m_symbols.end())
+                return Truth::True;
+
+            return m_has_symbols ? Truth::False : Truth::Unknown;
+        }
+    };
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Preprocessor object whose defined symbols are known
+ * @param symbols Defined symbols, every other one is undefined
+ */
+Preprocessor::Preprocessor(const std::vector<std::string> &symbols)
+    : m_symbols(symbols.begin(), symbols.end()), m_has_symbols(true)
+{
+}
+
+// Access methods
+/**
+ * @brief
+ * Checks whether the defined symbols were configured
+ * @return true If the symbols not configured are undefined
+ */
+bool Preprocessor::has_symbols() const noexcept
+{
+    return m_has_symbols;
+}
+
+// Methods
+/**
+ * @brief
+ * Finds the regions of a source left out by its conditional directives.
+ * A region starts at the end of the line of the directive that disables
+ * it and ends before the '#' of the directive that closes it, so the
+ * directives themselves stay outside
+ * @param source Source code
+ * @param find_directive Finds the directives of active code, every '#'
+ *        that starts a line if empty
+ * @return std::vector<SourceRange> Inactive regions, in order
+ */
+std::vector<SourceRange> Preprocessor::find_inactive(std::string_view source,
+                                                     const DirectiveFinder &find_directive) const
+{
+    std::vector<SourceRange> ranges;
+
+    // Whether a branch of every open #if was taken so far
+    std::vector<Truth> taken;
+    LocalSymbols local;
+
+    bool active = true;
+    std::size_t inactive_begin{};
+    std::size_t skipped_depth{};
+    std::size_t position{};
+
+    auto close = [&](std::size_t end)
+    {
+        if (inactive_begin < end)
+            ranges.push_back({inactive_begin, end});
+    };
+
+    auto evaluate = [&](std::string_view text)
+    {
+        return Condition(text, m_symbols, m_has_symbols, local).evaluate();
+    };
+
+    while (position < source.size())
+    {
+        auto hash = find_line_start_hash(source, position);
+
+        // The finder only scans active code that may still have a directive
+        if (active && hash != std::string_view::npos && find_directive)
+            hash = find_directive(position);
+
+        if (hash == std::string_view::npos)
+            break;
+
+        const auto line_end = find_line_end(source, hash);
+        const auto name = leading_symbol(source.substr(hash + 1, line_end - hash - 1));
+        const auto name_end = static_cast<std::size_t>(name.data() + name.size() -
+                                                       source.data());
+        auto argument = source.substr(name_end, line_end - name_end);
+        argument = argument.substr(0, argument.find("//"));
+        position = line_end;
+
+        const bool is_branch = name == "elif" || name == "else";
+
+        if (!active)
+        {
+            if (name == "if")
+                ++skipped_depth;
+            else if (name == "endif" && skipped_depth > 0)
+                --skipped_depth;
+            else if (name == "endif")
+            {
+                close(hash);
+                taken.pop_back();
+                active = true;
+            }
+            else if (is_branch && skipped_depth == 0)
+            {
+                close(hash);
+
+                const auto condition = name == "else" ? Truth::True : evaluate(argument);
+                active = taken.back() != Truth::True && condition != Truth::False;
+                taken.back() = std::max(taken.back(), condition);
+                inactive_begin = line_end;
+            }
+
+            continue;
+        }
+
+        if (name == "define" || name == "undef")
+        {
+            const auto symbol = leading_symbol(argument);
+
+            if (!symbol.empty())
+                local.insert_or_assign(std::string(symbol),
+                                       name == "define" ? Truth::True : Truth::False);
+        }
+        else if (name == "if")
+        {
+            const auto condition = evaluate(argument);
+            taken.push_back(condition);
+            active = condition != Truth::False;
+            inactive_begin = line_end;
+        }
+        else if (is_branch && !taken.empty())
+        {
+            // The branch before was active, so this one is inactive unless
+            // that branch may not have been taken
+            const auto condition = name == "else" ? Truth::True : evaluate(argument);
+            active = taken.back() != Truth::True && condition != Truth::False;
+            taken.back() = std::max(taken.back(), condition);
+            inactive_begin = line_end;
+        }
+        else if (name == "endif" && !taken.empty())
+            taken.pop_back();
+    }
+
+    if (!active)
+        close(source.size());
+
+    return ranges;
+}
+
+/**
+ * @brief
+ * Checks whether only blanks come before an offset on its line, as for
+ * the '#' of a directive
+ * @param source Source code
+ * @param offset Offset to check
+ * @return true If the offset starts the text of its line
+ */
+bool Preprocessor::is_line_start(std::string_view source, std::size_t offset) noexcept
+{
+    while (offset > 0 && is_blank(source[offset - 1]))
+        --offset;
+
+    return offset == 0 || source[offset - 1] == '\n' || source[offset - 1] == '\r';
+}
+
+/**
+ * @brief
+ * Finds the first '#' at or after an offset that starts its line
+ * @param source Source code
+ * @param offset Offset to search from
+ * @return std::size_t Offset of the '#', npos if there is none
+ */
+std::size_t Preprocessor::find_line_start_hash(std::string_view source,
+                                               std::size_t offset) noexcept
+{
+    while (offset < source.size())
+    {
+        const auto *found = static_cast<const char *>(
+            std::memchr(source.data() + offset, '#', source.size() - offset));
+
+        if (found == nullptr)
+            break;
+
+        offset = static_cast<std::size_t>(found - source.data());
+
+        if (is_line_start(source, offset))
+            return offset;
+
+        ++offset;
+    }
+
+    return std::string_view::npos;
+}
+
+/**
+ * @brief
+ * Finds the end of the line of an offset
+ * @param source Source code
+ * @param offset Offset in the line
+ * @return std::size_t Offset of the line break, or the size of the source
+ */
+std::size_t Preprocessor::find_line_end(std::string_view source,
+                                        std::size_t offset) noexcept
+{
+    const auto end = source.find_first_of("\r\n", offset);
+    return end == std::string_view::npos ? source.size() : end;
+}
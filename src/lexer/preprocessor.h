@@ -0,0 +1,77 @@
+/**
+ * @file preprocessor.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the Preprocessor class
+ * @version 0.1
+ * @date 2023-06-29
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef PREPROCESSOR_H
+#define PREPROCESSOR_H
+
+// C++ standard libraries
+#include <cstddef>
+#include <functional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief
+ * Range of offsets [begin, end) of a source
+ * @struct SourceRange
+ */
+struct SourceRange
+{
+    std::size_t begin{0};
+    std::size_t end{0};
+};
+
+/**
+ * @class Preprocessor
+ * @brief Finds the regions of a source that conditional directives
+ * (#if, #elif, #else, #endif) leave out of the build
+ * @details
+ * Conditions are evaluated with three values: a symbol that is neither
+ * defined by the configuration nor by a #define of the file is unknown,
+ * and a branch whose condition is unknown stays active, as does every
+ * branch after it. Once the symbols are configured, the symbols not among
+ * them are undefined. Inactive regions are searched for '#' with memchr,
+ * so they are skipped without being scanned token by token. Active code is
+ * searched with the directive finder of the language, so a '#' that starts
+ * a line inside a comment or a string is not taken for a directive.
+ */
+class Preprocessor
+{
+public:
+    // Finds the first directive at or after an offset of active code, npos
+    // if there is none
+    using DirectiveFinder = std::function<std::size_t(std::size_t)>;
+
+    // Constructor
+    Preprocessor() = default;
+    explicit Preprocessor(const std::vector<std::string> &);
+
+    // Access methods
+    bool has_symbols() const noexcept;
+
+    // Methods
+    std::vector<SourceRange> find_inactive(std::string_view,
+                                           const DirectiveFinder & = {}) const;
+
+    static bool is_line_start(std::string_view, std::size_t) noexcept;
+    static std::size_t find_line_end(std::string_view, std::size_t) noexcept;
+    static std::size_t find_line_start_hash(std::string_view, std::size_t) noexcept;
+
+private:
+    // Defined symbols, when configured
+    std::set<std::string, std::less<>> m_symbols;
+    bool m_has_symbols{false};
+};
+
+#endif //! PREPROCESSOR_H
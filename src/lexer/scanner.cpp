@@ -0,0 +1,522 @@
+/**
+ * @file scanner.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the Scanner class
+ * @version 0.1
+ * @date 2023-06-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+
+// Project files
+#include "scanner.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Checks whether a character is an ASCII digit
+     * @param c Character to check
+     * @return true If the character is between '0' and '9'
+     */
+    constexpr bool is_digit(char c) noexcept
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    /**
+     * @brief
+     * Checks whether a character ends a line
+     * @param c Character to check
+     * @return true If the character is a line feed or a carriage return
+     */
+    constexpr bool is_line_break(char c) noexcept
+    {
+        return c == '\n' || c == '\r';
+    }
+
+    /**
+     * @brief
+     * Checks whether a character is one of a few known at compile time.
+     * Unlike std::string_view::find, the loop unrolls into comparisons
+     * @param set Characters to look for
+     * @param c Character to check
+     * @return true If the character is in the set
+     */
+    constexpr bool is_one_of(std::string_view set, char c) noexcept
+    {
+        for (const char candidate : set)
+            if (c == candidate)
+                return true;
+
+        return false;
+    }
+
+    /**
+     * @brief
+     * Checks whether a source has a delimiter at an offset
+     * @param source Source code
+     * @param offset Offset to check
+     * @param delimiter Delimiter to look for
+     * @return true If the source continues with the delimiter
+     */
+    constexpr bool has_at(std::string_view source, std::size_t offset,
+                          std::string_view delimiter) noexcept
+    {
+        if (source.size() - offset < delimiter.size())
+            return false;
+
+        for (std::size_t i{}; i < delimiter.size(); ++i)
+            if (source[offset + i] != delimiter[i])
+                return false;
+
+        return true;
+    }
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Basic Scanner:: Basic Scanner object
+ * @param source Source code to scan, must outlive the scanner and the
+ *        tokens it returns
+ * @param inactive Regions of the source left out by its directives, in
+ *        order, must outlive the scanner
+ */
+template <LanguageDescription Description>
+BasicScanner<Description>::BasicScanner(std::string_view source,
+                                        std::span<const SourceRange> inactive)
+    : m_source(source), m_inactive(inactive)
+{
+    static_assert(Description::quotes.size() <= std::tuple_size_v<decltype(m_unterminated)>,
+                  "too many quote characters");
+
+    if (!m_inactive.empty())
+        m_inactive_begin = m_inactive.front().begin;
+}
+
+// Access methods
+/**
+ * @brief
+ * Gets the offset right after the last token returned
+ * @return std::size_t Offset in the source
+ */
+template <LanguageDescription Description>
+std::size_t BasicScanner<Description>::get_position() const noexcept
+{
+    return m_position;
+}
+
+// Methods (Public)
+/**
+ * @brief
+ * Reads the next token of the source
+ * @param token Output view of the token inside the source
+ * @return true If a token was read, false at the end of the source
+ */
+template <LanguageDescription Description>
+bool BasicScanner<Description>::next(std::string_view &token)
+{
+    ScanKind kind;
+    return next(token, kind);
+}
+
+/**
+ * @brief
+ * Reads the next token of the source and what it is
+ * @param token Output view of the token inside the source
+ * @param kind Output kind of the token
+ * @return true If a token was read, false at the end of the source
+ */
+template <LanguageDescription Description>
+bool BasicScanner<Description>::next(std::string_view &token, ScanKind &kind)
+{
+    while (m_position < m_source.size())
+    {
+        if (m_position >= m_inactive_begin && match_inactive(token))
+        {
+            kind = ScanKind::Inactive;
+            return true;
+        }
+
+        std::size_t length;
+        kind = ScanKind::Token;
+
+        if constexpr (Description::directives)
+        {
+            if (m_source[m_position] == '#' &&
+                Preprocessor::is_line_start(m_source, m_position))
+            {
+                length = Preprocessor::find_line_end(m_source, m_position) - m_position;
+                kind = ScanKind::Directive;
+            }
+            else
+                length = match(m_position);
+        }
+        else
+            length = match(m_position);
+
+        if (length == 0)
+        {
+            ++m_position;
+            continue;
+        }
+
+        token = m_source.substr(m_position, length);
+        m_position += length;
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief
+ * Scans from an offset, or from the current position if it is further, up
+ * to the next directive, so that the '#' of comments and strings is passed
+ * over the same as when the source is tokenized
+ * @param begin Offset to scan from
+ * @return std::size_t Offset of the directive, npos if there is none
+ */
+template <LanguageDescription Description>
+std::size_t BasicScanner<Description>::find_directive(std::size_t begin)
+{
+    m_position = std::max(m_position, begin);
+
+    std::string_view token;
+    ScanKind kind;
+
+    while (next(token, kind))
+    {
+        if (kind == ScanKind::Directive)
+            return static_cast<std::size_t>(token.data() - m_source.data());
+    }
+
+    return std::string_view::npos;
+}
+
+/**
+ * @brief
+ * Checks whether a character belongs to the words of the language, \w in
+ * the C locale for C#
+ * @param c Character to check
+ * @return true If the character is a word character
+ */
+template <LanguageDescription Description>
+bool BasicScanner<Description>::is_word(char c) noexcept
+{
+    return Description::classes[static_cast<unsigned char>(c)] & WordChar;
+}
+
+/**
+ * @brief
+ * Checks whether a character belongs to \s in the C locale
+ * @param c Character to check
+ * @return true If the character is a space, tab or line break
+ */
+template <LanguageDescription Description>
+bool BasicScanner<Description>::is_space(char c) noexcept
+{
+    return Description::classes[static_cast<unsigned char>(c)] & SpaceChar;
+}
+
+/**
+ * @brief
+ * Checks whether a character is a single character token
+ * @param c Character to check
+ * @return true If the character is an operator or separator
+ */
+template <LanguageDescription Description>
+bool BasicScanner<Description>::is_punctuation(char c) noexcept
+{
+    return Description::classes[static_cast<unsigned char>(c)] & PunctuationChar;
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Matches the token starting at an offset
+ * @param begin Offset of the first character
+ * @return std::size_t Length of the token, 0 if the character is skipped
+ */
+template <LanguageDescription Description>
+std::size_t BasicScanner<Description>::match(std::size_t begin)
+{
+    constexpr auto line_comment = Description::line_comment;
+    constexpr auto block_open = Description::block_comment_open;
+
+    const char c = m_source[begin];
+
+    if (is_one_of(Description::quotes, c))
+    {
+        if (const auto length = match_string(begin))
+            return length;
+    }
+
+    if (is_word(c))
+    {
+        if ((c == '_' || is_digit(c)) && is_boundary(begin))
+        {
+            if (const auto length = match_number(begin))
+                return length;
+        }
+
+        auto end = begin + 1;
+
+        while (end < m_source.size() && is_word(m_source[end]))
+            ++end;
+
+        return end - begin;
+    }
+
+    if (is_space(c))
+    {
+        auto end = begin + 1;
+
+        while (end < m_source.size() && is_space(m_source[end]))
+            ++end;
+
+        return end - begin;
+    }
+
+    if (has_at(m_source, begin, line_comment))
+    {
+        const auto end = m_source.find('\n', begin + line_comment.size());
+        return (end == std::string_view::npos ? m_source.size() : end) - begin;
+    }
+
+    if constexpr (!block_open.empty())
+    {
+        if (has_at(m_source, begin, block_open))
+        {
+            if (const auto length = match_block_comment(begin))
+                return length;
+        }
+    }
+
+    return is_punctuation(c) ? 1 : 0;
+}
+
+/**
+ * @brief
+ * Matches the inactive region starting at the current position. Regions
+ * the scanner went past, as when a token it matched disagrees with the
+ * directives found, are shortened or left out
+ * @param token Output view of the region
+ * @return true If a region was matched
+ */
+template <LanguageDescription Description>
+bool BasicScanner<Description>::match_inactive(std::string_view &token)
+{
+    bool matched = false;
+
+    while (!m_inactive.empty() && m_inactive.front().begin <= m_position)
+    {
+        const auto end = std::min(m_inactive.front().end, m_source.size());
+        m_inactive = m_inactive.subspan(1);
+
+        if (end > m_position)
+        {
+            token = m_source.substr(m_position, end - m_position);
+            m_position = end;
+            matched = true;
+            break;
+        }
+    }
+
+    m_inactive_begin = m_inactive.empty() ? std::string_view::npos
+                                          : m_inactive.front().begin;
+    return matched;
+}
+
+/**
+ * @brief
+ * Matches a string with the rule of the language
+ * @param begin Offset of the opening quote
+ * @return std::size_t Length of the string, 0 if it is not closed
+ */
+template <LanguageDescription Description>
+std::size_t BasicScanner<Description>::match_string(std::size_t begin)
+{
+    if constexpr (Description::strings == StringRule::BackslashEscape)
+        return match_escaped_string(begin, m_source[begin]);
+    else if constexpr (Description::strings == StringRule::DoubledQuote)
+        return match_doubled_string(begin, m_source[begin]);
+    else
+    {
+        static_assert(Description::quotes.size() == 1,
+                      "the last quote of a line is searched for one quote");
+
+        // Everything up to the last quote of the line. The line end and
+        // its last quote are only searched once per line
+        if (begin >= m_line_end)
+        {
+            const auto end = m_source.find_first_of("\r\n", begin);
+            m_line_end = end == std::string_view::npos ? m_source.size() : end;
+            m_last_quote = m_source.rfind(Description::quotes.front(), m_line_end - 1);
+        }
+
+        if (m_last_quote == std::string_view::npos || m_last_quote <= begin)
+            return 0;
+
+        return m_last_quote + 1 - begin;
+    }
+}
+
+/**
+ * @brief
+ * Matches a string that ends at the first quote not escaped by a
+ * backslash. Strings of single line quotes also end at the line break.
+ * @details An unterminated string is parsed the same from any later quote
+ * of the same kind, since backslash runs after it are read the same, so
+ * those quotes are not searched again
+ * @param begin Offset of the opening quote
+ * @param quote Opening quote
+ * @return std::size_t Length of the string, 0 if it is not closed
+ */
+template <LanguageDescription Description>
+std::size_t BasicScanner<Description>::match_escaped_string(std::size_t begin,
+                                                            char quote)
+{
+    const auto kind = Description::quotes.find(quote);
+
+    if (kind >= m_unterminated.size() || begin < m_unterminated[kind])
+        return 0;
+
+    const bool multiline = is_one_of(Description::multiline_quotes, quote);
+    auto end = begin + 1;
+
+    while (end < m_source.size())
+    {
+        const char c = m_source[end];
+
+        if (c == '\\')
+            end += 2;
+        else if (c == quote)
+            return end + 1 - begin;
+        else if (!multiline && is_line_break(c))
+            break;
+        else
+            ++end;
+    }
+
+    m_unterminated[kind] = std::min(end, m_source.size());
+    return 0;
+}
+
+/**
+ * @brief
+ * Matches a string that ends at the first quote not doubled, and at the
+ * latest at the end of the line
+ * @param begin Offset of the opening quote
+ * @param quote Opening quote
+ * @return std::size_t Length of the string, 0 if it is not closed
+ */
+template <LanguageDescription Description>
+std::size_t BasicScanner<Description>::match_doubled_string(std::size_t begin,
+                                                            char quote) const noexcept
+{
+    auto end = begin + 1;
+
+    while (end < m_source.size() && !is_line_break(m_source[end]))
+    {
+        if (m_source[end] != quote)
+            ++end;
+        else if (end + 1 < m_source.size() && m_source[end + 1] == quote)
+            end += 2;
+        else
+            return end + 1 - begin;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief
+ * Matches a number, optionally prefixed by an underscore and with a
+ * fractional part. The number must end at a word boundary.
+ * @param begin Offset of the first character
+ * @return std::size_t Length of the number, 0 if there is none
+ */
+template <LanguageDescription Description>
+std::size_t BasicScanner<Description>::match_number(std::size_t begin) const noexcept
+{
+    const auto size = m_source.size();
+    auto end = begin;
+
+    if (m_source[end] == '_')
+        ++end;
+
+    if (end >= size || !is_digit(m_source[end]))
+        return 0;
+
+    while (end < size && is_digit(m_source[end]))
+        ++end;
+
+    if (end + 1 < size && m_source[end] == '.' &&
+        is_digit(m_source[end + 1]))
+    {
+        auto fraction = end + 1;
+
+        while (fraction < size && is_digit(m_source[fraction]))
+            ++fraction;
+
+        if (is_boundary(fraction))
+            return fraction - begin;
+    }
+
+    return is_boundary(end) ? end - begin : 0;
+}
+
+/**
+ * @brief
+ * Matches a block comment up to the first closing delimiter
+ * @param begin Offset of the opening delimiter
+ * @return std::size_t Length of the comment, 0 if it is never closed
+ */
+template <LanguageDescription Description>
+std::size_t BasicScanner<Description>::match_block_comment(std::size_t begin)
+{
+    constexpr auto close = Description::block_comment_close;
+
+    if (!m_comment_can_close)
+        return 0;
+
+    const auto end = m_source.find(close, begin + Description::block_comment_open.size());
+
+    if (end == std::string_view::npos)
+    {
+        m_comment_can_close = false;
+        return 0;
+    }
+
+    return end + close.size() - begin;
+}
+
+/**
+ * @brief
+ * Checks for a word boundary (\b) before an offset
+ * @param offset Offset to check
+ * @return true If exactly one of the surrounding characters is a word
+ *         character
+ */
+template <LanguageDescription Description>
+bool BasicScanner<Description>::is_boundary(std::size_t offset) const noexcept
+{
+    const bool before = offset > 0 && is_word(m_source[offset - 1]);
+    const bool after = offset < m_source.size() && is_word(m_source[offset]);
+
+    return before != after;
+}
+
+// One scanner per language
+template class BasicScanner<CSharpLanguage>;
+template class BasicScanner<VisualBasicLanguage>;
+template class BasicScanner<FSharpLanguage>;
+template class BasicScanner<TypeScriptLanguage>;
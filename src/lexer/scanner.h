@@ -0,0 +1,136 @@
+/**
+ * @file scanner.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the Scanner class
+ * @version 0.1
+ * @date 2023-06-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef SCANNER_H
+#define SCANNER_H
+
+// C++ Standard Libraries
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// Project files
+#include "language.h"
+#include "preprocessor.h"
+
+/**
+ * @brief
+ * What the scanner matched
+ * @enum ScanKind
+ */
+enum class ScanKind : std::uint8_t
+{
+    // A raw token, classified by its text
+    Token,
+
+    // A preprocessor directive, up to the end of its line
+    Directive,
+
+    // A whole region left out by the directives
+    Inactive
+};
+
+/**
+ * @class BasicScanner
+ * @brief Splits the source code of a language into raw tokens in linear
+ * time
+ * @tparam Description Language description the scanner is specialized for
+ * @details
+ * At every position the scanner tries, in this order: a string, a number
+ * (_?[0-9]+(\.[0-9]+)? between word boundaries), a run of word characters,
+ * a run of whitespace, a line comment, a block comment and a punctuation
+ * character. Characters that start none of them are skipped. Outside of
+ * directives, for C# this produces the same tokens as the regular
+ * expression the lexer used to run through std::regex:
+ *
+ *     ".*"                          string, up to the last quote of the line
+ *     \b_?[0-9]+(\.[0-9]+)?\b       number
+ *     \w+                           word
+ *     \s+                           whitespace
+ *     //[^\n]*                      line comment
+ *     /\*[\s\S]*?\*\/               block comment
+ *     [{}()\[\];,.:?><+\-*%&=!@#$~_`\\|"/]   punctuation
+ *
+ * Languages with directives also match a '#' that starts a line as a
+ * directive up to the end of the line, before anything else, and return
+ * each inactive region they are given as one token without scanning it.
+ *
+ * Every byte is examined a bounded number of times: the end of the current
+ * line is only searched once per line, a block comment without a closing
+ * delimiter stops later ones from searching again, and so does a string
+ * without a closing quote for the strings of the same quote. No recursion
+ * is involved, so the stack use does not depend on the input. The members
+ * are instantiated once per language in scanner.cpp.
+ */
+template <LanguageDescription Description>
+class BasicScanner
+{
+public:
+    // Constructor
+    explicit BasicScanner(std::string_view, std::span<const SourceRange> = {});
+
+    // Access methods
+    std::size_t get_position() const noexcept;
+
+    // Methods
+    bool next(std::string_view &);
+    bool next(std::string_view &, ScanKind &);
+    std::size_t find_directive(std::size_t);
+
+    static bool is_word(char) noexcept;
+    static bool is_space(char) noexcept;
+    static bool is_punctuation(char) noexcept;
+
+private:
+    std::string_view m_source;
+    std::size_t m_position{0};
+
+    // Inactive regions not reached yet, in order
+    std::span<const SourceRange> m_inactive;
+    std::size_t m_inactive_begin{std::string_view::npos};
+
+    // Last quote of the line the scanner is on, npos if it has none
+    std::size_t m_line_end{0};
+    std::size_t m_last_quote{std::string_view::npos};
+
+    // Once a block comment has no closing delimiter after it, no later one
+    // can have one
+    bool m_comment_can_close{true};
+
+    // Strings of each quote starting before these offsets are unterminated
+    std::array<std::size_t, 4> m_unterminated{};
+
+    // Methods
+    std::size_t match(std::size_t);
+    bool match_inactive(std::string_view &);
+    std::size_t match_string(std::size_t);
+    std::size_t match_escaped_string(std::size_t, char);
+    std::size_t match_doubled_string(std::size_t, char) const noexcept;
+    std::size_t match_number(std::size_t) const noexcept;
+    std::size_t match_block_comment(std::size_t);
+    bool is_boundary(std::size_t) const noexcept;
+};
+
+extern template class BasicScanner<CSharpLanguage>;
+extern template class BasicScanner<VisualBasicLanguage>;
+extern template class BasicScanner<FSharpLanguage>;
+extern template class BasicScanner<TypeScriptLanguage>;
+
+/**
+ * @brief
+ * Scanner of C# source code
+ */
+using Scanner = BasicScanner<CSharpLanguage>;
+
+#endif //! SCANNER_H
@@ -17,15 +17,36 @@
 #include <algorithm>
 #include <vector>
 #include <memory>
+#include <thread>
+#include <chrono>
+#include <optional>
+#include <csignal>
+#include <iomanip>
+#include <fstream>
 
 // Classes
 #include "lexer/lexer.h"
+#include "server/server.h"
+#include "watch/watcher.h"
 
 // Utils
 #include "utils/utils.h"
+#include "utils/options.h"
+#include "utils/bench.h"
 
 // Function prototypes
 std::vector<std::filesystem::path> get_filenames(const std::string_view &);
+int run_daemon(const utils::Options &);
+int run_watch(const utils::Options &);
+int run_merge(int, char **);
+int run_unbundle(int, char **);
+int run_lookup(int, char **);
+void print_bench(const std::string &, const utils::Options &,
+                 const utils::Summary &, std::uintmax_t, std::size_t);
+
+// Long running instances stopped by the signal handler
+static Server *g_server{nullptr};
+static Watcher *g_watcher{nullptr};
 
 // Main function
 /**
@@ -37,16 +58,36 @@ std::vector<std::filesystem::path> get_filenames(const std::string_view &);
  */
 int main(int argc, char **argv)
 {
-    if (argc != 2)
+    if (argc > 1 && std::string_view(argv[1]) == "merge")
+        return run_merge(argc, argv);
+
+    if (argc > 1 && std::string_view(argv[1]) == "unbundle")
+        return run_unbundle(argc, argv);
+
+    if (argc > 1 && std::string_view(argv[1]) == "lookup")
+        return run_lookup(argc, argv);
+
+    utils::Options options;
+
+    try
     {
-        std::cerr
-            << "Usage: " << argv[0]
-            << "input_directory" << std::endl;
+        options = utils::parse_options(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << "\n"
+                  << utils::usage(argv[0]);
 
         return 1;
     }
 
-    std::string_view input_directory{argv[1]};
+    if (!options.daemon_socket.empty())
+        return run_daemon(options);
+
+    if (!options.watch_directory.empty())
+        return run_watch(options);
+
+    std::string_view input_directory{options.input_directory};
 
     if (!std::filesystem::exists(input_directory) ||
         !std::filesystem::is_directory(input_directory))
@@ -57,7 +98,62 @@ int main(int argc, char **argv)
     }
 
     auto filenames = get_filenames(input_directory);
+
+    // Sizes balance the shards and go to the manifest. Unreadable files
+    // count as empty
+    std::vector<std::uintmax_t> sizes(filenames.size());
+
+    for (std::size_t i{}; i < filenames.size(); ++i)
+    {
+        std::error_code error;
+        const auto size = std::filesystem::file_size(filenames[i], error);
+        sizes[i] = error ? 0 : size;
+    }
+
+    if (options.shard.count > 1)
+    {
+        std::vector<std::string> keys;
+
+        for (const auto &filename : filenames)
+            keys.push_back(filename.filename().string());
+
+        std::vector<std::filesystem::path> shard_filenames;
+        std::vector<std::uintmax_t> shard_sizes;
+
+        for (const auto index : select_shard(keys, sizes, options.shard))
+        {
+            shard_filenames.push_back(filenames[index]);
+            shard_sizes.push_back(sizes[index]);
+        }
+
+        filenames = std::move(shard_filenames);
+        sizes = std::move(shard_sizes);
+    }
+
     std::unique_ptr<Lexer> lexer{std::make_unique<Lexer>()};
+    lexer->set_collect_stats(!options.stats_output.empty());
+    lexer->set_worker_count(options.threads);
+    lexer->set_pin_workers(options.pin_threads);
+    lexer->set_split_size(options.split_size);
+    lexer->set_group_size(options.group_size);
+    lexer->set_max_token_length(options.max_token_length);
+    lexer->set_page_lines(options.page_lines);
+    lexer->set_memory_budget(options.memory_budget_mb * 1024 * 1024);
+    lexer->set_bundle(options.bundle_output);
+    lexer->set_index(options.index_output);
+
+    if (options.defines)
+        lexer->set_defines(*options.defines);
+
+    if (!options.trace_output.empty())
+    {
+        lexer->set_trace(true);
+        lexer->get_trace().set_thread_name("main");
+    }
+
+    if (options.perf_counters && !lexer->set_perf_counters(true))
+        std::cerr << "Warning: performance counters are not available"
+                  << std::endl;
 
     // Convert filenames to strings
     std::vector<std::string> filenames_str;
@@ -68,25 +164,419 @@ int main(int argc, char **argv)
                        return path.string();
                    });
 
-    // Start the lexer and measure the time
-    auto single_time = utils::measure_time([&]()
-                                           { lexer->start_single(filenames_str); });
+    // Each run gets its own deadline, measured from its start
+    auto deadline = [&]() -> std::optional<Batch::Clock::time_point>
+    {
+        if (options.deadline_ms == 0)
+            return std::nullopt;
+
+        return Batch::Clock::now() +
+               std::chrono::milliseconds(options.deadline_ms);
+    };
+
+    // Lexers to run, in order
+    std::vector<std::pair<std::string, bool>> runs;
+
+    if (options.mode != utils::RunMode::Multi)
+        runs.emplace_back("Single", false);
+
+    if (options.mode != utils::RunMode::Single)
+        runs.emplace_back("Multi", true);
+
+    std::size_t dropped{};
+    auto run = [&](bool multi)
+    {
+        if (multi)
+            lexer->start_multi(filenames_str, deadline());
+        else
+            lexer->start_single(filenames_str, deadline());
+
+        dropped += lexer->get_dropped_tasks();
+    };
+
+    if (!options.bench)
+    {
+        // Start the lexer and measure the time
+        for (const auto &[name, multi] : runs)
+        {
+            if (options.drop_caches)
+                utils::drop_page_caches(filenames_str);
+
+            const auto time = utils::measure_time(run, multi);
+
+            std::cout
+                << "Execution time for " << name << " thread Lexer "
+                << time / 1000.0
+                << "s" << std::endl;
+
+            if (lexer->get_perf_counters().is_enabled())
+                lexer->get_perf_counters().print(std::cout);
+        }
+    }
+    else
+    {
+        std::uintmax_t input_bytes{};
+
+        for (const auto size : sizes)
+            input_bytes += size;
+
+        // Every lexer gets its own warmup, so none of them runs on the
+        // page cache warmed by another
+        for (const auto &[name, multi] : runs)
+        {
+            std::vector<double> times;
+            std::size_t tokens{};
+
+            for (std::size_t i{}; i < options.warmup + options.repetitions; ++i)
+            {
+                if (options.drop_caches)
+                    utils::drop_page_caches(filenames_str);
 
-    auto multi_time = utils::measure_time([&]()
-                                          { lexer->start_multi(filenames_str); });
+                const auto time = utils::measure_time(run, multi);
 
-    std::cout
-        << "Execution time for Single thread Lexer "
-        << single_time / 1000.0
-        << "s" << std::endl;
+                if (i >= options.warmup)
+                    times.push_back(time);
 
-    std::cout
-        << "Execution time for Multi thread Lexer "
-        << multi_time / 1000.0
-        << "s" << std::endl;
+                tokens = lexer->get_token_count();
+            }
+
+            print_bench(name, options, utils::summarize(std::move(times)),
+                        input_bytes, tokens);
+
+            // Counters of the last repetition
+            if (lexer->get_perf_counters().is_enabled())
+                lexer->get_perf_counters().print(std::cout);
+        }
+    }
+
+    if (dropped != 0)
+        std::cout << "Deadline reached, dropped " << dropped
+                  << " task(s)" << std::endl;
+
+    if (!options.stats_output.empty())
+    {
+        try
+        {
+            lexer->get_stats().save(options.stats_output);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!options.manifest_output.empty())
+    {
+        // The outputs of the last run, as the statistics
+        ShardManifest manifest;
+        manifest.shard = options.shard.index;
+        manifest.shard_count = options.shard.count;
+        manifest.strategy = options.shard.strategy;
+        manifest.bundle = !options.bundle_output.empty() &&
+                          options.mode != utils::RunMode::Single;
+        manifest.outputs =
+            std::filesystem::absolute(
+                manifest.bundle ? options.bundle_output
+                : options.mode == utils::RunMode::Single
+                    ? "../outputSingle"
+                    : "../outputParallel")
+                .lexically_normal()
+                .string();
+
+        if (!options.stats_output.empty())
+            manifest.stats =
+                std::filesystem::absolute(options.stats_output).string();
+
+        manifest.dropped = dropped;
+
+        for (std::size_t i{}; i < filenames_str.size(); ++i)
+            manifest.files.push_back({filenames_str[i],
+                                      lexer->get_output_name(filenames_str[i]),
+                                      sizes[i]});
+
+        try
+        {
+            manifest.save(options.manifest_output);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (!options.trace_output.empty())
+    {
+        try
+        {
+            // A task span is recorded after its batch sees it finish
+            lexer->get_pool().wait_idle();
+            lexer->get_trace().save(options.trace_output);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
 }
 
 // Function definitions
+/**
+ * @brief
+ * Runs the highlight daemon until it receives SIGINT or SIGTERM
+ * @param options - Parsed command line options
+ * @return int - 0 if success, 1 if error
+ */
+int run_daemon(const utils::Options &options)
+{
+    Lexer lexer;
+    lexer.set_worker_count(options.threads);
+    lexer.set_max_token_length(options.max_token_length);
+
+    if (options.defines)
+        lexer.set_defines(*options.defines);
+
+    Server server(lexer, options.daemon_socket, lexer.get_worker_count(),
+                  options.cache_capacity, options.cache_memory_mb * 1024 * 1024,
+                  options.pin_threads);
+
+    g_server = &server;
+
+    auto handler = [](int)
+    {
+        if (g_server)
+            g_server->stop();
+    };
+
+    std::signal(SIGINT, handler);
+    std::signal(SIGTERM, handler);
+
+    try
+    {
+        std::cout << "Listening on " << options.daemon_socket << std::endl;
+        server.run();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        g_server = nullptr;
+        return 1;
+    }
+
+    g_server = nullptr;
+    return 0;
+}
+
+/**
+ * @brief
+ * Watches a directory and re-highlights changed files until it receives
+ * SIGINT or SIGTERM
+ * @param options - Parsed command line options
+ * @return int - 0 if success, 1 if error
+ */
+int run_watch(const utils::Options &options)
+{
+    try
+    {
+        Lexer lexer;
+        lexer.set_worker_count(options.threads);
+        lexer.set_pin_workers(options.pin_threads);
+        lexer.set_max_token_length(options.max_token_length);
+
+        if (options.defines)
+            lexer.set_defines(*options.defines);
+
+        Watcher watcher(lexer, options.watch_directory,
+                        std::chrono::milliseconds(options.debounce_ms),
+                        std::chrono::milliseconds(options.max_delay_ms));
+
+        g_watcher = &watcher;
+
+        auto handler = [](int)
+        {
+            if (g_watcher)
+                g_watcher->stop();
+        };
+
+        std::signal(SIGINT, handler);
+        std::signal(SIGTERM, handler);
+
+        std::cout << "Watching " << options.watch_directory << std::endl;
+        watcher.run();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        g_watcher = nullptr;
+        return 1;
+    }
+
+    g_watcher = nullptr;
+    return 0;
+}
+
+/**
+ * @brief
+ * Merges the manifests, statistics and outputs of the shards of a run
+ * @param argc - Number of arguments, the first one being "merge"
+ * @param argv - Arguments
+ * @return int - 0 if success, 1 if error
+ */
+int run_merge(int argc, char **argv)
+{
+    utils::MergeOptions options;
+
+    try
+    {
+        options = utils::parse_merge_options(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << "\n"
+                  << utils::usage(argv[0]);
+
+        return 1;
+    }
+
+    try
+    {
+        merge_shards(options.manifests, options.manifest_output,
+                     options.stats_output, options.bundle_output);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Merged " << options.manifests.size() << " shard(s)"
+              << std::endl;
+    return 0;
+}
+
+/**
+ * @brief
+ * Writes every document of a bundle to a directory, as the run that made
+ * the bundle would have without it
+ * @param argc - Number of arguments, the first one being "unbundle"
+ * @param argv - Arguments
+ * @return int - 0 if success, 1 if error
+ */
+int run_unbundle(int argc, char **argv)
+{
+    if (argc != 4)
+    {
+        std::cerr << "Error: unbundle needs a bundle and a directory\n"
+                  << utils::usage(argv[0]);
+
+        return 1;
+    }
+
+    try
+    {
+        const BundleReader bundle(argv[2]);
+        const std::filesystem::path directory(argv[3]);
+
+        std::filesystem::create_directories(directory);
+
+        for (const auto &name : bundle.get_names())
+        {
+            std::ofstream output(directory / name,
+                                 std::ios::binary | std::ios::trunc);
+
+            if (!(output << *bundle.read(name)))
+                throw std::runtime_error("Cannot write file: " +
+                                         (directory / name).string());
+        }
+
+        std::cout << "Extracted " << bundle.size() << " document(s)"
+                  << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief
+ * Prints where identifiers occur, from the index written by a parallel
+ * run, one "file:offset:identifier" line per occurrence
+ * @param argc - Number of arguments, the first one being "lookup"
+ * @param argv - Arguments
+ * @return int - 0 if every identifier occurs, 1 if one does not or on
+ *         error
+ */
+int run_lookup(int argc, char **argv)
+{
+    if (argc < 4)
+    {
+        std::cerr << "Error: lookup needs an index and an identifier\n"
+                  << utils::usage(argv[0]);
+
+        return 1;
+    }
+
+    try
+    {
+        const IdentifierIndex index(argv[2]);
+        bool found_all = true;
+
+        for (int i{3}; i < argc; ++i)
+        {
+            const auto postings = index.find(argv[i]);
+            found_all = found_all && !postings.empty();
+
+            for (const auto &posting : postings)
+                std::cout << index.get_file(posting.file) << ':' << posting.offset
+                          << ':' << argv[i] << '\n';
+        }
+
+        std::cout << std::flush;
+        return found_all ? 0 : 1;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+/**
+ * @brief
+ * Prints the timings of the repeated runs of a lexer
+ * @param name - Name of the lexer
+ * @param options - Parsed command line options
+ * @param summary - Summary of the timings, in milliseconds
+ * @param input_bytes - Size of the input files
+ * @param tokens - Tokens produced by one run
+ */
+void print_bench(const std::string &name, const utils::Options &options,
+                 const utils::Summary &summary, std::uintmax_t input_bytes,
+                 std::size_t tokens)
+{
+    const double megabytes = static_cast<double>(input_bytes) / (1024 * 1024);
+    const double seconds = summary.mean / 1000.0;
+
+    std::cout << std::fixed << std::setprecision(3)
+              << name << " thread Lexer: " << summary.count << " run(s) after "
+              << options.warmup << " warmup, " << megabytes << " MB, "
+              << tokens << " tokens"
+              << (options.drop_caches ? ", cold cache" : "") << "\n"
+              << "  mean " << summary.mean << " ms, stddev " << summary.stddev
+              << " ms, p50 " << summary.p50 << " ms, p99 " << summary.p99
+              << " ms, min " << summary.min << " ms, max " << summary.max
+              << " ms\n"
+              << "  " << (seconds > 0 ? megabytes / seconds : 0) << " MB/s, "
+              << (seconds > 0 ? static_cast<double>(tokens) / seconds / 1e6 : 0)
+              << " M tokens/s" << std::defaultfloat << std::endl;
+}
+
 /**
  * @brief
  * Gets the filename from the arguments passed to the program
@@ -104,7 +594,7 @@ std::vector<std::filesystem::path> get_filenames(
         if (!std::filesystem::is_regular_file(entry))
             continue;
 
-        if (entry.path().extension() == ".cs")
+        if (language_of(entry.path().string()))
             filenames.push_back(entry.path());
     }
 
@@ -114,5 +604,8 @@ std::vector<std::filesystem::path> get_filenames(
         exit(1);
     }
 
+    // Directory order differs between machines, shards need the same list
+    std::sort(filenames.begin(), filenames.end());
+
     return filenames;
 }
@@ -0,0 +1,639 @@
+/**
+ * @file bundle.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the BundleWriter and BundleReader classes
+ * @version 0.1
+ * @date 2023-06-27
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Project files
+#include "bundle.h"
+#include "../utils/binary.h"
+
+namespace
+{
+    /**
+     * @brief
+     * First bytes of every bundle, the last one is the format version
+     */
+    constexpr std::string_view bundle_magic{"LEXBNDL1", 8};
+
+    /**
+     * @brief
+     * Size of the header: magic, document count, index offset and index
+     * size
+     */
+    constexpr std::uint64_t header_size = 8 + 3 * sizeof(std::uint64_t);
+
+    /**
+     * @brief
+     * Size of an index entry without its name: offset, size and name size
+     */
+    constexpr std::size_t entry_size = 2 * sizeof(std::uint64_t) + sizeof(std::uint32_t);
+
+    /**
+     * @brief
+     * Smallest growth of the file behind the reserved regions, so that
+     * small documents do not resize it one by one
+     */
+    constexpr std::uint64_t growth_step = 4 * 1024 * 1024;
+
+    /**
+     * @brief
+     * Writes a whole buffer at an offset of a file
+     * @param fd File descriptor
+     * @param data Bytes to write
+     * @param offset Offset in the file
+     * @param filename Name of the file, used in the error message
+     * @throw std::runtime_error If the file cannot be written
+     */
+    void write_at(int fd, std::string_view data, std::uint64_t offset,
+                  const std::string &filename)
+    {
+        while (!data.empty())
+        {
+            const auto written = ::pwrite(fd, data.data(), data.size(),
+                                          static_cast<off_t>(offset));
+
+            if (written < 0 && errno == EINTR)
+                continue;
+
+            if (written <= 0)
+                throw std::runtime_error("Cannot write file: " + filename +
+                                         ": " + std::strerror(errno));
+
+            data.remove_prefix(static_cast<std::size_t>(written));
+            offset += static_cast<std::uint64_t>(written);
+        }
+    }
+
+    /**
+     * @brief
+     * Reads bytes at an offset of a file. A single pread serves the whole
+     * request unless it is interrupted or cut short
+     * @param fd File descriptor
+     * @param data Output bytes
+     * @param size Number of bytes to read
+     * @param offset Offset in the file
+     * @return true If every byte was read
+     */
+    bool read_at(int fd, char *data, std::size_t size, std::uint64_t offset)
+    {
+        while (size > 0)
+        {
+            const auto read = ::pread(fd, data, size, static_cast<off_t>(offset));
+
+            if (read < 0 && errno == EINTR)
+                continue;
+
+            if (read <= 0)
+                return false;
+
+            data += read;
+            size -= static_cast<std::size_t>(read);
+            offset += static_cast<std::uint64_t>(read);
+        }
+
+        return true;
+    }
+}
+
+// Region
+/**
+ * @brief
+ * Construct a new Region object mapping a reserved part of a bundle
+ * @param writer Bundle the region belongs to
+ * @param offset Offset of the region in the bundle
+ * @param size Size of the region
+ * @throw std::runtime_error If the region cannot be mapped
+ */
+BundleWriter::Region::Region(BundleWriter &writer, std::uint64_t offset,
+                             std::size_t size)
+    : m_writer(&writer), m_offset(offset), m_size(size)
+{
+    if (size == 0)
+        return;
+
+    const auto page = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+    const auto base = offset - offset % page;
+
+    m_mapping_size = static_cast<std::size_t>(offset + size - base);
+    m_mapping = ::mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, writer.m_fd, static_cast<off_t>(base));
+
+    if (m_mapping == MAP_FAILED)
+    {
+        m_mapping = nullptr;
+        throw std::runtime_error("Cannot map file: " + writer.m_filename +
+                                 ": " + std::strerror(errno));
+    }
+
+    m_data = static_cast<char *>(m_mapping) + (offset - base);
+}
+
+/**
+ * @brief
+ * Construct a new Region taking over another one
+ * @param other Region to take over, left empty
+ */
+BundleWriter::Region::Region(Region &&other) noexcept
+    : m_writer(other.m_writer), m_offset(other.m_offset),
+      m_size(other.m_size), m_mapping(other.m_mapping),
+      m_mapping_size(other.m_mapping_size), m_data(other.m_data)
+{
+    other.m_writer = nullptr;
+    other.m_mapping = nullptr;
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+/**
+ * @brief
+ * Releases this region and takes over another one
+ * @param other Region to take over, left empty
+ * @return Region& This region
+ */
+BundleWriter::Region &BundleWriter::Region::operator=(Region &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        m_writer = other.m_writer;
+        m_offset = other.m_offset;
+        m_size = other.m_size;
+        m_mapping = other.m_mapping;
+        m_mapping_size = other.m_mapping_size;
+        m_data = other.m_data;
+        other.m_writer = nullptr;
+        other.m_mapping = nullptr;
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    return *this;
+}
+
+/**
+ * @brief
+ * Destroy the Region object. A region that was not committed stays out
+ * of the index
+ */
+BundleWriter::Region::~Region()
+{
+    release();
+}
+
+/**
+ * @brief
+ * Gets the first byte of the region
+ * @return char* Writable bytes of the region, nullptr if it is empty
+ */
+char *BundleWriter::Region::data() const noexcept
+{
+    return m_data;
+}
+
+/**
+ * @brief
+ * Gets the size of the region
+ * @return std::size_t Size in bytes
+ */
+std::size_t BundleWriter::Region::size() const noexcept
+{
+    return m_size;
+}
+
+/**
+ * @brief
+ * Unmaps the region and adds it to the index of the bundle
+ * @param name Name the document is served by
+ * @throw std::runtime_error If the region is empty or already committed
+ */
+void BundleWriter::Region::commit(std::string name)
+{
+    if (!m_writer)
+        throw std::runtime_error("Cannot commit an empty bundle region");
+
+    auto *writer = m_writer;
+    const BundleEntry entry{m_offset, m_size};
+
+    release();
+    writer->add(std::move(name), entry);
+}
+
+/**
+ * @brief
+ * Unmaps the region without indexing it
+ */
+void BundleWriter::Region::release() noexcept
+{
+    if (m_mapping)
+        ::munmap(m_mapping, m_mapping_size);
+
+    m_writer = nullptr;
+    m_mapping = nullptr;
+    m_data = nullptr;
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Bundle Writer object. The documents are written to a
+ * temporary file next to the bundle until it is finished
+ * @param filename Bundle to write
+ * @throw std::runtime_error If the temporary file cannot be created
+ */
+BundleWriter::BundleWriter(std::string filename)
+    : m_filename(std::move(filename)), m_temporary_filename(m_filename + ".tmp"),
+      m_end(header_size)
+{
+    m_fd = ::open(m_temporary_filename.c_str(),
+                  O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    if (m_fd < 0)
+        throw std::runtime_error("Cannot open file: " + m_filename + ": " +
+                                 std::strerror(errno));
+}
+
+/**
+ * @brief
+ * Destroy the Bundle Writer object. An unfinished bundle is removed
+ */
+BundleWriter::~BundleWriter()
+{
+    if (m_fd >= 0)
+        ::close(m_fd);
+
+    if (!m_finished)
+    {
+        std::error_code error;
+        std::filesystem::remove(m_temporary_filename, error);
+    }
+}
+
+// Access methods
+/**
+ * @brief
+ * Gets the filename of the bundle
+ * @return const std::string& Bundle the writer publishes
+ */
+const std::string &BundleWriter::get_filename() const noexcept
+{
+    return m_filename;
+}
+
+/**
+ * @brief
+ * Gets the number of documents in the index
+ * @return std::size_t Committed and linked documents
+ */
+std::size_t BundleWriter::get_document_count() const
+{
+    std::lock_guard<std::mutex> lock(m_entries_mutex);
+    return m_entries.size();
+}
+
+// Methods
+/**
+ * @brief
+ * Reserves and maps the region of a document. Can be called from any
+ * thread
+ * @param size Exact size of the document
+ * @return Region Writable region, indexed once committed
+ * @throw std::runtime_error If the file cannot be grown or mapped
+ */
+BundleWriter::Region BundleWriter::reserve(std::size_t size)
+{
+    const auto offset = m_end.fetch_add(size, std::memory_order_relaxed);
+
+    if (offset + size > m_capacity.load(std::memory_order_acquire))
+        grow(offset + size);
+
+    return Region(*this, offset, size);
+}
+
+/**
+ * @brief
+ * Serves a committed document under another name too, without copying
+ * it. Can be called from any thread
+ * @param name New name
+ * @param source Name of a committed document
+ * @return true If the source is in the index
+ */
+bool BundleWriter::link(std::string name, const std::string &source)
+{
+    std::lock_guard<std::mutex> lock(m_entries_mutex);
+    const auto entry = m_entries.find(source);
+
+    if (entry == m_entries.end())
+        return false;
+
+    m_entries.insert_or_assign(std::move(name), entry->second);
+    return true;
+}
+
+/**
+ * @brief
+ * Copies every document of a finished bundle into this one with a single
+ * read, keeping their names. Documents shared by several names stay
+ * shared, and a name already in this bundle is replaced
+ * @param bundle Bundle to copy
+ * @throw std::runtime_error If the bundle cannot be read or this one
+ *        cannot be grown
+ */
+void BundleWriter::append(const BundleReader &bundle)
+{
+    const auto size = static_cast<std::size_t>(bundle.m_data_end - header_size);
+    auto region = reserve(size);
+
+    if (size != 0 && !read_at(bundle.m_fd, region.data(), size, header_size))
+        throw std::runtime_error("Cannot read bundle documents into: " +
+                                 m_filename);
+
+    const auto base = region.m_offset;
+    region.release();
+
+    std::lock_guard<std::mutex> lock(m_entries_mutex);
+
+    for (const auto &[name, entry] : bundle.m_entries)
+        m_entries.insert_or_assign(
+            name, BundleEntry{entry.offset - header_size + base, entry.size});
+}
+
+/**
+ * @brief
+ * Writes the index and the header, and moves the bundle over its target.
+ * Every region must be committed or released first
+ * @throw std::runtime_error If the bundle cannot be written or renamed
+ */
+void BundleWriter::finish()
+{
+    if (m_finished)
+        throw std::runtime_error("Bundle already finished: " + m_filename);
+
+    std::vector<std::pair<std::string, BundleEntry>> entries;
+
+    {
+        std::lock_guard<std::mutex> lock(m_entries_mutex);
+        entries.assign(m_entries.begin(), m_entries.end());
+    }
+
+    // Sorted so that equal runs produce equal bundles
+    std::sort(entries.begin(), entries.end(),
+              [](const auto &lhs, const auto &rhs)
+              { return lhs.first < rhs.first; });
+
+    std::string index;
+
+    for (const auto &[name, entry] : entries)
+    {
+        utils::append_integer(index, entry.offset);
+        utils::append_integer(index, entry.size);
+        utils::append_integer(index, static_cast<std::uint32_t>(name.size()));
+        index += name;
+    }
+
+    const auto index_offset = m_end.load(std::memory_order_relaxed);
+    std::string header{bundle_magic};
+
+    utils::append_integer(header, static_cast<std::uint64_t>(entries.size()));
+    utils::append_integer(header, index_offset);
+    utils::append_integer(header, static_cast<std::uint64_t>(index.size()));
+
+    write_at(m_fd, index, index_offset, m_filename);
+
+    if (::ftruncate(m_fd, static_cast<off_t>(index_offset + index.size())) != 0)
+        throw std::runtime_error("Cannot resize file: " + m_filename + ": " +
+                                 std::strerror(errno));
+
+    // The header goes last, a bundle without it is never read
+    write_at(m_fd, header, 0, m_filename);
+
+    ::close(m_fd);
+    m_fd = -1;
+
+    std::filesystem::rename(m_temporary_filename, m_filename);
+    m_finished = true;
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Grows the file so that it holds a reserved region. The file grows by
+ * half its size at least, so workers seldom take the lock
+ * @param end End of the reserved region
+ * @throw std::runtime_error If the file cannot be resized
+ */
+void BundleWriter::grow(std::uint64_t end)
+{
+    std::lock_guard<std::mutex> lock(m_grow_mutex);
+    const auto capacity = m_capacity.load(std::memory_order_relaxed);
+
+    if (end <= capacity)
+        return;
+
+    const auto target = std::max({end, capacity + capacity / 2,
+                                  capacity + growth_step});
+
+    if (::ftruncate(m_fd, static_cast<off_t>(target)) != 0)
+        throw std::runtime_error("Cannot resize file: " + m_filename + ": " +
+                                 std::strerror(errno));
+
+    m_capacity.store(target, std::memory_order_release);
+}
+
+/**
+ * @brief
+ * Adds a document to the index. A name committed twice keeps the last
+ * document
+ * @param name Name of the document
+ * @param entry Location of the document
+ */
+void BundleWriter::add(std::string name, BundleEntry entry)
+{
+    std::lock_guard<std::mutex> lock(m_entries_mutex);
+    m_entries.insert_or_assign(std::move(name), entry);
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Bundle Reader object and loads the index of a bundle
+ * @param filename Bundle to read
+ * @throw std::runtime_error If the file cannot be read or is not a
+ *        finished bundle
+ */
+BundleReader::BundleReader(const std::string &filename)
+{
+    m_fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (m_fd < 0)
+        throw std::runtime_error("Cannot open file: " + filename + ": " +
+                                 std::strerror(errno));
+
+    try
+    {
+        struct stat status
+        {
+        };
+
+        if (::fstat(m_fd, &status) != 0)
+            throw std::runtime_error("Cannot read file: " + filename);
+
+        const auto file_size = static_cast<std::uint64_t>(status.st_size);
+        char header[header_size];
+
+        if (file_size < header_size || !read_at(m_fd, header, header_size, 0) ||
+            std::string_view(header, bundle_magic.size()) != bundle_magic)
+            throw std::runtime_error("Not a bundle: " + filename);
+
+        const auto count = utils::load_integer<std::uint64_t>(header + 8);
+        const auto index_offset = utils::load_integer<std::uint64_t>(header + 16);
+        const auto index_size = utils::load_integer<std::uint64_t>(header + 24);
+
+        if (index_offset < header_size || index_offset > file_size ||
+            index_size > file_size - index_offset)
+            throw std::runtime_error("Corrupt bundle index: " + filename);
+
+        m_data_end = index_offset;
+        std::string index(index_size, '\0');
+
+        if (!read_at(m_fd, index.data(), index.size(), index_offset))
+            throw std::runtime_error("Cannot read file: " + filename);
+
+        std::size_t position{};
+        m_entries.reserve(count);
+
+        for (std::uint64_t i{}; i < count; ++i)
+        {
+            if (index.size() - position < entry_size)
+                throw std::runtime_error("Corrupt bundle index: " + filename);
+
+            const BundleEntry entry{utils::load_integer<std::uint64_t>(index.data() + position),
+                                    utils::load_integer<std::uint64_t>(index.data() + position + 8)};
+            const auto name_size = utils::load_integer<std::uint32_t>(index.data() + position + 16);
+            position += entry_size;
+
+            if (index.size() - position < name_size ||
+                entry.offset < header_size || entry.offset > index_offset ||
+                entry.size > index_offset - entry.offset)
+                throw std::runtime_error("Corrupt bundle index: " + filename);
+
+            m_entries.insert_or_assign(index.substr(position, name_size), entry);
+            position += name_size;
+        }
+    }
+    catch (...)
+    {
+        ::close(m_fd);
+        throw;
+    }
+}
+
+/**
+ * @brief
+ * Destroy the Bundle Reader object
+ */
+BundleReader::~BundleReader()
+{
+    if (m_fd >= 0)
+        ::close(m_fd);
+}
+
+// Access methods
+/**
+ * @brief
+ * Gets the number of documents of the bundle
+ * @return std::size_t Number of names in the index
+ */
+std::size_t BundleReader::size() const noexcept
+{
+    return m_entries.size();
+}
+
+/**
+ * @brief
+ * Checks whether the bundle has a document
+ * @param name Name of the document
+ * @return true If the name is in the index
+ */
+bool BundleReader::contains(std::string_view name) const
+{
+    return m_entries.count(std::string(name)) != 0;
+}
+
+/**
+ * @brief
+ * Gets the location of a document
+ * @param name Name of the document
+ * @return std::optional<BundleEntry> Offset and size, none if the name
+ *         is not in the index
+ */
+std::optional<BundleEntry> BundleReader::find(std::string_view name) const
+{
+    const auto entry = m_entries.find(std::string(name));
+
+    if (entry == m_entries.end())
+        return std::nullopt;
+
+    return entry->second;
+}
+
+/**
+ * @brief
+ * Gets the names of the documents of the bundle
+ * @return std::vector<std::string> Names, sorted
+ */
+std::vector<std::string> BundleReader::get_names() const
+{
+    std::vector<std::string> names;
+    names.reserve(m_entries.size());
+
+    for (const auto &[name, entry] : m_entries)
+        names.push_back(name);
+
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// Methods
+/**
+ * @brief
+ * Reads a document with a single pread. Can be called from any thread
+ * @param name Name of the document
+ * @return std::optional<std::string> Contents, none if the name is not
+ *         in the index
+ * @throw std::runtime_error If the bundle cannot be read
+ */
+std::optional<std::string> BundleReader::read(std::string_view name) const
+{
+    const auto entry = find(name);
+
+    if (!entry)
+        return std::nullopt;
+
+    std::string contents(entry->size, '\0');
+
+    if (!read_at(m_fd, contents.data(), contents.size(), entry->offset))
+        throw std::runtime_error("Cannot read bundle document: " +
+                                 std::string(name));
+
+    return contents;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file bundle.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the BundleWriter and BundleReader classes
+ * @version 0.1
+ * @date 2023-06-27
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef BUNDLE_H
+#define BUNDLE_H
+
+// C++ Standard Libraries
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class BundleReader;
+
+/**
+ * @brief
+ * Location of a document inside a bundle
+ * @struct BundleEntry
+ */
+struct BundleEntry
+{
+    std::uint64_t offset{0};
+    std::uint64_t size{0};
+};
+
+/**
+ * @class BundleWriter
+ * @brief Writes many documents into a single file with an offset index
+ * @details
+ * A bundle is a header, the documents one after the other and an index
+ * of their names, offsets and sizes. Every integer is stored in the byte
+ * order of the host. Workers reserve a region of the exact size of their
+ * document, which only moves an atomic end offset, and render into it
+ * through their own mapping, so they never wait for each other. Only
+ * committed regions are indexed; the index is written by finish(), which
+ * then moves the bundle over its target, so an interrupted run leaves no
+ * partial bundle behind.
+ */
+class BundleWriter
+{
+public:
+    /**
+     * @class Region
+     * @brief Mapped region of a bundle reserved for one document
+     */
+    class Region
+    {
+    public:
+        // Constructor
+        Region() = default;
+        Region(Region &&) noexcept;
+        Region &operator=(Region &&) noexcept;
+
+        Region(const Region &) = delete;
+        Region &operator=(const Region &) = delete;
+
+        // Destructor
+        ~Region();
+
+        // Access methods
+        char *data() const noexcept;
+        std::size_t size() const noexcept;
+
+        // Methods
+        void commit(std::string);
+        void release() noexcept;
+
+    private:
+        friend class BundleWriter;
+        Region(BundleWriter &, std::uint64_t, std::size_t);
+
+        BundleWriter *m_writer{nullptr};
+        std::uint64_t m_offset{0};
+        std::size_t m_size{0};
+
+        // Mappings start at a page boundary at or before the offset
+        void *m_mapping{nullptr};
+        std::size_t m_mapping_size{0};
+        char *m_data{nullptr};
+    };
+
+    // Constructor
+    explicit BundleWriter(std::string);
+
+    BundleWriter(const BundleWriter &) = delete;
+    BundleWriter &operator=(const BundleWriter &) = delete;
+
+    // Destructor
+    ~BundleWriter();
+
+    // Access methods
+    const std::string &get_filename() const noexcept;
+    std::size_t get_document_count() const;
+
+    // Methods
+    Region reserve(std::size_t);
+    bool link(std::string, const std::string &);
+    void append(const BundleReader &);
+    void finish();
+
+private:
+    std::string m_filename;
+    std::string m_temporary_filename;
+    int m_fd{-1};
+
+    // End of the reserved regions, and size of the file behind them
+    std::atomic<std::uint64_t> m_end;
+    std::atomic<std::uint64_t> m_capacity{0};
+    std::mutex m_grow_mutex;
+
+    // Committed documents, by name
+    std::unordered_map<std::string, BundleEntry> m_entries;
+    mutable std::mutex m_entries_mutex;
+
+    bool m_finished{false};
+
+    void grow(std::uint64_t);
+    void add(std::string, BundleEntry);
+};
+
+/**
+ * @class BundleReader
+ * @brief Serves the documents of a finished bundle
+ * @details
+ * The index is loaded once when the bundle is opened. Every document is
+ * then served with a single pread at its offset, so readers on several
+ * threads never share a file position.
+ */
+class BundleReader
+{
+public:
+    // Constructor
+    explicit BundleReader(const std::string &);
+
+    BundleReader(const BundleReader &) = delete;
+    BundleReader &operator=(const BundleReader &) = delete;
+
+    // Destructor
+    ~BundleReader();
+
+    // Access methods
+    std::size_t size() const noexcept;
+    bool contains(std::string_view) const;
+    std::optional<BundleEntry> find(std::string_view) const;
+    std::vector<std::string> get_names() const;
+
+    // Methods
+    std::optional<std::string> read(std::string_view) const;
+
+private:
+    friend class BundleWriter;
+
+    int m_fd{-1};
+    std::unordered_map<std::string, BundleEntry> m_entries;
+
+    // End of the documents, where the index starts
+    std::uint64_t m_data_end{0};
+};
+
+#endif //! BUNDLE_H
@@ -0,0 +1,143 @@
+/**
+ * @file request_reader.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the RequestReader class
+ * @version 0.1
+ * @date 2023-06-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard libraries
+#include <sstream>
+
+// Project files
+#include "request_reader.h"
+
+// Access methods
+/**
+ * @brief
+ * Gets the number of bytes received and not returned as requests yet
+ * @return std::size_t Number of bytes
+ */
+std::size_t RequestReader::buffered() const noexcept
+{
+    return m_buffer.size() - m_offset;
+}
+
+// Methods
+/**
+ * @brief
+ * Appends bytes received from the client
+ * @param data Bytes received
+ * @param size Number of bytes
+ */
+void RequestReader::append(const char *data, std::size_t size)
+{
+    m_buffer.append(data, size);
+}
+
+/**
+ * @brief
+ * Returns the next request once it is fully buffered
+ * @return std::optional<Request> Request, if one is complete
+ */
+std::optional<Request> RequestReader::next()
+{
+    if (m_failed)
+        return std::nullopt;
+
+    const auto newline = m_buffer.find('\n', m_offset);
+
+    if (newline == std::string::npos)
+    {
+        if (buffered() <= max_header_size)
+            return std::nullopt;
+
+        m_failed = true;
+
+        Request request;
+        request.error = "Header too long";
+        request.close = true;
+        return request;
+    }
+
+    std::istringstream fields(m_buffer.substr(m_offset, newline - m_offset));
+    Request request;
+    std::string argument;
+    fields >> request.format >> request.kind;
+    std::getline(fields >> std::ws, argument);
+
+    if (request.kind == "FILE")
+    {
+        request.payload = std::move(argument);
+        consume(newline + 1);
+        return request;
+    }
+
+    if (request.kind != "SOURCE")
+    {
+        request.error = "Unknown request: " + request.kind;
+        consume(newline + 1);
+        return request;
+    }
+
+    std::size_t size{};
+
+    try
+    {
+        std::size_t end{};
+        size = std::stoull(argument, &end);
+
+        if (end != argument.size() || argument[0] == '-')
+            throw std::invalid_argument(argument);
+    }
+    catch (const std::exception &)
+    {
+        // The payload cannot be skipped without its length
+        m_failed = true;
+        request.error = "Invalid source length: " + argument;
+        request.close = true;
+        return request;
+    }
+
+    if (size > max_source_size)
+    {
+        m_failed = true;
+        request.error = "Source too large";
+        request.close = true;
+        return request;
+    }
+
+    if (m_buffer.size() - (newline + 1) < size)
+        return std::nullopt;
+
+    request.payload = m_buffer.substr(newline + 1, size);
+    consume(newline + 1 + size);
+    return request;
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Drops the bytes of the requests already returned, compacting the
+ * buffer once they make up most of it
+ * @param end Offset just past the last returned request
+ */
+void RequestReader::consume(std::size_t end)
+{
+    m_offset = end;
+
+    if (m_offset == m_buffer.size())
+    {
+        m_buffer.clear();
+        m_offset = 0;
+    }
+    else if (m_offset > m_buffer.size() / 2)
+    {
+        m_buffer.erase(0, m_offset);
+        m_offset = 0;
+    }
+}
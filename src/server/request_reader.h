@@ -0,0 +1,82 @@
+/**
+ * @file request_reader.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the RequestReader class
+ * @version 0.1
+ * @date 2023-06-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef REQUEST_READER_H
+#define REQUEST_READER_H
+
+// C++ standard libraries
+#include <cstddef>
+#include <optional>
+#include <string>
+
+/**
+ * @brief
+ * Request of a client of the daemon
+ * @struct Request
+ */
+struct Request
+{
+    std::string format;
+    std::string kind;
+
+    // File path or inline source
+    std::string payload;
+
+    // Set when the request is malformed, and answered with it
+    std::string error;
+
+    // Whether the connection cannot be read any further after it
+    bool close{false};
+};
+
+/**
+ * @class RequestReader
+ * @brief Splits the bytes received from a client into requests
+ * @details
+ * Bytes are appended as they arrive, and a request is only returned once
+ * its header line and its whole payload are buffered, so the daemon never
+ * blocks on a slow or idle client. A malformed header is returned as a
+ * request with an error; when the length of what follows it is unknown,
+ * the request also closes the connection.
+ */
+class RequestReader
+{
+public:
+    /**
+     * @brief
+     * Largest inline source accepted in a single request
+     */
+    static constexpr std::size_t max_source_size = 64 * 1024 * 1024;
+
+    /**
+     * @brief
+     * Longest header line accepted
+     */
+    static constexpr std::size_t max_header_size = 64 * 1024;
+
+    // Access methods
+    std::size_t buffered() const noexcept;
+
+    // Methods
+    void append(const char *, std::size_t);
+    std::optional<Request> next();
+
+private:
+    std::string m_buffer;
+    std::size_t m_offset{0};
+    bool m_failed{false};
+
+    // Methods (Private)
+    void consume(std::size_t);
+};
+
+#endif //! REQUEST_READER_H
@@ -0,0 +1,491 @@
+/**
+ * @file server.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the Server class
+ * @version 0.1
+ * @date 2023-06-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard libraries
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <stdexcept>
+
+// POSIX
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Project files
+#include "server.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Interval at which the polling thread checks for a stop request
+     */
+    constexpr int poll_interval_ms = 200;
+
+    /**
+     * @brief
+     * Writes a whole response to a connected socket
+     * @param fd Connected socket
+     * @param data Bytes to write
+     * @return true If every byte was written
+     */
+    bool send_all(int fd, const std::string_view &data)
+    {
+        std::size_t written{};
+
+        while (written < data.size())
+        {
+            const auto result = ::send(fd, data.data() + written,
+                                       data.size() - written, MSG_NOSIGNAL);
+
+            if (result < 0 && errno == EINTR)
+                continue;
+
+            if (result <= 0)
+                return false;
+
+            written += static_cast<std::size_t>(result);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief
+     * Parses the output format of a request
+     * @param format Format name
+     * @return OutputFormat Parsed format
+     * @throw std::runtime_error If the format is unknown
+     */
+    OutputFormat parse_format(const std::string &format)
+    {
+        if (format == "html")
+            return OutputFormat::Html;
+
+        if (format == "tokens")
+            return OutputFormat::Tokens;
+
+        throw std::runtime_error("Unknown format: " + format);
+    }
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Server:: Server object
+ * @param lexer Lexer used to serve the requests
+ * @param socket_path Path of the Unix domain socket
+ * @param num_threads Number of worker threads
+ * @param cache_capacity Number of results kept in the LRU cache
+ * @param cache_bytes Total size of the results kept in the LRU cache
+ * @param pin_threads Whether each worker is pinned to its own CPU
+ * @throw std::runtime_error If the wake up pipe cannot be created
+ */
+Server::Server(Lexer &lexer, std::string socket_path,
+               std::size_t num_threads, std::size_t cache_capacity,
+               std::size_t cache_bytes, bool pin_threads)
+    : m_lexer(lexer),
+      m_socket_path(std::move(socket_path)),
+      m_socket_fd(-1),
+      m_stopping(false),
+      m_wake_fds{-1, -1},
+      m_cache(cache_capacity, cache_bytes),
+      m_pool(num_threads, pin_threads)
+{
+    if (::pipe2(m_wake_fds, O_CLOEXEC | O_NONBLOCK) != 0)
+        throw std::runtime_error(std::string("Cannot create pipe: ") +
+                                 std::strerror(errno));
+}
+
+// Destructor
+/**
+ * @brief
+ * Destroy the Server:: Server object
+ */
+Server::~Server()
+{
+    if (m_socket_fd >= 0)
+    {
+        ::close(m_socket_fd);
+        ::unlink(m_socket_path.c_str());
+    }
+
+    ::close(m_wake_fds[0]);
+    ::close(m_wake_fds[1]);
+}
+
+// Methods (Public)
+/**
+ * @brief
+ * Binds the socket and serves requests until stop() is called
+ * @throw std::runtime_error If the socket cannot be created
+ */
+void Server::run()
+{
+    open_socket();
+
+    // Build the static lexer tables before the first client arrives
+    m_lexer.highlight("using System;");
+
+    std::vector<pollfd> fds;
+
+    while (!m_stopping)
+    {
+        // Connections with a request in flight are not read meanwhile
+        fds.assign({{m_wake_fds[0], POLLIN, 0}, {m_socket_fd, POLLIN, 0}});
+
+        for (const auto &[client_fd, client] : m_clients)
+        {
+            if (!client.busy && !client.ended)
+                fds.push_back({client_fd, POLLIN, 0});
+        }
+
+        const auto ready = ::poll(fds.data(), fds.size(), poll_interval_ms);
+
+        if (ready < 0 && errno != EINTR)
+            throw std::runtime_error(std::string("poll failed: ") +
+                                     std::strerror(errno));
+
+        if (ready <= 0)
+            continue;
+
+        if (fds[0].revents != 0)
+            collect_served();
+
+        if (fds[1].revents != 0)
+            accept_client();
+
+        for (std::size_t i{2}; i < fds.size(); ++i)
+        {
+            if (fds[i].revents != 0)
+                read_client(fds[i].fd);
+        }
+    }
+
+    // Workers blocked writing to a client give up once it is shut down
+    for (const auto &[client_fd, client] : m_clients)
+        ::shutdown(client_fd, SHUT_RDWR);
+
+    m_pool.wait_idle();
+
+    for (const auto &[client_fd, client] : m_clients)
+        ::close(client_fd);
+
+    m_clients.clear();
+    m_served.clear();
+}
+
+/**
+ * @brief
+ * Requests the polling loop to finish, whether it has started yet or
+ * not. Safe to call from a signal handler
+ */
+void Server::stop() noexcept
+{
+    m_stopping = true;
+    wake();
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Creates, binds and listens on the Unix domain socket
+ * @throw std::runtime_error If the socket cannot be created
+ */
+void Server::open_socket()
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (m_socket_path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("Socket path too long: " + m_socket_path);
+
+    std::strncpy(address.sun_path, m_socket_path.c_str(),
+                 sizeof(address.sun_path) - 1);
+
+    // Remove a stale socket left behind by a previous daemon
+    struct stat info{};
+
+    if (::stat(m_socket_path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+        ::unlink(m_socket_path.c_str());
+
+    m_socket_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (m_socket_fd < 0)
+        throw std::runtime_error(std::string("Cannot create socket: ") +
+                                 std::strerror(errno));
+
+    if (::bind(m_socket_fd, reinterpret_cast<sockaddr *>(&address),
+               sizeof(address)) < 0 ||
+        ::listen(m_socket_fd, SOMAXCONN) < 0)
+    {
+        const std::string error = std::strerror(errno);
+
+        ::close(m_socket_fd);
+        m_socket_fd = -1;
+
+        throw std::runtime_error("Cannot listen on " + m_socket_path +
+                                 ": " + error);
+    }
+}
+
+/**
+ * @brief
+ * Accepts a pending connection
+ */
+void Server::accept_client()
+{
+    const int client_fd = ::accept4(m_socket_fd, nullptr, nullptr, SOCK_CLOEXEC);
+
+    if (client_fd >= 0)
+        m_clients.emplace(client_fd, Client{});
+}
+
+/**
+ * @brief
+ * Reads what a client sent and serves its next request once it is
+ * complete. The client is closed once it has sent everything and every
+ * request was served
+ * @param client_fd Connected socket
+ */
+void Server::read_client(int client_fd)
+{
+    auto &client = m_clients.at(client_fd);
+    char chunk[64 * 1024];
+
+    const auto result = ::recv(client_fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+
+    if (result < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+        return;
+
+    if (result > 0)
+        client.reader.append(chunk, static_cast<std::size_t>(result));
+    else
+        client.ended = true;
+
+    dispatch(client_fd);
+}
+
+/**
+ * @brief
+ * Hands the next complete request of an idle client to the pool, or
+ * closes the client if it ended and nothing is left to serve
+ * @param client_fd Connected socket
+ */
+void Server::dispatch(int client_fd)
+{
+    auto &client = m_clients.at(client_fd);
+
+    if (client.busy)
+        return;
+
+    auto request = client.reader.next();
+
+    if (!request)
+    {
+        if (client.ended)
+            close_client(client_fd);
+
+        return;
+    }
+
+    client.busy = true;
+
+    try
+    {
+        m_pool.enqueue([this, client_fd, request = std::move(*request)]()
+                       { serve(client_fd, request); });
+    }
+    catch (const std::exception &)
+    {
+        close_client(client_fd);
+    }
+}
+
+/**
+ * @brief
+ * Closes a client connection
+ * @param client_fd Connected socket
+ */
+void Server::close_client(int client_fd)
+{
+    m_clients.erase(client_fd);
+    ::close(client_fd);
+}
+
+/**
+ * @brief
+ * Takes back the connections whose request was served, then serves
+ * their next request or closes them
+ */
+void Server::collect_served()
+{
+    char drain[64];
+
+    while (::read(m_wake_fds[0], drain, sizeof(drain)) > 0)
+    {
+    }
+
+    std::vector<std::pair<int, bool>> served;
+
+    {
+        std::lock_guard<std::mutex> lock(m_served_mutex);
+        served.swap(m_served);
+    }
+
+    for (const auto &[client_fd, keep] : served)
+    {
+        m_clients.at(client_fd).busy = false;
+
+        if (keep)
+            dispatch(client_fd);
+        else
+            close_client(client_fd);
+    }
+}
+
+/**
+ * @brief
+ * Serves one request on a worker and writes its response
+ * @param client_fd Connected socket
+ * @param request Complete request
+ */
+void Server::serve(int client_fd, const Request &request)
+{
+    std::string response;
+
+    if (!request.error.empty())
+        response = "ERR " + request.error + "\n";
+    else
+    {
+        try
+        {
+            const auto body = process(request.format, request.kind,
+                                      request.payload);
+            response = "OK " + std::to_string(body.size()) + "\n" + body;
+        }
+        catch (const std::exception &e)
+        {
+            response = std::string("ERR ") + e.what() + "\n";
+        }
+    }
+
+    const bool sent = send_all(client_fd, response);
+
+    {
+        std::lock_guard<std::mutex> lock(m_served_mutex);
+        m_served.emplace_back(client_fd, sent && !request.close);
+    }
+
+    wake();
+}
+
+/**
+ * @brief
+ * Wakes the polling thread. Safe to call from a signal handler
+ */
+void Server::wake() noexcept
+{
+    const char byte = 1;
+
+    // A full pipe already holds a wake up
+    [[maybe_unused]] const auto result = ::write(m_wake_fds[1], &byte, 1);
+}
+
+/**
+ * @brief
+ * Renders a request, going through the result cache
+ * @param format Output format name
+ * @param kind Request kind, FILE or SOURCE
+ * @param payload File path or inline source
+ * @return std::string Rendered output
+ * @throw std::runtime_error If the request cannot be served
+ */
+std::string Server::process(const std::string &format,
+                            const std::string &kind,
+                            const std::string &payload)
+{
+    const auto output_format = parse_format(format);
+    std::string key;
+    std::string source;
+
+    if (kind == "FILE")
+    {
+        // Modification time and size invalidate entries of edited files
+        std::error_code error;
+        const auto size = std::filesystem::file_size(payload, error);
+        const auto time = std::filesystem::last_write_time(payload, error);
+
+        if (error)
+            throw std::runtime_error("Cannot open file: " + payload);
+
+        key = format + ":F:" + payload + ":" + std::to_string(size) + ":" +
+              std::to_string(time.time_since_epoch().count());
+    }
+    else
+    {
+        // Sources with the same hash share a key, the source tells them apart
+        key = format + ":S:" + std::to_string(payload.size()) + ":" +
+              std::to_string(std::hash<std::string>{}(payload));
+        source = payload;
+    }
+
+    if (auto cached = cache_get(key, source))
+        return std::move(*cached);
+
+    auto result = kind == "FILE"
+                      ? m_lexer.highlight_file(payload, output_format)
+                      : m_lexer.highlight(payload, output_format);
+
+    cache_put(key, {std::move(source), result});
+    return result;
+}
+
+/**
+ * @brief
+ * Looks up a rendered result in the cache
+ * @param key Cache key
+ * @param source Source the result must have been rendered from, empty
+ *        for files
+ * @return std::optional<std::string> Cached result, if present
+ */
+std::optional<std::string> Server::cache_get(const std::string &key,
+                                             const std::string &source)
+{
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    auto cached = m_cache.get(key);
+
+    if (!cached || cached->source != source)
+        return std::nullopt;
+
+    return std::move(cached->output);
+}
+
+/**
+ * @brief
+ * Stores a rendered result in the cache, counting its size and the size
+ * of its source against the byte bound of the cache
+ * @param key Cache key
+ * @param result Rendered result
+ */
+void Server::cache_put(const std::string &key, CachedResult result)
+{
+    const auto size = key.size() + result.source.size() + result.output.size();
+
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    m_cache.put(key, std::move(result), size);
+}
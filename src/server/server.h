@@ -0,0 +1,138 @@
+/**
+ * @file server.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the Server class
+ * @version 0.1
+ * @date 2023-06-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+// C++ standard libraries
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Project files
+#include "../lexer/lexer.h"
+#include "../threads/thread_pool.h"
+#include "../utils/lru_cache.h"
+#include "request_reader.h"
+
+/**
+ * @brief
+ * Highlight daemon listening on a Unix domain socket
+ * @class Server
+ * @details
+ * Keeps a warm lexer, thread pool and result cache between requests so
+ * that clients only pay for the lexing itself. Every request is a single
+ * header line followed by an optional payload:
+ *
+ *     <format> FILE <path>\n
+ *     <format> SOURCE <length>\n<length bytes of source>
+ *
+ * where format is either "html" or "tokens". Each response is either
+ * "OK <length>\n" followed by the rendered output, or "ERR <message>\n".
+ * A connection can carry any number of requests until the client closes it.
+ *
+ * One thread polls the listening socket and every idle connection, and
+ * only a request that is fully received is handed to the thread pool, so
+ * clients that stay connected without sending anything hold no worker.
+ * The requests of a connection are served one at a time, in order.
+ */
+class Server
+{
+public:
+    // Constructor
+    Server(Lexer &, std::string socket_path, std::size_t num_threads,
+           std::size_t cache_capacity, std::size_t cache_bytes,
+           bool pin_threads = false);
+
+    // Destructor
+    ~Server();
+
+    Server(const Server &) = delete;
+    Server &operator=(const Server &) = delete;
+
+    // Methods
+    void run();
+    void stop() noexcept;
+
+private:
+    /**
+     * @brief
+     * Connection of a client, owned by the polling thread
+     * @struct Client
+     */
+    struct Client
+    {
+        RequestReader reader;
+
+        // Whether a worker is serving one of its requests
+        bool busy{false};
+
+        // Whether the client sent everything it will send
+        bool ended{false};
+    };
+
+    /**
+     * @brief
+     * Rendered result, with the source it was rendered from when the
+     * request carried one, compared on every hit
+     * @struct CachedResult
+     */
+    struct CachedResult
+    {
+        std::string source;
+        std::string output;
+    };
+
+    Lexer &m_lexer;
+    std::string m_socket_path;
+    int m_socket_fd;
+
+    // Set once by stop(), before or during run()
+    std::atomic<bool> m_stopping;
+
+    // Pipe that wakes the polling thread
+    int m_wake_fds[2];
+
+    utils::LruCache<std::string, CachedResult> m_cache;
+    std::mutex m_cache_mutex;
+
+    std::unordered_map<int, Client> m_clients;
+
+    // Connections whose request was served, and whether to keep them
+    std::vector<std::pair<int, bool>> m_served;
+    std::mutex m_served_mutex;
+
+    // Declared last so the workers are joined before the cache goes away
+    ThreadPool m_pool;
+
+    // Methods
+    void open_socket();
+    void accept_client();
+    void read_client(int);
+    void dispatch(int);
+    void close_client(int);
+    void collect_served();
+    void serve(int, const Request &);
+    void wake() noexcept;
+    std::string process(const std::string &format,
+                        const std::string &kind,
+                        const std::string &payload);
+    std::optional<std::string> cache_get(const std::string &,
+                                         const std::string &);
+    void cache_put(const std::string &, CachedResult);
+};
+
+#endif //! SERVER_H
@@ -0,0 +1,451 @@
+/**
+ * @file shard.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the sharding of runs over several processes
+ * @version 0.1
+ * @date 2023-06-28
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_set>
+
+// Project files
+#include "shard.h"
+#include "../output/bundle.h"
+#include "../stats/token_stats.h"
+#include "../utils/json.h"
+#include "../utils/utils.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Fixed cost of a file in bytes of source when balancing by size, so
+     * that many small files are spread too
+     */
+    constexpr std::uintmax_t file_cost = 4096;
+
+    /**
+     * @brief
+     * Parses a shard number
+     * @param value Text to parse
+     * @param shard Whole --shard value, used in the error message
+     * @return std::size_t Parsed number
+     * @throw std::invalid_argument If the text is not a number
+     */
+    std::size_t parse_number(std::string_view value, std::string_view shard)
+    {
+        std::size_t number{};
+        const auto *end = value.data() + value.size();
+        const auto [position, error] = std::from_chars(value.data(), end, number);
+
+        if (value.empty() || error != std::errc{} || position != end)
+            throw std::invalid_argument("Invalid value for --shard: " +
+                                        std::string(shard));
+
+        return number;
+    }
+
+    /**
+     * @brief
+     * Reads the output of a file from an output directory into a region
+     * of a bundle
+     * @param bundle Bundle to write to
+     * @param directory Output directory of a shard
+     * @param name Output name of the file
+     * @return true If the output exists and was copied
+     * @throw std::runtime_error If the output cannot be read
+     */
+    bool copy_output(BundleWriter &bundle, const std::string &directory,
+                     const std::string &name)
+    {
+        const auto path = std::filesystem::path(directory) / name;
+        std::error_code error;
+        const auto size = std::filesystem::file_size(path, error);
+
+        // Outputs of files that could not be read, or were dropped
+        if (error)
+            return false;
+
+        std::ifstream input(path, std::ios::binary);
+        auto region = bundle.reserve(static_cast<std::size_t>(size));
+
+        if (!input.read(region.data(), static_cast<std::streamsize>(size)))
+            throw std::runtime_error("Cannot read file: " + path.string());
+
+        region.commit(name);
+        return true;
+    }
+}
+
+/**
+ * @brief
+ * Gets the name of a strategy, as given to --shard-by
+ * @param strategy Strategy
+ * @return std::string_view Name of the strategy
+ */
+std::string_view to_string(ShardStrategy strategy)
+{
+    return strategy == ShardStrategy::Size ? "size" : "hash";
+}
+
+/**
+ * @brief
+ * Parses the value of the --shard-by option
+ * @param value Value to parse
+ * @return ShardStrategy Selected strategy
+ * @throw std::invalid_argument If the value is not a strategy
+ */
+ShardStrategy parse_shard_strategy(std::string_view value)
+{
+    if (value == "hash")
+        return ShardStrategy::Hash;
+
+    if (value == "size")
+        return ShardStrategy::Size;
+
+    throw std::invalid_argument("Invalid value for --shard-by: " +
+                                std::string(value));
+}
+
+/**
+ * @brief
+ * Parses the value of the --shard option, as in 1/4 for the second of
+ * four shards
+ * @param value Value to parse
+ * @return ShardSpec Shard, with the default strategy
+ * @throw std::invalid_argument If the value is not a shard
+ */
+ShardSpec parse_shard(std::string_view value)
+{
+    const auto slash = value.find('/');
+
+    if (slash == std::string_view::npos)
+        throw std::invalid_argument("Invalid value for --shard: " +
+                                    std::string(value));
+
+    ShardSpec shard;
+    shard.index = parse_number(value.substr(0, slash), value);
+    shard.count = parse_number(value.substr(slash + 1), value);
+
+    if (shard.count == 0 || shard.index >= shard.count)
+        throw std::invalid_argument("Invalid value for --shard: " +
+                                    std::string(value) +
+                                    ", expected i/N with 0 <= i < N");
+
+    return shard;
+}
+
+/**
+ * @brief
+ * Picks the files of one shard. Every shard of a run sees the same file
+ * list, so the shards are disjoint and cover the corpus without talking
+ * to each other
+ * @param keys Name of every file, without the directory, so that the
+ *        machines agree whatever their paths
+ * @param sizes Size of every file
+ * @param shard Shard to pick
+ * @return std::vector<std::size_t> Indices of the files of the shard, in
+ *         their order in the list
+ */
+std::vector<std::size_t> select_shard(std::span<const std::string> keys,
+                                      std::span<const std::uintmax_t> sizes,
+                                      const ShardSpec &shard)
+{
+    std::vector<std::size_t> selected;
+
+    if (shard.strategy == ShardStrategy::Hash)
+    {
+        for (std::size_t i{}; i < keys.size(); ++i)
+            if (utils::hash_bytes(keys[i]) % shard.count == shard.index)
+                selected.push_back(i);
+
+        return selected;
+    }
+
+    // Largest first, ties by name, so that every shard deals the same way
+    std::vector<std::size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs)
+              { return sizes[lhs] != sizes[rhs] ? sizes[lhs] > sizes[rhs]
+                                                : keys[lhs] < keys[rhs]; });
+
+    std::vector<std::uintmax_t> loads(shard.count);
+
+    for (const auto index : order)
+    {
+        const auto lightest = static_cast<std::size_t>(
+            std::min_element(loads.begin(), loads.end()) - loads.begin());
+
+        loads[lightest] += sizes[index] + file_cost;
+
+        if (lightest == shard.index)
+            selected.push_back(index);
+    }
+
+    std::sort(selected.begin(), selected.end());
+    return selected;
+}
+
+// ShardManifest
+/**
+ * @brief
+ * Writes the manifest as a JSON document
+ * @return std::string JSON document
+ */
+std::string ShardManifest::to_json() const
+{
+    std::string output = "{\n\"shard\": " + std::to_string(shard) +
+                         ",\n\"shard_count\": " + std::to_string(shard_count) +
+                         ",\n\"strategy\": ";
+    utils::append_json_string(output, ::to_string(strategy));
+    output += ",\n\"bundle\": ";
+    output += bundle ? "true" : "false";
+    output += ",\n\"outputs\": ";
+    utils::append_json_string(output, outputs);
+    output += ",\n\"stats\": ";
+    utils::append_json_string(output, stats);
+    output += ",\n\"dropped\": " + std::to_string(dropped);
+    output += ",\n\"files\": [";
+
+    for (std::size_t i{}; i < files.size(); ++i)
+    {
+        output += i == 0 ? "\n" : ",\n";
+        output += "{\"path\": ";
+        utils::append_json_string(output, files[i].path);
+        output += ", \"output\": ";
+        utils::append_json_string(output, files[i].output);
+        output += ", \"bytes\": " + std::to_string(files[i].bytes) + "}";
+    }
+
+    output += "\n]\n}\n";
+    return output;
+}
+
+/**
+ * @brief
+ * Saves the manifest to a JSON file
+ * @param filename Name of the file
+ * @throw std::runtime_error If the file cannot be written
+ */
+void ShardManifest::save(const std::string &filename) const
+{
+    std::ofstream output_file(filename, std::ios::out | std::ios::trunc);
+
+    if (!output_file)
+        throw std::runtime_error("Cannot open file: " + filename);
+
+    output_file << to_json();
+}
+
+/**
+ * @brief
+ * Reads a manifest written by save
+ * @param filename Name of the file
+ * @return ShardManifest Manifest of the file
+ * @throw std::runtime_error If the file cannot be read or is not a
+ *        manifest
+ */
+ShardManifest ShardManifest::load(const std::string &filename)
+{
+    const auto document = utils::load_json(filename);
+    ShardManifest manifest;
+
+    try
+    {
+        manifest.shard = document.at("shard").as_uint();
+        manifest.shard_count = document.at("shard_count").as_uint();
+        manifest.strategy =
+            parse_shard_strategy(document.at("strategy").as_string());
+        manifest.bundle = document.at("bundle").as_bool();
+        manifest.outputs = document.at("outputs").as_string();
+        manifest.stats = document.at("stats").as_string();
+        manifest.dropped = document.at("dropped").as_uint();
+
+        for (const auto &file : document.at("files").as_array())
+            manifest.files.push_back({file.at("path").as_string(),
+                                      file.at("output").as_string(),
+                                      file.at("bytes").as_uint()});
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+
+    if (manifest.shard_count == 0 || manifest.shard >= manifest.shard_count)
+        throw std::runtime_error(filename + ": invalid shard");
+
+    return manifest;
+}
+
+/**
+ * @brief
+ * Combines the files of the shards of one run. The shards must all be
+ * there, once each, and must not share files or output names
+ * @param manifests Manifests of every shard
+ * @return ShardManifest Manifest of the whole run, with its files sorted
+ *         by path and no outputs nor statistics yet
+ * @throw std::runtime_error If the shards do not form one run
+ */
+ShardManifest merge_manifests(const std::vector<ShardManifest> &manifests)
+{
+    if (manifests.empty())
+        throw std::runtime_error("No manifest to merge");
+
+    const auto count = manifests.front().shard_count;
+    const auto strategy = manifests.front().strategy;
+    std::vector<bool> seen(count);
+
+    ShardManifest merged;
+    merged.strategy = strategy;
+
+    for (const auto &manifest : manifests)
+    {
+        const auto name = std::to_string(manifest.shard) + "/" +
+                          std::to_string(manifest.shard_count);
+
+        if (manifest.shard_count != count || manifest.strategy != strategy)
+            throw std::runtime_error("Shard " + name +
+                                     " belongs to another run");
+
+        if (seen[manifest.shard])
+            throw std::runtime_error("Shard " + name + " given twice");
+
+        seen[manifest.shard] = true;
+        merged.dropped += manifest.dropped;
+        merged.files.insert(merged.files.end(), manifest.files.begin(),
+                            manifest.files.end());
+    }
+
+    for (std::size_t i{}; i < count; ++i)
+        if (!seen[i])
+            throw std::runtime_error("Missing shard " + std::to_string(i) +
+                                     "/" + std::to_string(count));
+
+    std::sort(merged.files.begin(), merged.files.end(),
+              [](const auto &lhs, const auto &rhs)
+              { return lhs.path < rhs.path; });
+
+    std::unordered_set<std::string_view> outputs;
+
+    for (std::size_t i{}; i < merged.files.size(); ++i)
+    {
+        if (i != 0 && merged.files[i].path == merged.files[i - 1].path)
+            throw std::runtime_error("File in several shards: " +
+                                     merged.files[i].path);
+
+        if (!outputs.insert(merged.files[i].output).second)
+            throw std::runtime_error("Output name in several shards: " +
+                                     merged.files[i].output);
+    }
+
+    return merged;
+}
+
+/**
+ * @brief
+ * Merges the shards of a run: their manifests, their statistics and
+ * their outputs. The outputs of the shards are copied into one bundle,
+ * from their bundles or from their output directories
+ * @param manifest_files Manifests of every shard
+ * @param manifest_output Merged manifest to write, empty for none
+ * @param stats_output Merged statistics to write, empty for none
+ * @param bundle_output Merged bundle to write, empty to leave the outputs
+ *        where they are, which needs the shards to share one directory
+ * @throw std::runtime_error If the shards do not form one run or their
+ *        files cannot be read
+ */
+void merge_shards(const std::vector<std::string> &manifest_files,
+                  const std::string &manifest_output,
+                  const std::string &stats_output,
+                  const std::string &bundle_output)
+{
+    std::vector<ShardManifest> manifests;
+
+    for (const auto &filename : manifest_files)
+        manifests.push_back(ShardManifest::load(filename));
+
+    auto merged = merge_manifests(manifests);
+
+    if (!bundle_output.empty())
+    {
+        BundleWriter bundle(bundle_output);
+
+        for (const auto &manifest : manifests)
+        {
+            if (manifest.bundle)
+            {
+                bundle.append(BundleReader(manifest.outputs));
+                continue;
+            }
+
+            for (const auto &file : manifest.files)
+            {
+                if (!copy_output(bundle, manifest.outputs, file.output))
+                    continue;
+
+                // Paginated outputs bring their pages along
+                std::size_t page{1};
+
+                while (copy_output(bundle, manifest.outputs,
+                                   utils::page_output_name(file.output, page)))
+                    ++page;
+            }
+        }
+
+        bundle.finish();
+        merged.bundle = true;
+        merged.outputs = std::filesystem::absolute(bundle_output).string();
+    }
+    else
+    {
+        for (const auto &manifest : manifests)
+        {
+            if (manifest.bundle)
+                throw std::runtime_error("Bundles of shards are merged into "
+                                         "a bundle, use --bundle");
+
+            if (manifest.outputs != manifests.front().outputs)
+                throw std::runtime_error("The shards wrote to different "
+                                         "directories, use --bundle");
+        }
+
+        merged.outputs = manifests.front().outputs;
+    }
+
+    if (!stats_output.empty())
+    {
+        CorpusStats stats;
+
+        for (const auto &manifest : manifests)
+        {
+            if (manifest.stats.empty())
+                throw std::runtime_error("Shard " + std::to_string(manifest.shard) +
+                                         " has no statistics");
+
+            auto shard_stats = CorpusStats::load(manifest.stats);
+
+            for (const auto &[path, file_stats] : shard_stats.get_files())
+                stats.add_file(path, file_stats);
+        }
+
+        // The same order and total as a run over the whole corpus
+        stats.sort_files();
+        stats.merge();
+        stats.save(stats_output);
+        merged.stats = std::filesystem::absolute(stats_output).string();
+    }
+
+    if (!manifest_output.empty())
+        merged.save(manifest_output);
+}
@@ -0,0 +1,102 @@
+/**
+ * @file shard.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the sharding of runs over several processes
+ * @version 0.1
+ * @date 2023-06-28
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef SHARD_H
+#define SHARD_H
+
+// C++ standard library
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief
+ * How the files of a corpus are dealt to the shards
+ * @enum ShardStrategy
+ */
+enum class ShardStrategy
+{
+    // By a hash of the file name, stable when other files come and go
+    Hash,
+
+    // Largest first to the least loaded shard, so shards get equal bytes
+    Size
+};
+
+/**
+ * @brief
+ * Shard of a run, as in --shard=1/4
+ * @struct ShardSpec
+ */
+struct ShardSpec
+{
+    std::size_t index{0};
+    std::size_t count{1};
+    ShardStrategy strategy{ShardStrategy::Hash};
+};
+
+std::string_view to_string(ShardStrategy);
+ShardStrategy parse_shard_strategy(std::string_view);
+ShardSpec parse_shard(std::string_view);
+std::vector<std::size_t> select_shard(std::span<const std::string>,
+                                      std::span<const std::uintmax_t>,
+                                      const ShardSpec &);
+
+/**
+ * @brief
+ * What one shard of a run produced: its files, where their outputs went
+ * and where its statistics are. Paths are absolute, so the merge can run
+ * from anywhere
+ * @struct ShardManifest
+ */
+struct ShardManifest
+{
+    /**
+     * @brief
+     * One input file of the shard
+     * @struct File
+     */
+    struct File
+    {
+        std::string path;
+        std::string output;
+        std::uint64_t bytes{0};
+    };
+
+    std::size_t shard{0};
+    std::size_t shard_count{1};
+    ShardStrategy strategy{ShardStrategy::Hash};
+
+    // Output directory, or bundle when bundle is set
+    std::string outputs;
+    bool bundle{false};
+
+    // Statistics file, empty when none was written
+    std::string stats;
+
+    std::size_t dropped{0};
+    std::vector<File> files;
+
+    // Methods
+    std::string to_json() const;
+    void save(const std::string &) const;
+    static ShardManifest load(const std::string &);
+};
+
+ShardManifest merge_manifests(const std::vector<ShardManifest> &);
+void merge_shards(const std::vector<std::string> &, const std::string &,
+                  const std::string &, const std::string &);
+
+#endif //! SHARD_H
@@ -0,0 +1,466 @@
+/**
+ * @file perf_counters.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the PerfCounters class
+ * @version 0.1
+ * @date 2023-06-22
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard libraries
+#include <cstdio>
+#include <string>
+
+// Linux
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Project files
+#include "perf_counters.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Type and configuration of each event, in the order of PerfCounters::Event
+     */
+    constexpr std::array<std::pair<std::uint32_t, std::uint64_t>,
+                         PerfCounters::event_count>
+        event_configs{{{PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+                       {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                       {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                       {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+                       {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}}};
+
+    /**
+     * @brief
+     * Events the machine lets the process count, one bit per event, set
+     * once a thread opened them
+     */
+    std::atomic<unsigned> available_events{0};
+
+    /**
+     * @brief
+     * Whether kernel time is excluded: -1 until the first group is opened,
+     * then 1 if the kernel only lets the process count user space
+     */
+    std::atomic<int> user_only{-1};
+
+    /**
+     * @brief
+     * Source of the identifiers of the PerfCounters instances
+     */
+    std::atomic<std::uint64_t> next_id{1};
+
+    /**
+     * @brief
+     * Opens one perf event counting the calling thread on any CPU
+     * @param event Event to open
+     * @param group Leader of the group, -1 to open a leader
+     * @param exclude_kernel Whether kernel time is excluded
+     * @return int File descriptor, negative on failure
+     */
+    int open_event(std::size_t event, int group, bool exclude_kernel)
+    {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = event_configs[event].first;
+        attributes.config = event_configs[event].second;
+        attributes.read_format = PERF_FORMAT_GROUP;
+        attributes.exclude_kernel = exclude_kernel;
+        attributes.exclude_hv = 1;
+
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attributes,
+                                          0, -1, group, PERF_FLAG_FD_CLOEXEC));
+    }
+
+    /**
+     * @brief
+     * Group of events of one thread, opened on first use
+     * @struct EventGroup
+     */
+    struct EventGroup
+    {
+        bool opened{false};
+        std::array<int, PerfCounters::event_count> fds{-1, -1, -1, -1, -1};
+
+        // Index of each event in what the group reads, -1 if not counted
+        std::array<int, PerfCounters::event_count> positions{-1, -1, -1, -1, -1};
+        int members{0};
+
+        /**
+         * @brief
+         * Opens the events of the calling thread. The task clock leads the
+         * group, since it is always available; hardware events join it
+         * when the machine exposes them
+         * @return true If the group could be opened
+         */
+        bool open()
+        {
+            if (opened)
+                return fds[0] >= 0;
+
+            opened = true;
+
+            if (user_only.load() < 0)
+            {
+                const int fd = open_event(PerfCounters::TaskClock, -1, false);
+                user_only = fd < 0 ? 1 : 0;
+
+                if (fd >= 0)
+                    ::close(fd);
+            }
+
+            const bool exclude_kernel = user_only.load() == 1;
+            fds[0] = open_event(PerfCounters::TaskClock, -1, exclude_kernel);
+
+            if (fds[0] < 0)
+                return false;
+
+            positions[0] = members++;
+
+            for (std::size_t event{1}; event < fds.size(); ++event)
+            {
+                fds[event] = open_event(event, fds[0], exclude_kernel);
+
+                if (fds[event] >= 0)
+                    positions[event] = members++;
+            }
+
+            for (std::size_t event{}; event < fds.size(); ++event)
+                if (positions[event] >= 0)
+                    available_events |= 1u << event;
+
+            return true;
+        }
+
+        /**
+         * @brief
+         * Reads the current value of every event of the group
+         * @param counts Receives the values, 0 for events not counted
+         * @return true If the group could be read
+         */
+        bool read(PerfCounters::Counts &counts)
+        {
+            if (!open())
+                return false;
+
+            std::array<std::uint64_t, 1 + PerfCounters::event_count> values{};
+            const auto size = static_cast<std::size_t>(members + 1) *
+                              sizeof(std::uint64_t);
+
+            if (::read(fds[0], values.data(), size) != static_cast<ssize_t>(size))
+                return false;
+
+            for (std::size_t event{}; event < counts.size(); ++event)
+                counts[event] = positions[event] >= 0
+                                    ? values[1 + static_cast<std::size_t>(positions[event])]
+                                    : 0;
+
+            return true;
+        }
+
+        /**
+         * @brief
+         * Closes the events when the thread exits
+         */
+        ~EventGroup()
+        {
+            for (const int fd : fds)
+                if (fd >= 0)
+                    ::close(fd);
+        }
+    };
+
+    thread_local EventGroup thread_group;
+
+    /**
+     * @brief
+     * Slot of the calling thread in the last instance it counted for
+     */
+    thread_local std::uint64_t cached_id{0};
+    thread_local void *cached_slot{nullptr};
+
+    /**
+     * @brief
+     * Divides without failing on a zero denominator
+     * @param numerator Numerator
+     * @param denominator Denominator
+     * @return double Quotient, 0 if the denominator is 0
+     */
+    double ratio(double numerator, double denominator)
+    {
+        return denominator != 0 ? numerator / denominator : 0;
+    }
+}
+
+// Scope
+/**
+ * @brief
+ * Starts counting a stage on the calling thread, if the counters are
+ * enabled
+ * @param counters Counters the stage is added to
+ * @param stage Counted stage
+ */
+PerfCounters::Scope::Scope(const PerfCounters &counters, Stage stage) noexcept
+    : m_stage(stage)
+{
+    if (counters.is_enabled() && thread_group.read(m_start))
+        m_counters = &counters;
+}
+
+/**
+ * @brief
+ * Destroy the Scope object, adding what was counted to its stage
+ */
+PerfCounters::Scope::~Scope()
+{
+    Counts end;
+
+    if (!m_counters || !thread_group.read(end))
+        return;
+
+    auto &counts = m_counters->get_slot().counts[static_cast<std::size_t>(m_stage)];
+
+    for (std::size_t event{}; event < event_count; ++event)
+        counts[event].fetch_add(end[event] - m_start[event],
+                                std::memory_order_relaxed);
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Perf Counters:: Perf Counters object, disabled
+ */
+PerfCounters::PerfCounters()
+    : m_id(next_id++)
+{
+}
+
+// Access methods
+/**
+ * @brief
+ * Checks whether the stages are being counted
+ * @return true If the counters are enabled
+ */
+bool PerfCounters::is_enabled() const noexcept
+{
+    return m_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief
+ * Gets the counts of a stage summed over every thread
+ * @param stage Stage to read
+ * @return Counts Value of each event, task clock in nanoseconds
+ */
+PerfCounters::Counts PerfCounters::get_counts(Stage stage) const
+{
+    std::lock_guard<std::mutex> lock(m_slots_mutex);
+    Counts total{};
+
+    for (const auto &slot : m_slots)
+        for (std::size_t event{}; event < event_count; ++event)
+            total[event] += slot->counts[static_cast<std::size_t>(stage)][event]
+                                .load(std::memory_order_relaxed);
+
+    return total;
+}
+
+/**
+ * @brief
+ * Gets the number of source bytes lexed since the last reset
+ * @return std::uint64_t Source bytes
+ */
+std::uint64_t PerfCounters::get_source_bytes() const noexcept
+{
+    return m_source_bytes.load(std::memory_order_relaxed);
+}
+
+// Mutator methods
+/**
+ * @brief
+ * Enables or disables the counters
+ * @param enabled Whether the stages are counted
+ * @return true If the counters are in the requested state, false if
+ *         perf events cannot be opened on this system
+ */
+bool PerfCounters::set_enabled(bool enabled)
+{
+    if (enabled && !thread_group.open())
+        return false;
+
+    m_enabled = enabled;
+    return true;
+}
+
+/**
+ * @brief
+ * Clears the counts of every stage and the source bytes. Must not be
+ * called while stages are counted
+ */
+void PerfCounters::reset()
+{
+    std::lock_guard<std::mutex> lock(m_slots_mutex);
+
+    for (auto &slot : m_slots)
+        for (auto &stage : slot->counts)
+            for (auto &count : stage)
+                count.store(0, std::memory_order_relaxed);
+
+    m_source_bytes = 0;
+}
+
+/**
+ * @brief
+ * Adds to the source bytes the misses are related to
+ * @param bytes Bytes lexed
+ */
+void PerfCounters::add_source_bytes(std::uint64_t bytes) const noexcept
+{
+    if (is_enabled())
+        m_source_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+// Methods
+/**
+ * @brief
+ * Prints the CPU time, instructions per cycle, and cache and branch
+ * misses per KB of source of every stage
+ * @param output Stream to print to
+ */
+void PerfCounters::print(std::ostream &output) const
+{
+    const double kilobytes = static_cast<double>(get_source_bytes()) / 1024;
+    const bool hardware = is_available(Cycles) && is_available(Instructions);
+    Counts total{};
+    char line[128];
+
+    output << "Stage        CPU ms      IPC   cache misses/KB   branch misses/KB\n";
+
+    // Events the machine does not count are printed as "-"
+    auto column = [](bool available, double value, int width)
+    {
+        char text[32];
+
+        if (available)
+            std::snprintf(text, sizeof(text), "%*.2f", width, value);
+        else
+            std::snprintf(text, sizeof(text), "%*s", width, "-");
+
+        return std::string(text);
+    };
+
+    auto print_line = [&](const char *name, const Counts &counts)
+    {
+        std::snprintf(line, sizeof(line), "%-9s %9.3f", name,
+                      static_cast<double>(counts[TaskClock]) / 1e6);
+
+        output << line
+               << column(hardware, ratio(static_cast<double>(counts[Instructions]),
+                                         static_cast<double>(counts[Cycles])),
+                         9)
+               << column(is_available(CacheMisses),
+                         ratio(static_cast<double>(counts[CacheMisses]), kilobytes),
+                         18)
+               << column(is_available(BranchMisses),
+                         ratio(static_cast<double>(counts[BranchMisses]), kilobytes),
+                         19)
+               << "\n";
+    };
+
+    for (std::size_t stage{}; stage < stage_count; ++stage)
+    {
+        const auto counts = get_counts(static_cast<Stage>(stage));
+
+        for (std::size_t event{}; event < event_count; ++event)
+            total[event] += counts[event];
+
+        print_line(stage_name(static_cast<Stage>(stage)), counts);
+    }
+
+    print_line("total", total);
+
+    output << "Source lexed: " << get_source_bytes() << " bytes";
+
+    if (user_only.load() == 1)
+        output << ", user space only";
+
+    if (!hardware)
+        output << ", hardware counters unavailable";
+
+    output << "\n";
+}
+
+/**
+ * @brief
+ * Checks whether an event could be opened by a thread of the process
+ * @param event Event to check
+ * @return true If the event is counted
+ */
+bool PerfCounters::is_available(Event event)
+{
+    return (available_events.load() >> event) & 1u;
+}
+
+/**
+ * @brief
+ * Gets the printable name of a stage
+ * @param stage Stage
+ * @return const char* Name of the stage
+ */
+const char *PerfCounters::stage_name(Stage stage) noexcept
+{
+    switch (stage)
+    {
+    case Stage::Read:
+        return "read";
+    case Stage::Scan:
+        return "scan";
+    case Stage::Identify:
+        return "identify";
+    case Stage::Render:
+        return "render";
+    case Stage::Write:
+    default:
+        return "write";
+    }
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Gets the slot of the calling thread, creating it on its first scope.
+ * The last slot used is cached by the thread, so the lock is only taken
+ * when it switches instances
+ * @return Slot& Counters of the calling thread
+ */
+PerfCounters::Slot &PerfCounters::get_slot() const
+{
+    if (cached_id == m_id)
+        return *static_cast<Slot *>(cached_slot);
+
+    std::lock_guard<std::mutex> lock(m_slots_mutex);
+    const auto thread = std::this_thread::get_id();
+    Slot *slot{nullptr};
+
+    // The thread may have counted for another instance in between
+    for (const auto &existing : m_slots)
+        if (existing->thread == thread)
+            slot = existing.get();
+
+    if (!slot)
+    {
+        slot = m_slots.emplace_back(std::make_unique<Slot>()).get();
+        slot->thread = thread;
+    }
+
+    cached_id = m_id;
+    cached_slot = slot;
+
+    return *slot;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file perf_counters.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the PerfCounters class
+ * @version 0.1
+ * @date 2023-06-22
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+// C++ standard libraries
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief
+ * Hardware and software counters of the stages of the lexing pipeline
+ * @class PerfCounters
+ * @details
+ * Each thread opens one group of Linux perf events counting only itself:
+ * task clock, cycles, instructions, cache misses and branch misses. A
+ * scope reads the whole group with one system call when it starts and
+ * when it ends, and adds the difference to the counters of its stage in
+ * a slot owned by the thread, so workers never share a counter. The
+ * slots are summed when the counters are read. Hardware events that the
+ * machine does not expose, as in most virtual machines, read as zero.
+ * While the counters are disabled a scope only loads one flag.
+ */
+class PerfCounters
+{
+public:
+    /**
+     * @brief
+     * Instrumented stages of the pipeline
+     * @enum Stage
+     */
+    enum class Stage
+    {
+        Read,
+        Scan,
+        Identify,
+        Render,
+        Write
+    };
+
+    static constexpr std::size_t stage_count = 5;
+
+    /**
+     * @brief
+     * Events counted by every group
+     * @enum Event
+     */
+    enum Event
+    {
+        TaskClock,
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses
+    };
+
+    static constexpr std::size_t event_count = 5;
+
+    using Counts = std::array<std::uint64_t, event_count>;
+
+    /**
+     * @class Scope
+     * @brief Counts the events of the calling thread while it is alive
+     */
+    class Scope
+    {
+    public:
+        // Constructor
+        Scope(const PerfCounters &, Stage) noexcept;
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        // Destructor
+        ~Scope();
+
+    private:
+        const PerfCounters *m_counters{nullptr};
+        Stage m_stage;
+        Counts m_start{};
+    };
+
+    // Constructor
+    PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    // Access methods
+    bool is_enabled() const noexcept;
+    Counts get_counts(Stage) const;
+    std::uint64_t get_source_bytes() const noexcept;
+
+    // Mutator methods
+    bool set_enabled(bool);
+    void reset();
+    void add_source_bytes(std::uint64_t) const noexcept;
+
+    // Methods
+    void print(std::ostream &) const;
+    static bool is_available(Event);
+    static const char *stage_name(Stage) noexcept;
+
+private:
+    /**
+     * @brief
+     * Counters of one thread, written by that thread only
+     * @struct Slot
+     */
+    struct Slot
+    {
+        std::thread::id thread;
+        std::array<std::array<std::atomic<std::uint64_t>, event_count>,
+                   stage_count>
+            counts{};
+    };
+
+    // Identifies the instance in the caches of the threads
+    std::uint64_t m_id;
+
+    std::atomic<bool> m_enabled{false};
+    mutable std::atomic<std::uint64_t> m_source_bytes{0};
+
+    mutable std::mutex m_slots_mutex;
+    mutable std::vector<std::unique_ptr<Slot>> m_slots;
+
+    // Methods
+    Slot &get_slot() const;
+};
+
+#endif //! PERF_COUNTERS_H
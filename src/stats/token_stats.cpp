@@ -0,0 +1,499 @@
+/**
+ * @file token_stats.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the TokenStats and CorpusStats classes
+ * @version 0.1
+ * @date 2023-06-09
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard libraries
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+// Project files
+#include "token_stats.h"
+#include "../token/token_registry.h"
+#include "../utils/json.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Checks whether a token is made only of whitespace
+     * @param value Token to check
+     * @return true If every character is whitespace
+     */
+    bool is_whitespace(const std::string_view &value) noexcept
+    {
+        return std::all_of(value.begin(), value.end(), [](char c)
+                           { return c == ' ' || c == '\t' || c == '\n' ||
+                                    c == '\r' || c == '\v' || c == '\f'; });
+    }
+}
+
+// TokenStats
+// Access methods
+/**
+ * @brief
+ * Gets the number of tokens of a type
+ * @param type Token type
+ * @return std::uint64_t Number of tokens
+ */
+std::uint64_t TokenStats::get_count(TokenType type) const noexcept
+{
+    return m_counts[static_cast<std::size_t>(type)];
+}
+
+/**
+ * @brief
+ * Gets the number of source bytes covered by tokens of a type
+ * @param type Token type
+ * @return std::uint64_t Number of bytes
+ */
+std::uint64_t TokenStats::get_bytes(TokenType type) const noexcept
+{
+    return m_bytes[static_cast<std::size_t>(type)];
+}
+
+/**
+ * @brief
+ * Gets the number of tokens of every type
+ * @return std::uint64_t Number of tokens
+ */
+std::uint64_t TokenStats::get_token_count() const noexcept
+{
+    std::uint64_t total{};
+
+    for (const auto count : m_counts)
+        total += count;
+
+    return total;
+}
+
+/**
+ * @brief
+ * Gets the size of the source
+ * @return std::uint64_t Number of bytes
+ */
+std::uint64_t TokenStats::get_source_bytes() const noexcept
+{
+    return m_source_bytes;
+}
+
+/**
+ * @brief
+ * Gets the number of bytes inside comments
+ * @return std::uint64_t Number of bytes
+ */
+std::uint64_t TokenStats::get_comment_bytes() const noexcept
+{
+    return get_bytes(TokenType::Comment);
+}
+
+/**
+ * @brief
+ * Gets the number of whitespace bytes between tokens
+ * @return std::uint64_t Number of bytes
+ */
+std::uint64_t TokenStats::get_whitespace_bytes() const noexcept
+{
+    return m_whitespace_bytes;
+}
+
+/**
+ * @brief
+ * Gets the number of bytes left out by the preprocessor directives
+ * @return std::uint64_t Number of bytes
+ */
+std::uint64_t TokenStats::get_inactive_bytes() const noexcept
+{
+    return get_bytes(TokenType::InactiveCode);
+}
+
+/**
+ * @brief
+ * Gets the number of token bytes that are neither comments, whitespace
+ * nor inactive code
+ * @return std::uint64_t Number of bytes
+ */
+std::uint64_t TokenStats::get_code_bytes() const noexcept
+{
+    std::uint64_t total{};
+
+    for (const auto bytes : m_bytes)
+        total += bytes;
+
+    return total - get_comment_bytes() - m_whitespace_bytes - get_inactive_bytes();
+}
+
+/**
+ * @brief
+ * Gets the ratio of comment bytes to code bytes
+ * @return double Comment to code ratio, 0 if there is no code
+ */
+double TokenStats::get_comment_ratio() const noexcept
+{
+    const auto code = get_code_bytes();
+
+    return code == 0 ? 0.0
+                     : static_cast<double>(get_comment_bytes()) /
+                           static_cast<double>(code);
+}
+
+/**
+ * @brief
+ * Gets the longest tokens, longest first
+ * @return const std::vector<LongToken>& Longest tokens
+ */
+const std::vector<TokenStats::LongToken> &
+TokenStats::get_longest() const noexcept
+{
+    return m_longest;
+}
+
+// Mutator methods
+/**
+ * @brief
+ * Counts a token
+ * @param value Text of the token
+ * @param type Type of the token
+ */
+void TokenStats::add(const std::string_view &value, TokenType type)
+{
+    const auto index = static_cast<std::size_t>(type);
+
+    ++m_counts[index];
+    m_bytes[index] += value.size();
+
+    if (type == TokenType::Other && is_whitespace(value))
+    {
+        m_whitespace_bytes += value.size();
+        return;
+    }
+
+    // Inactive regions are whole blocks of code, not tokens
+    if (type == TokenType::InactiveCode)
+        return;
+
+    if (m_longest.size() < max_longest ||
+        value.size() > m_longest.back().length)
+        add_longest({value.size(), type,
+                     std::string(value.substr(0, preview_length))});
+}
+
+/**
+ * @brief
+ * Sets the size of the source the tokens come from
+ * @param bytes Number of bytes
+ */
+void TokenStats::set_source_bytes(std::uint64_t bytes) noexcept
+{
+    m_source_bytes = bytes;
+}
+
+/**
+ * @brief
+ * Counts two tokens of a type as one, as when a run cut in two is joined
+ * again. Their bytes are unchanged
+ * @param type Type of the tokens
+ */
+void TokenStats::join(TokenType type) noexcept
+{
+    auto &count = m_counts[static_cast<std::size_t>(type)];
+
+    if (count != 0)
+        --count;
+}
+
+/**
+ * @brief
+ * Adds the statistics of another file or corpus
+ * @param other Statistics to add
+ */
+void TokenStats::merge(const TokenStats &other)
+{
+    for (std::size_t i{}; i < token_type_count; ++i)
+    {
+        m_counts[i] += other.m_counts[i];
+        m_bytes[i] += other.m_bytes[i];
+    }
+
+    m_source_bytes += other.m_source_bytes;
+    m_whitespace_bytes += other.m_whitespace_bytes;
+
+    for (const auto &token : other.m_longest)
+        if (m_longest.size() < max_longest ||
+            token.length > m_longest.back().length)
+            add_longest(token);
+}
+
+// Methods (Public)
+/**
+ * @brief
+ * Appends the statistics to a JSON document as an object
+ * @param output Document to append to
+ */
+void TokenStats::append_json(std::string &output) const
+{
+    output += "{\"source_bytes\": " + std::to_string(m_source_bytes);
+    output += ", \"tokens\": " + std::to_string(get_token_count());
+    output += ", \"comment_bytes\": " + std::to_string(get_comment_bytes());
+    output += ", \"whitespace_bytes\": " + std::to_string(m_whitespace_bytes);
+    output += ", \"inactive_bytes\": " + std::to_string(get_inactive_bytes());
+    output += ", \"code_bytes\": " + std::to_string(get_code_bytes());
+    output += ", \"comment_to_code_ratio\": " +
+              std::to_string(get_comment_ratio());
+    output += ", \"types\": {";
+
+    bool first = true;
+
+    for (std::size_t i{}; i < token_type_count; ++i)
+    {
+        if (m_counts[i] == 0)
+            continue;
+
+        if (!first)
+            output += ", ";
+
+        first = false;
+        utils::append_json_string(output, to_string(static_cast<TokenType>(i)));
+        output += ": {\"count\": " + std::to_string(m_counts[i]) +
+                  ", \"bytes\": " + std::to_string(m_bytes[i]) + "}";
+    }
+
+    output += "}, \"longest_tokens\": [";
+
+    for (std::size_t i{}; i < m_longest.size(); ++i)
+    {
+        if (i != 0)
+            output += ", ";
+
+        output += "{\"length\": " + std::to_string(m_longest[i].length) +
+                  ", \"type\": ";
+        utils::append_json_string(output, to_string(m_longest[i].type));
+        output += ", \"preview\": ";
+        utils::append_json_string(output, m_longest[i].preview);
+        output += "}";
+    }
+
+    output += "]}";
+}
+
+/**
+ * @brief
+ * Reads statistics written by append_json
+ * @param value Parsed statistics object
+ * @return TokenStats Statistics, equal to the ones written
+ * @throw std::runtime_error If the object is not valid statistics
+ */
+TokenStats TokenStats::from_json(const utils::JsonValue &value)
+{
+    TokenStats stats;
+
+    // Type of a name written by to_string
+    auto type_of = [](const std::string &name)
+    {
+        const auto type = token_type_of(name);
+
+        if (!type)
+            throw std::runtime_error("Unknown token type: " + name);
+
+        return *type;
+    };
+
+    stats.m_source_bytes = value.at("source_bytes").as_uint();
+    stats.m_whitespace_bytes = value.at("whitespace_bytes").as_uint();
+
+    for (const auto &[name, type] : value.at("types").as_object())
+    {
+        const auto index = static_cast<std::size_t>(type_of(name));
+        stats.m_counts[index] = type.at("count").as_uint();
+        stats.m_bytes[index] = type.at("bytes").as_uint();
+    }
+
+    for (const auto &token : value.at("longest_tokens").as_array())
+        stats.add_longest({token.at("length").as_uint(),
+                           type_of(token.at("type").as_string()),
+                           token.at("preview").as_string()});
+
+    return stats;
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Inserts a token in the sorted list of longest tokens
+ * @param token Token to insert
+ */
+void TokenStats::add_longest(LongToken token)
+{
+    const auto position = std::upper_bound(
+        m_longest.begin(), m_longest.end(), token.length,
+        [](std::size_t length, const LongToken &other)
+        { return length > other.length; });
+
+    m_longest.insert(position, std::move(token));
+
+    if (m_longest.size() > max_longest)
+        m_longest.pop_back();
+}
+
+// CorpusStats
+// Access methods
+/**
+ * @brief
+ * Gets the statistics of the whole corpus
+ * @return const TokenStats& Corpus statistics, valid after merge()
+ */
+const TokenStats &CorpusStats::get_total() const noexcept
+{
+    return m_total;
+}
+
+/**
+ * @brief
+ * Gets the statistics of every file
+ * @return const std::vector<std::pair<std::string, TokenStats>>&
+ *         Filename and statistics of every file
+ */
+const std::vector<std::pair<std::string, TokenStats>> &
+CorpusStats::get_files() const noexcept
+{
+    return m_files;
+}
+
+// Mutator methods
+/**
+ * @brief
+ * Clears the statistics and makes room for a new run
+ * @param num_files Number of files of the run
+ */
+void CorpusStats::reset(std::size_t num_files)
+{
+    m_files.assign(num_files, {});
+    m_total = TokenStats();
+}
+
+/**
+ * @brief
+ * Stores the statistics of a file. Each index must be written by a
+ * single task, so no lock is needed
+ * @param index Index of the file in the run
+ * @param filename Name of the file
+ * @param stats Statistics of the file
+ */
+void CorpusStats::set_file(std::size_t index, std::string filename,
+                           TokenStats stats)
+{
+    m_files[index] = {std::move(filename), std::move(stats)};
+}
+
+/**
+ * @brief
+ * Appends the statistics of a file, as when combining runs
+ * @param filename Name of the file
+ * @param stats Statistics of the file
+ */
+void CorpusStats::add_file(std::string filename, TokenStats stats)
+{
+    m_files.emplace_back(std::move(filename), std::move(stats));
+}
+
+/**
+ * @brief
+ * Orders the files by name, the order of a run over a whole directory
+ */
+void CorpusStats::sort_files()
+{
+    std::stable_sort(m_files.begin(), m_files.end(),
+                     [](const auto &lhs, const auto &rhs)
+                     { return lhs.first < rhs.first; });
+}
+
+/**
+ * @brief
+ * Computes the corpus statistics from the statistics of every file
+ */
+void CorpusStats::merge()
+{
+    m_total = TokenStats();
+
+    for (const auto &[filename, stats] : m_files)
+        m_total.merge(stats);
+}
+
+// Methods (Public)
+/**
+ * @brief
+ * Converts the statistics to a JSON document
+ * @return std::string JSON document
+ */
+std::string CorpusStats::to_json() const
+{
+    std::string output = "{\n\"corpus\": ";
+    m_total.append_json(output);
+    output += ",\n\"files\": [";
+
+    for (std::size_t i{}; i < m_files.size(); ++i)
+    {
+        output += i == 0 ? "\n" : ",\n";
+        output += "{\"path\": ";
+        utils::append_json_string(output, m_files[i].first);
+        output += ", \"stats\": ";
+        m_files[i].second.append_json(output);
+        output += "}";
+    }
+
+    output += "\n]\n}\n";
+    return output;
+}
+
+/**
+ * @brief
+ * Writes the statistics to a JSON file
+ * @param filename Output filename
+ * @throw std::runtime_error If the file cannot be opened
+ */
+void CorpusStats::save(const std::string &filename) const
+{
+    std::ofstream output_file(filename, std::ios::out | std::ios::trunc);
+
+    if (!output_file)
+        throw std::runtime_error("Cannot open file: " + filename);
+
+    output_file << to_json();
+}
+
+/**
+ * @brief
+ * Reads statistics written by save. The corpus total is read as written
+ * @param filename File to read
+ * @return CorpusStats Statistics of the file
+ * @throw std::runtime_error If the file cannot be read or is not valid
+ *        statistics
+ */
+CorpusStats CorpusStats::load(const std::string &filename)
+{
+    const auto document = utils::load_json(filename);
+    CorpusStats stats;
+
+    try
+    {
+        stats.m_total = TokenStats::from_json(document.at("corpus"));
+
+        for (const auto &file : document.at("files").as_array())
+            stats.add_file(file.at("path").as_string(),
+                           TokenStats::from_json(file.at("stats")));
+    }
+    catch (const std::runtime_error &e)
+    {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+
+    return stats;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file token_stats.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the TokenStats and CorpusStats classes
+ * @version 0.1
+ * @date 2023-06-09
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef TOKEN_STATS_H
+#define TOKEN_STATS_H
+
+// C++ standard libraries
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Project files
+#include "../token/token.h"
+
+namespace utils
+{
+    class JsonValue;
+}
+
+/**
+ * @brief
+ * Token statistics of a file or of a whole corpus
+ * @class TokenStats
+ * @details
+ * Filled while tokenizing, one instance per task, so the workers never
+ * share counters. Instances are merged once the run is over.
+ */
+class TokenStats
+{
+public:
+    // Number of longest tokens kept
+    static constexpr std::size_t max_longest = 5;
+
+    // Number of characters kept from each longest token
+    static constexpr std::size_t preview_length = 60;
+
+    /**
+     * @brief
+     * One of the longest tokens seen
+     * @struct LongToken
+     */
+    struct LongToken
+    {
+        std::size_t length;
+        TokenType type;
+        std::string preview;
+    };
+
+    // Constructor
+    TokenStats() = default;
+
+    // Access methods
+    std::uint64_t get_count(TokenType) const noexcept;
+    std::uint64_t get_bytes(TokenType) const noexcept;
+    std::uint64_t get_token_count() const noexcept;
+    std::uint64_t get_source_bytes() const noexcept;
+    std::uint64_t get_comment_bytes() const noexcept;
+    std::uint64_t get_whitespace_bytes() const noexcept;
+    std::uint64_t get_inactive_bytes() const noexcept;
+    std::uint64_t get_code_bytes() const noexcept;
+    double get_comment_ratio() const noexcept;
+    const std::vector<LongToken> &get_longest() const noexcept;
+
+    // Mutator methods
+    void add(const std::string_view &, TokenType);
+    void set_source_bytes(std::uint64_t) noexcept;
+    void join(TokenType) noexcept;
+    void merge(const TokenStats &);
+
+    // Methods
+    void append_json(std::string &) const;
+    static TokenStats from_json(const utils::JsonValue &);
+
+private:
+    std::array<std::uint64_t, token_type_count> m_counts{};
+    std::array<std::uint64_t, token_type_count> m_bytes{};
+    std::uint64_t m_source_bytes{};
+    std::uint64_t m_whitespace_bytes{};
+    std::vector<LongToken> m_longest;
+
+    // Methods
+    void add_longest(LongToken);
+};
+
+/**
+ * @brief
+ * Statistics of every file of a run plus their corpus-wide total
+ * @class CorpusStats
+ */
+class CorpusStats
+{
+public:
+    // Constructor
+    CorpusStats() = default;
+
+    // Access methods
+    const TokenStats &get_total() const noexcept;
+    const std::vector<std::pair<std::string, TokenStats>> &
+    get_files() const noexcept;
+
+    // Mutator methods
+    void reset(std::size_t);
+    void set_file(std::size_t, std::string, TokenStats);
+    void add_file(std::string, TokenStats);
+    void sort_files();
+    void merge();
+
+    // Methods
+    std::string to_json() const;
+    void save(const std::string &) const;
+    static CorpusStats load(const std::string &);
+
+private:
+    std::vector<std::pair<std::string, TokenStats>> m_files;
+    TokenStats m_total;
+};
+
+#endif //! TOKEN_STATS_H
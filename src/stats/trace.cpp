@@ -0,0 +1,340 @@
+/**
+ * @file trace.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the Trace class
+ * @version 0.1
+ * @date 2023-06-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard libraries
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+// POSIX
+#include <unistd.h>
+
+// Project files
+#include "trace.h"
+#include "../utils/json.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Source of the identifiers of the Trace instances
+     */
+    std::atomic<std::uint64_t> next_id{1};
+
+    /**
+     * @brief
+     * Buffer of the calling thread in the last instance it recorded for
+     */
+    thread_local std::uint64_t cached_id{0};
+    thread_local void *cached_buffer{nullptr};
+
+    /**
+     * @brief
+     * Appends a duration in microseconds, the unit of trace events
+     * @param output Document to append to
+     * @param duration Duration to append
+     */
+    void append_microseconds(std::string &output, Trace::Clock::duration duration)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.3f",
+                      std::chrono::duration<double, std::micro>(duration).count());
+        output += text;
+    }
+}
+
+// Span
+/**
+ * @brief
+ * Starts a span on the calling thread, if the trace is enabled
+ * @param trace Trace the span is recorded in
+ * @param name Name of the span, a string literal
+ * @param category Category of the span, a string literal
+ */
+Trace::Span::Span(const Trace &trace, const char *name,
+                  const char *category) noexcept
+    : m_name(name), m_category(category)
+{
+    if (!trace.is_enabled())
+        return;
+
+    m_trace = &trace;
+    m_start = Clock::now();
+}
+
+/**
+ * @brief
+ * Starts a span about a file on the calling thread, if the trace is
+ * enabled
+ * @param trace Trace the span is recorded in
+ * @param name Name of the span, a string literal
+ * @param category Category of the span, a string literal
+ * @param file File the span works on
+ * @param bytes Bytes the span works on
+ */
+Trace::Span::Span(const Trace &trace, const char *name, const char *category,
+                  std::string_view file, std::uint64_t bytes)
+    : m_name(name), m_category(category), m_bytes(bytes)
+{
+    if (!trace.is_enabled())
+        return;
+
+    m_trace = &trace;
+    m_file = file;
+    m_start = Clock::now();
+}
+
+/**
+ * @brief
+ * Destroy the Span object, recording it in the buffer of the thread
+ */
+Trace::Span::~Span()
+{
+    if (!m_trace)
+        return;
+
+    try
+    {
+        const auto end = Clock::now();
+        m_trace->get_buffer().events.push_back(
+            Event{m_name, m_category, std::move(m_file), m_bytes, m_start, end,
+                  m_queued});
+    }
+    catch (const std::exception &)
+    {
+        // A span that cannot be stored is lost, the traced work is not
+    }
+}
+
+// Mutator methods
+/**
+ * @brief
+ * Sets the bytes the span works on, once they are known
+ * @param bytes Number of bytes
+ */
+void Trace::Span::set_bytes(std::uint64_t bytes) noexcept
+{
+    m_bytes = bytes;
+}
+
+/**
+ * @brief
+ * Sets the time the work of the span was queued at, so the time it
+ * waited for a worker is recorded
+ * @param queued Time the task was queued
+ */
+void Trace::Span::set_queued(Clock::time_point queued) noexcept
+{
+    m_queued = queued;
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Trace:: Trace object, disabled
+ */
+Trace::Trace()
+    : m_id(next_id++), m_origin(Clock::now())
+{
+}
+
+// Access methods
+/**
+ * @brief
+ * Checks whether spans are recorded
+ * @return true If the trace is enabled
+ */
+bool Trace::is_enabled() const noexcept
+{
+    return m_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief
+ * Gets the number of recorded spans
+ * @return std::size_t Number of spans
+ */
+std::size_t Trace::get_event_count() const
+{
+    std::lock_guard<std::mutex> lock(m_buffers_mutex);
+    std::size_t count{};
+
+    for (const auto &buffer : m_buffers)
+        count += buffer->events.size();
+
+    return count;
+}
+
+// Mutator methods
+/**
+ * @brief
+ * Enables or disables the recording of spans
+ * @param enabled Whether spans are recorded
+ */
+void Trace::set_enabled(bool enabled) noexcept
+{
+    m_enabled = enabled;
+}
+
+/**
+ * @brief
+ * Names the track of the calling thread
+ * @param name Name shown for the thread
+ */
+void Trace::set_thread_name(std::string_view name) const
+{
+    auto &buffer = get_buffer();
+
+    if (buffer.name != name)
+        buffer.name = name;
+}
+
+/**
+ * @brief
+ * Forgets every recorded span and restarts the clock of the timeline.
+ * Must not be called while spans are recorded
+ */
+void Trace::clear()
+{
+    std::lock_guard<std::mutex> lock(m_buffers_mutex);
+
+    for (auto &buffer : m_buffers)
+        buffer->events.clear();
+
+    m_origin = Clock::now();
+}
+
+// Methods
+/**
+ * @brief
+ * Converts the recorded spans to the Chrome trace event format. Must not
+ * be called while spans are recorded
+ * @return std::string JSON document
+ */
+std::string Trace::to_json() const
+{
+    std::lock_guard<std::mutex> lock(m_buffers_mutex);
+    const auto pid = std::to_string(::getpid());
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    auto begin_event = [&]()
+    {
+        json += first ? "\n" : ",\n";
+        first = false;
+    };
+
+    for (const auto &buffer : m_buffers)
+    {
+        const auto tid = std::to_string(buffer->tid);
+
+        begin_event();
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid +
+                ",\"tid\":" + tid + ",\"args\":{\"name\":";
+        utils::append_json_string(json, buffer->name);
+        json += "}}";
+
+        for (const auto &event : buffer->events)
+        {
+            begin_event();
+            json += "{\"name\":";
+            utils::append_json_string(json, event.name);
+            json += ",\"cat\":";
+            utils::append_json_string(json, event.category);
+            json += ",\"ph\":\"X\",\"pid\":" + pid + ",\"tid\":" + tid +
+                    ",\"ts\":";
+            append_microseconds(json, event.start - m_origin);
+            json += ",\"dur\":";
+            append_microseconds(json, event.end - event.start);
+            json += ",\"args\":{";
+
+            std::string_view separator;
+
+            if (!event.file.empty())
+            {
+                json += "\"file\":";
+                utils::append_json_string(json, event.file);
+                separator = ",";
+            }
+
+            if (event.bytes != 0)
+            {
+                json += separator;
+                json += "\"bytes\":" + std::to_string(event.bytes);
+                separator = ",";
+            }
+
+            if (event.queued)
+            {
+                json += separator;
+                json += "\"queue_wait_us\":";
+                append_microseconds(json, event.start - *event.queued);
+            }
+
+            json += "}}";
+        }
+    }
+
+    json += "\n]}\n";
+    return json;
+}
+
+/**
+ * @brief
+ * Saves the recorded spans as a Chrome trace event file
+ * @param filename File to write
+ * @throw std::runtime_error If the file cannot be written
+ */
+void Trace::save(const std::string &filename) const
+{
+    std::ofstream output_file(filename, std::ios::out | std::ios::trunc);
+
+    if (!output_file)
+        throw std::runtime_error("Cannot open file: " + filename);
+
+    output_file << to_json();
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Gets the buffer of the calling thread, creating it on its first span.
+ * The last buffer used is cached by the thread, so the lock is only taken
+ * when it switches instances
+ * @return Buffer& Events of the calling thread
+ */
+Trace::Buffer &Trace::get_buffer() const
+{
+    if (cached_id == m_id)
+        return *static_cast<Buffer *>(cached_buffer);
+
+    std::lock_guard<std::mutex> lock(m_buffers_mutex);
+    const auto thread = std::this_thread::get_id();
+    Buffer *buffer{nullptr};
+
+    for (const auto &existing : m_buffers)
+        if (existing->thread == thread)
+            buffer = existing.get();
+
+    if (!buffer)
+    {
+        buffer = m_buffers.emplace_back(std::make_unique<Buffer>()).get();
+        buffer->thread = thread;
+        buffer->tid = m_buffers.size();
+        buffer->name = "thread " + std::to_string(buffer->tid);
+    }
+
+    cached_id = m_id;
+    cached_buffer = buffer;
+
+    return *buffer;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file trace.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the Trace class
+ * @version 0.1
+ * @date 2023-06-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+// C++ standard libraries
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief
+ * Timeline of the work of every thread, exported as Chrome trace events
+ * @class Trace
+ * @details
+ * Spans are recorded by the thread they ran on into a buffer owned by
+ * that thread, so recording never takes a lock once a thread has its
+ * buffer. The resulting JSON opens in chrome://tracing and in Perfetto,
+ * with one track per thread and nested spans for the stages of a task.
+ * While the trace is disabled a span only loads one flag.
+ */
+class Trace
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @class Span
+     * @brief Records the time between its construction and destruction
+     */
+    class Span
+    {
+    public:
+        // Constructor
+        Span(const Trace &, const char *, const char *) noexcept;
+        Span(const Trace &, const char *, const char *, std::string_view,
+             std::uint64_t = 0);
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+        // Destructor
+        ~Span();
+
+        // Mutator methods
+        void set_bytes(std::uint64_t) noexcept;
+        void set_queued(Clock::time_point) noexcept;
+
+    private:
+        const Trace *m_trace{nullptr};
+        const char *m_name;
+        const char *m_category;
+        std::string m_file;
+        std::uint64_t m_bytes{0};
+        Clock::time_point m_start;
+        std::optional<Clock::time_point> m_queued;
+    };
+
+    // Constructor
+    Trace();
+
+    Trace(const Trace &) = delete;
+    Trace &operator=(const Trace &) = delete;
+
+    // Access methods
+    bool is_enabled() const noexcept;
+    std::size_t get_event_count() const;
+
+    // Mutator methods
+    void set_enabled(bool) noexcept;
+    void set_thread_name(std::string_view) const;
+    void clear();
+
+    // Methods
+    std::string to_json() const;
+    void save(const std::string &) const;
+
+private:
+    /**
+     * @brief
+     * Finished span
+     * @struct Event
+     */
+    struct Event
+    {
+        const char *name;
+        const char *category;
+        std::string file;
+        std::uint64_t bytes;
+        Clock::time_point start;
+        Clock::time_point end;
+        std::optional<Clock::time_point> queued;
+    };
+
+    /**
+     * @brief
+     * Events of one thread, appended by that thread only
+     * @struct Buffer
+     */
+    struct Buffer
+    {
+        std::thread::id thread;
+        std::size_t tid;
+        std::string name;
+        std::vector<Event> events;
+    };
+
+    // Identifies the instance in the caches of the threads
+    std::uint64_t m_id;
+
+    std::atomic<bool> m_enabled{false};
+    Clock::time_point m_origin;
+
+    mutable std::mutex m_buffers_mutex;
+    mutable std::vector<std::unique_ptr<Buffer>> m_buffers;
+
+    // Methods
+    Buffer &get_buffer() const;
+};
+
+#endif //! TRACE_H
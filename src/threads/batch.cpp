@@ -0,0 +1,161 @@
+/**
+ * @file batch.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the Batch class
+ * @version 0.1
+ * @date 2023-06-16
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// Project files
+#include "batch.h"
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Batch:: Batch object
+ * @param pool Thread pool the tasks of the batch run on
+ */
+Batch::Batch(ThreadPool &pool)
+    : m_pool(&pool), m_state(std::make_shared<State>())
+{
+}
+
+// Access methods
+/**
+ * @brief
+ * Checks whether the remaining tasks should be dropped. Long tasks may
+ * poll it to stop early
+ * @return true If the batch is cancelled or past its deadline
+ */
+bool Batch::should_stop() const noexcept
+{
+    return m_state->should_stop();
+}
+
+/**
+ * @brief
+ * Checks whether the batch was cancelled
+ * @return true If cancel() was called
+ */
+bool Batch::is_cancelled() const noexcept
+{
+    return m_state->cancelled;
+}
+
+/**
+ * @brief
+ * Gets the number of tasks that have not finished yet
+ * @return std::size_t Number of pending tasks
+ */
+std::size_t Batch::get_pending() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->pending;
+}
+
+/**
+ * @brief
+ * Gets the number of tasks dropped by a cancellation or a deadline
+ * @return std::size_t Number of dropped tasks
+ */
+std::size_t Batch::get_dropped() const noexcept
+{
+    return m_state->dropped;
+}
+
+/**
+ * @brief
+ * Gets the number of tasks that threw an exception
+ * @return std::size_t Number of failed tasks
+ */
+std::size_t Batch::get_failed() const noexcept
+{
+    return m_state->failed;
+}
+
+// Mutator methods
+/**
+ * @brief
+ * Sets the time after which queued tasks are dropped
+ * @param deadline Deadline of the batch
+ */
+void Batch::set_deadline(Clock::time_point deadline) noexcept
+{
+    m_state->deadline = deadline.time_since_epoch().count();
+}
+
+// Methods
+/**
+ * @brief
+ * Blocks until every task of the batch has run or been dropped
+ */
+void Batch::wait() const
+{
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->done.wait(lock, [this]()
+                       { return m_state->pending == 0; });
+}
+
+/**
+ * @brief
+ * Blocks until every task of the batch has finished or a time is reached
+ * @param time Time to stop waiting at
+ * @return true If the batch finished
+ */
+bool Batch::wait_until(Clock::time_point time) const
+{
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+
+    return m_state->done.wait_until(lock, time, [this]()
+                                    { return m_state->pending == 0; });
+}
+
+/**
+ * @brief
+ * Drops every task of the batch that has not started yet
+ */
+void Batch::cancel() noexcept
+{
+    m_state->cancelled = true;
+}
+
+// State
+/**
+ * @brief
+ * Checks whether the remaining tasks should be dropped
+ * @return true If the batch is cancelled or past its deadline
+ */
+bool Batch::State::should_stop() const noexcept
+{
+    return cancelled ||
+           Clock::now().time_since_epoch().count() > deadline.load();
+}
+
+/**
+ * @brief
+ * Registers new pending tasks
+ * @param count Number of tasks
+ */
+void Batch::State::add(std::size_t count)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    pending += count;
+}
+
+/**
+ * @brief
+ * Marks tasks as finished and wakes the waiters of the last one
+ * @param count Number of tasks
+ */
+void Batch::State::finish(std::size_t count)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    pending -= count;
+
+    if (pending == 0)
+        done.notify_all();
+}
@@ -0,0 +1,182 @@
+/**
+ * @file batch.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the Batch class
+ * @version 0.1
+ * @date 2023-06-16
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+// C++ Standard Libraries
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Project files
+#include "thread_pool.h"
+
+/**
+ * @class Batch
+ * @brief Handle to a group of tasks running on a shared thread pool
+ * @details
+ * Lets a caller wait for its own tasks while the pool keeps serving
+ * others, cancel the tasks that have not started yet, and drop every task
+ * still queued once a deadline has passed. Copies of a batch refer to the
+ * same group, and tasks keep the group alive, so a caller may drop its
+ * handle without waiting.
+ */
+class Batch
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Constructor
+    explicit Batch(ThreadPool &);
+
+    // Access methods
+    bool should_stop() const noexcept;
+    bool is_cancelled() const noexcept;
+    std::size_t get_pending() const;
+    std::size_t get_dropped() const noexcept;
+    std::size_t get_failed() const noexcept;
+
+    // Mutator methods
+    void set_deadline(Clock::time_point) noexcept;
+
+    // Methods
+    void wait() const;
+    bool wait_until(Clock::time_point) const;
+    void cancel() noexcept;
+
+    // Inline methods
+    /**
+     * @brief
+     * Adds a task to the batch. The task is dropped instead of run if the
+     * batch is cancelled or past its deadline when a worker picks it up.
+     * Exceptions thrown by the task are counted as failures.
+     * @tparam F Function type
+     * @param func Function to be executed
+     * @throw std::runtime_error If the thread pool is stopped
+     */
+    template <class F>
+    void submit(F &&func)
+    {
+        auto state = m_state;
+        state->add();
+
+        try
+        {
+            m_pool->post([state, func = std::forward<F>(func)]() mutable
+                         { state->run(func); });
+        }
+        catch (...)
+        {
+            state->finish();
+            throw;
+        }
+    }
+
+    /**
+     * @brief
+     * Adds one task per index of a range, all published to the pool at
+     * once. Each task calls the function with its index
+     * @tparam F Function type, copied into every task
+     * @param first First index
+     * @param last Past the last index
+     * @param func Function to be executed for each index
+     * @throw std::runtime_error If the thread pool is stopped
+     */
+    template <class F>
+    void submit_bulk(std::size_t first, std::size_t last, const F &func)
+    {
+        if (first >= last)
+            return;
+
+        auto state = m_state;
+        std::vector<Task> tasks;
+        tasks.reserve(last - first);
+
+        for (auto index = first; index < last; ++index)
+            tasks.emplace_back([state, func, index]() mutable
+                               {
+                auto call = [&func, index]()
+                { func(index); };
+                state->run(call); });
+
+        state->add(tasks.size());
+
+        try
+        {
+            m_pool->enqueue_bulk(tasks);
+        }
+        catch (...)
+        {
+            state->finish(tasks.size());
+            throw;
+        }
+    }
+
+private:
+    /**
+     * @brief
+     * State shared by the copies of a batch and its queued tasks
+     * @struct State
+     */
+    struct State
+    {
+        std::atomic<bool> cancelled{false};
+        std::atomic<Clock::rep> deadline{Clock::time_point::max()
+                                             .time_since_epoch()
+                                             .count()};
+        std::atomic<std::size_t> dropped{0};
+        std::atomic<std::size_t> failed{0};
+
+        mutable std::mutex mutex;
+        mutable std::condition_variable done;
+        std::size_t pending{0};
+
+        bool should_stop() const noexcept;
+        void add(std::size_t count = 1);
+        void finish(std::size_t count = 1);
+
+        /**
+         * @brief
+         * Runs, or drops, one task of the batch
+         * @tparam F Function type
+         * @param func Function to be executed
+         */
+        template <class F>
+        void run(F &func)
+        {
+            if (should_stop())
+                ++dropped;
+            else
+            {
+                try
+                {
+                    func();
+                }
+                catch (...)
+                {
+                    ++failed;
+                }
+            }
+
+            finish();
+        }
+    };
+
+    ThreadPool *m_pool;
+    std::shared_ptr<State> m_state;
+};
+
+#endif //! BATCH_H
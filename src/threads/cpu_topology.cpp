@@ -0,0 +1,210 @@
+/**
+ * @file cpu_topology.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the CPU topology helpers
+ * @version 0.1
+ * @date 2023-06-12
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+
+// POSIX
+#include <pthread.h>
+#include <sched.h>
+
+// Project files
+#include "cpu_topology.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Reads the first line of a small kernel file
+     * @param path Path of the file
+     * @return std::optional<std::string> First line, if the file exists
+     */
+    std::optional<std::string> read_line(const std::string &path)
+    {
+        std::ifstream file(path);
+        std::string line;
+
+        if (!file || !std::getline(file, line))
+            return std::nullopt;
+
+        return line;
+    }
+}
+
+namespace cpu
+{
+    /**
+     * @brief
+     * Gets the CPUs the process is allowed to run on
+     * @return std::vector<int> CPU numbers from the affinity mask
+     */
+    std::vector<int> allowed_cpus()
+    {
+        std::vector<int> cpus;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+
+        if (::sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int i{}; i < CPU_SETSIZE; ++i)
+                if (CPU_ISSET(i, &set))
+                    cpus.push_back(i);
+        }
+
+        return cpus;
+    }
+
+    /**
+     * @brief
+     * Gets the CPU quota of the cgroup of the process
+     * @return std::optional<double> Number of CPUs worth of time the
+     *         process may use, nothing if it is not limited
+     */
+    std::optional<double> cgroup_cpu_limit()
+    {
+        // cgroup v2: "<quota> <period>" or "max <period>"
+        if (const auto line = read_line("/sys/fs/cgroup/cpu.max"))
+        {
+            const auto space = line->find(' ');
+
+            if (space == std::string::npos || line->substr(0, space) == "max")
+                return std::nullopt;
+
+            const double quota = std::stod(line->substr(0, space));
+            const double period = std::stod(line->substr(space + 1));
+
+            return period > 0 ? std::optional<double>(quota / period)
+                              : std::nullopt;
+        }
+
+        // cgroup v1: quota is -1 when unlimited
+        const auto quota = read_line("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+        const auto period = read_line("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+
+        if (!quota || !period)
+            return std::nullopt;
+
+        const double quota_us = std::stod(*quota);
+        const double period_us = std::stod(*period);
+
+        if (quota_us <= 0 || period_us <= 0)
+            return std::nullopt;
+
+        return quota_us / period_us;
+    }
+
+    /**
+     * @brief
+     * Number of workers that fits the CPUs actually available to the
+     * process: the affinity mask, capped by the cgroup quota
+     * @return std::size_t Number of workers, at least one
+     */
+    std::size_t default_worker_count()
+    {
+        std::size_t count = allowed_cpus().size();
+
+        if (count == 0)
+            count = std::thread::hardware_concurrency();
+
+        try
+        {
+            if (const auto limit = cgroup_cpu_limit())
+                count = std::min(count, static_cast<std::size_t>(
+                                            std::ceil(*limit)));
+        }
+        catch (const std::exception &)
+        {
+            // Unparsable quota files are treated as no quota
+        }
+
+        return std::max<std::size_t>(count, 1);
+    }
+
+    /**
+     * @brief
+     * Gets the NUMA node a CPU belongs to
+     * @param cpu CPU number
+     * @return int NUMA node, 0 on machines without NUMA information
+     */
+    int numa_node_of(int cpu)
+    {
+        const std::filesystem::path directory =
+            "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        std::error_code error;
+
+        for (const auto &entry :
+             std::filesystem::directory_iterator(directory, error))
+        {
+            const auto name = entry.path().filename().string();
+
+            if (name.rfind("node", 0) == 0 && name.size() > 4)
+                return std::stoi(name.substr(4));
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief
+     * Orders the allowed CPUs so that consecutive workers alternate
+     * between NUMA nodes. A pool smaller than the machine then still uses
+     * the memory bandwidth of every node.
+     * @return std::vector<int> CPU numbers in placement order
+     */
+    std::vector<int> placement_order()
+    {
+        std::map<int, std::vector<int>> nodes;
+
+        for (const int cpu : allowed_cpus())
+            nodes[numa_node_of(cpu)].push_back(cpu);
+
+        std::vector<int> order;
+
+        for (std::size_t i{}; !nodes.empty(); ++i)
+        {
+            for (auto it = nodes.begin(); it != nodes.end();)
+            {
+                if (i < it->second.size())
+                {
+                    order.push_back(it->second[i]);
+                    ++it;
+                }
+                else
+                    it = nodes.erase(it);
+            }
+        }
+
+        return order;
+    }
+
+    /**
+     * @brief
+     * Restricts the calling thread to a single CPU
+     * @param cpu CPU number
+     * @return true If the affinity was changed
+     */
+    bool pin_current_thread(int cpu)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+
+        return ::pthread_setaffinity_np(::pthread_self(), sizeof(set),
+                                        &set) == 0;
+    }
+}
@@ -0,0 +1,31 @@
+/**
+ * @file cpu_topology.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the CPU topology helpers
+ * @version 0.1
+ * @date 2023-06-12
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef CPU_TOPOLOGY_H
+#define CPU_TOPOLOGY_H
+
+// C++ Standard Libraries
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace cpu
+{
+    std::vector<int> allowed_cpus();
+    std::optional<double> cgroup_cpu_limit();
+    std::size_t default_worker_count();
+    int numa_node_of(int);
+    std::vector<int> placement_order();
+    bool pin_current_thread(int);
+}
+
+#endif //! CPU_TOPOLOGY_H
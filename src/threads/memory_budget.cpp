@@ -0,0 +1,288 @@
+/**
+ * @file memory_budget.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the MemoryBudget class
+ * @version 0.1
+ * @date 2023-06-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+// POSIX
+#include <unistd.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Project files
+#include "memory_budget.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Releases from this size on also give the freed heap back to the
+     * system
+     */
+    constexpr std::size_t trim_threshold = 16 * 1024 * 1024;
+}
+
+// Lease
+/**
+ * @brief
+ * Construct a new lease of memory acquired from a budget
+ * @param budget Budget the memory is given back to
+ * @param bytes Acquired bytes
+ */
+MemoryBudget::Lease::Lease(MemoryBudget &budget, std::size_t bytes) noexcept
+    : m_budget(&budget), m_bytes(bytes)
+{
+}
+
+/**
+ * @brief
+ * Construct a new lease taking over another one
+ * @param other Lease to take over, left empty
+ */
+MemoryBudget::Lease::Lease(Lease &&other) noexcept
+    : m_budget(other.m_budget), m_bytes(other.m_bytes)
+{
+    other.m_budget = nullptr;
+    other.m_bytes = 0;
+}
+
+/**
+ * @brief
+ * Releases the memory of this lease and takes over another one
+ * @param other Lease to take over, left empty
+ * @return Lease& This lease
+ */
+MemoryBudget::Lease &MemoryBudget::Lease::operator=(Lease &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        m_budget = other.m_budget;
+        m_bytes = other.m_bytes;
+        other.m_budget = nullptr;
+        other.m_bytes = 0;
+    }
+
+    return *this;
+}
+
+/**
+ * @brief
+ * Destroy the Lease object, giving its memory back
+ */
+MemoryBudget::Lease::~Lease()
+{
+    release();
+}
+
+/**
+ * @brief
+ * Gets the number of bytes held by the lease
+ * @return std::size_t Held bytes, 0 once released
+ */
+std::size_t MemoryBudget::Lease::get_bytes() const noexcept
+{
+    return m_bytes;
+}
+
+/**
+ * @brief
+ * Moves part of the lease to a new lease, so that it can be released
+ * apart
+ * @param bytes Bytes to move, at most the bytes held
+ * @return Lease Lease of the moved bytes
+ */
+MemoryBudget::Lease MemoryBudget::Lease::split(std::size_t bytes) noexcept
+{
+    if (!m_budget)
+        return {};
+
+    bytes = std::min(bytes, m_bytes);
+    m_bytes -= bytes;
+
+    return Lease(*m_budget, bytes);
+}
+
+/**
+ * @brief
+ * Gives the memory of the lease back to its budget
+ */
+void MemoryBudget::Lease::release() noexcept
+{
+    if (m_budget)
+        m_budget->release(m_bytes);
+
+    m_budget = nullptr;
+    m_bytes = 0;
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Memory Budget:: Memory Budget object
+ * @param capacity Bytes the tasks in flight may hold, 0 for no limit
+ */
+MemoryBudget::MemoryBudget(std::size_t capacity)
+    : m_capacity(capacity)
+{
+}
+
+// Access methods
+/**
+ * @brief
+ * Gets the capacity of the budget
+ * @return std::size_t Capacity in bytes, 0 for no limit
+ */
+std::size_t MemoryBudget::get_capacity() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_capacity;
+}
+
+/**
+ * @brief
+ * Gets the memory currently held by leases
+ * @return std::size_t Bytes in use
+ */
+std::size_t MemoryBudget::get_in_use() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_in_use;
+}
+
+/**
+ * @brief
+ * Gets the most memory held at once since the last reset
+ * @return std::size_t Peak bytes in use
+ */
+std::size_t MemoryBudget::get_peak() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_peak;
+}
+
+// Mutator methods
+/**
+ * @brief
+ * Changes the capacity of the budget and wakes the waiting acquirers
+ * @param capacity Bytes the tasks in flight may hold, 0 for no limit
+ */
+void MemoryBudget::set_capacity(std::size_t capacity)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = capacity;
+    }
+
+    m_released.notify_all();
+}
+
+/**
+ * @brief
+ * Restarts the peak measurement from the memory currently in use
+ */
+void MemoryBudget::reset_peak()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_peak = m_in_use;
+}
+
+// Methods
+/**
+ * @brief
+ * Acquires memory, blocking until the tasks in flight leave room for it
+ * @param bytes Estimated bytes needed by the task
+ * @return Lease Lease giving the memory back when destroyed
+ */
+MemoryBudget::Lease MemoryBudget::acquire(std::size_t bytes)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_released.wait(lock, [this, bytes]()
+                    { return m_capacity == 0 || m_in_use == 0 ||
+                             m_in_use + bytes <= m_capacity; });
+
+    m_in_use += bytes;
+    m_peak = std::max(m_peak, m_in_use);
+
+    return Lease(*this, bytes);
+}
+
+/**
+ * @brief
+ * Default budget: half of the physical memory, or of the memory limit of
+ * the cgroup of the process when it is lower
+ * @return std::size_t Capacity in bytes, 0 if the memory size is unknown
+ */
+std::size_t MemoryBudget::default_capacity()
+{
+    const long pages = ::sysconf(_SC_PHYS_PAGES);
+    const long page_size = ::sysconf(_SC_PAGESIZE);
+    std::size_t memory = pages > 0 && page_size > 0
+                             ? static_cast<std::size_t>(pages) *
+                                   static_cast<std::size_t>(page_size)
+                             : 0;
+
+    // cgroup v2 then v1, "max" or a huge number mean no limit
+    for (const char *path : {"/sys/fs/cgroup/memory.max",
+                             "/sys/fs/cgroup/memory/memory.limit_in_bytes"})
+    {
+        std::ifstream file(path);
+        std::string line;
+
+        if (!file || !std::getline(file, line) || line == "max")
+            continue;
+
+        try
+        {
+            const auto limit = std::stoull(line);
+
+            if (limit != 0 && (memory == 0 || limit < memory))
+                memory = static_cast<std::size_t>(limit);
+        }
+        catch (const std::exception &)
+        {
+            // Unparsable limits are treated as no limit
+        }
+
+        break;
+    }
+
+    return memory / 2;
+}
+
+/**
+ * @brief
+ * Gives memory back and wakes the waiting acquirers
+ * @param bytes Released bytes
+ */
+void MemoryBudget::release(std::size_t bytes) noexcept
+{
+#if defined(__GLIBC__)
+    // glibc keeps freed memory in the arena of the thread that used it, so
+    // without trimming the resident size follows the sum of the peaks of
+    // every worker instead of the budget
+    if (bytes >= trim_threshold)
+        ::malloc_trim(0);
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_in_use -= std::min(bytes, m_in_use);
+    }
+
+    m_released.notify_all();
+}
@@ -0,0 +1,96 @@
+/**
+ * @file memory_budget.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the MemoryBudget class
+ * @version 0.1
+ * @date 2023-06-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+// C++ Standard Libraries
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+/**
+ * @class MemoryBudget
+ * @brief Bounds the memory held by the tasks in flight
+ * @details
+ * A dispatcher acquires the estimated memory of a task before submitting
+ * it and blocks while the budget is exhausted. The returned lease travels
+ * with the task and gives the memory back when it is destroyed. A task
+ * larger than the whole budget is admitted once nothing else is in
+ * flight, so it runs alone instead of never.
+ */
+class MemoryBudget
+{
+public:
+    /**
+     * @class Lease
+     * @brief Memory acquired from a budget, released on destruction
+     */
+    class Lease
+    {
+    public:
+        // Constructor
+        Lease() = default;
+        Lease(Lease &&) noexcept;
+        Lease &operator=(Lease &&) noexcept;
+
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+
+        // Destructor
+        ~Lease();
+
+        // Access methods
+        std::size_t get_bytes() const noexcept;
+
+        // Methods
+        Lease split(std::size_t) noexcept;
+        void release() noexcept;
+
+    private:
+        friend class MemoryBudget;
+        Lease(MemoryBudget &, std::size_t) noexcept;
+
+        MemoryBudget *m_budget{nullptr};
+        std::size_t m_bytes{0};
+    };
+
+    // Constructor
+    explicit MemoryBudget(std::size_t capacity = 0);
+
+    MemoryBudget(const MemoryBudget &) = delete;
+    MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+    // Access methods
+    std::size_t get_capacity() const;
+    std::size_t get_in_use() const;
+    std::size_t get_peak() const;
+
+    // Mutator methods
+    void set_capacity(std::size_t);
+    void reset_peak();
+
+    // Methods
+    Lease acquire(std::size_t);
+    static std::size_t default_capacity();
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_released;
+    std::size_t m_capacity;
+    std::size_t m_in_use{0};
+    std::size_t m_peak{0};
+
+    void release(std::size_t) noexcept;
+};
+
+#endif //! MEMORY_BUDGET_H
@@ -0,0 +1,204 @@
+/**
+ * @file task.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the Task class
+ * @version 0.1
+ * @date 2023-06-20
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+// C++ Standard Libraries
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @class Task
+ * @brief Move-only callable stored in place
+ * @details
+ * Replaces std::function for the tasks of the thread pool. Callables that
+ * fit in the inline buffer and move without throwing are stored inside
+ * the task, so queuing them does not allocate; larger ones are moved to
+ * the heap. Unlike std::function, move-only callables such as
+ * std::packaged_task are accepted.
+ */
+class Task
+{
+public:
+    /**
+     * @brief
+     * Largest callable stored without allocating
+     */
+    static constexpr std::size_t inline_size = 10 * sizeof(void *);
+
+    // Constructor
+    Task() noexcept = default;
+
+    /**
+     * @brief
+     * Construct a new Task object holding a callable
+     * @tparam F Function type
+     * @param func Function to be executed
+     */
+    template <class F, class = std::enable_if_t<
+                           !std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F &&func)
+    {
+        using Function = std::decay_t<F>;
+
+        if constexpr (is_inline<Function>())
+        {
+            ::new (static_cast<void *>(m_storage)) Function(std::forward<F>(func));
+            m_operations = &inline_operations<Function>;
+        }
+        else
+        {
+            ::new (static_cast<void *>(m_storage))
+                Function *(new Function(std::forward<F>(func)));
+            m_operations = &heap_operations<Function>;
+        }
+    }
+
+    /**
+     * @brief
+     * Construct a new Task object taking over another one
+     * @param other Task to take over, left empty
+     */
+    Task(Task &&other) noexcept
+    {
+        take(other);
+    }
+
+    /**
+     * @brief
+     * Destroys the held callable and takes over another task
+     * @param other Task to take over, left empty
+     * @return Task& This task
+     */
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            take(other);
+        }
+
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    // Destructor
+    ~Task()
+    {
+        reset();
+    }
+
+    // Access methods
+    /**
+     * @brief
+     * Checks whether the task holds a callable
+     * @return true If the task can be run
+     */
+    explicit operator bool() const noexcept
+    {
+        return m_operations != nullptr;
+    }
+
+    // Methods
+    /**
+     * @brief
+     * Runs the held callable
+     */
+    void operator()()
+    {
+        m_operations->invoke(m_storage);
+    }
+
+    /**
+     * @brief
+     * Destroys the held callable, releasing what it captured
+     */
+    void reset() noexcept
+    {
+        if (m_operations)
+            m_operations->destroy(m_storage);
+
+        m_operations = nullptr;
+    }
+
+private:
+    /**
+     * @brief
+     * Type-erased operations on the stored callable
+     * @struct Operations
+     */
+    struct Operations
+    {
+        void (*invoke)(void *);
+        void (*relocate)(void *from, void *to) noexcept;
+        void (*destroy)(void *) noexcept;
+    };
+
+    /**
+     * @brief
+     * Checks whether a callable is stored in the inline buffer
+     * @tparam F Function type
+     * @return true If it fits and moves without throwing
+     */
+    template <class F>
+    static constexpr bool is_inline()
+    {
+        return sizeof(F) <= inline_size &&
+               alignof(F) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<F>;
+    }
+
+    template <class F>
+    static constexpr Operations inline_operations{
+        [](void *storage)
+        { (*static_cast<F *>(storage))(); },
+        [](void *from, void *to) noexcept
+        {
+            ::new (to) F(std::move(*static_cast<F *>(from)));
+            static_cast<F *>(from)->~F();
+        },
+        [](void *storage) noexcept
+        { static_cast<F *>(storage)->~F(); }};
+
+    template <class F>
+    static constexpr Operations heap_operations{
+        [](void *storage)
+        { (**static_cast<F **>(storage))(); },
+        [](void *from, void *to) noexcept
+        { ::new (to) F *(*static_cast<F **>(from)); },
+        [](void *storage) noexcept
+        { delete *static_cast<F **>(storage); }};
+
+    alignas(std::max_align_t) unsigned char m_storage[inline_size];
+    const Operations *m_operations{nullptr};
+
+    /**
+     * @brief
+     * Moves the callable of another task into this empty one
+     * @param other Task to take over, left empty
+     */
+    void take(Task &other) noexcept
+    {
+        if (other.m_operations)
+            other.m_operations->relocate(other.m_storage, m_storage);
+
+        m_operations = other.m_operations;
+        other.m_operations = nullptr;
+    }
+};
+
+#endif //! TASK_H
@@ -0,0 +1,202 @@
+/**
+ * @file task_queue.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the TaskQueue class
+ * @version 0.1
+ * @date 2023-06-20
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <thread>
+
+// Project files
+#include "task_queue.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Signed distance between a sequence number and a position, which
+     * stays meaningful when the counters wrap around
+     * @param sequence Sequence number of a cell
+     * @param position Position of a producer or consumer
+     * @return std::intptr_t Difference
+     */
+    inline std::intptr_t distance(std::size_t sequence, std::size_t position)
+    {
+        return static_cast<std::intptr_t>(sequence - position);
+    }
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Task Queue:: Task Queue object
+ * @param capacity Number of tasks the queue holds, rounded up to a power
+ *        of two, at least two
+ */
+TaskQueue::TaskQueue(std::size_t capacity)
+{
+    capacity = std::bit_ceil(std::max<std::size_t>(capacity, 2));
+
+    m_cells = std::make_unique<Cell[]>(capacity);
+    m_mask = capacity - 1;
+
+    for (std::size_t i{}; i < capacity; ++i)
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+// Access methods
+/**
+ * @brief
+ * Gets the number of tasks the queue holds
+ * @return std::size_t Capacity
+ */
+std::size_t TaskQueue::capacity() const noexcept
+{
+    return m_mask + 1;
+}
+
+/**
+ * @brief
+ * Gets the number of queued tasks. Only a hint while other threads use
+ * the queue
+ * @return std::size_t Approximate number of tasks
+ */
+std::size_t TaskQueue::size() const noexcept
+{
+    const auto tail = m_dequeue_position.load(std::memory_order_relaxed);
+    const auto head = m_enqueue_position.load(std::memory_order_relaxed);
+
+    return distance(head, tail) > 0 ? head - tail : 0;
+}
+
+// Methods
+/**
+ * @brief
+ * Adds a task at the end of the queue
+ * @param task Task to add, left empty on success
+ * @return true If the task was added, false if the queue is full
+ */
+bool TaskQueue::try_push(Task &task)
+{
+    auto position = m_enqueue_position.load(std::memory_order_relaxed);
+    Cell *cell;
+
+    while (true)
+    {
+        cell = &m_cells[position & m_mask];
+        const auto difference =
+            distance(cell->sequence.load(std::memory_order_acquire), position);
+
+        if (difference == 0)
+        {
+            if (m_enqueue_position.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+            return false;
+        else
+            position = m_enqueue_position.load(std::memory_order_relaxed);
+    }
+
+    cell->task = std::move(task);
+    cell->sequence.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+/**
+ * @brief
+ * Adds as many tasks of a range as there is room for, claiming their
+ * cells at once
+ * @param tasks First task of the range, the added ones are left empty
+ * @param count Number of tasks in the range
+ * @return std::size_t Number of tasks added from the front of the range
+ */
+std::size_t TaskQueue::try_push_bulk(Task *tasks, std::size_t count)
+{
+    auto position = m_enqueue_position.load(std::memory_order_relaxed);
+    std::size_t claimed{};
+
+    while (count != 0)
+    {
+        const auto tail = m_dequeue_position.load(std::memory_order_acquire);
+
+        // The position read may be older than the tail
+        if (distance(position, tail) < 0)
+        {
+            position = m_enqueue_position.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        const auto used = position - tail;
+
+        if (used >= capacity())
+            return 0;
+
+        claimed = std::min(count, capacity() - used);
+
+        if (m_enqueue_position.compare_exchange_weak(
+                position, position + claimed, std::memory_order_relaxed))
+            break;
+    }
+
+    for (std::size_t i{}; i < claimed; ++i)
+    {
+        Cell &cell = m_cells[(position + i) & m_mask];
+
+        // The consumer of the previous lap has claimed the cell, but may
+        // still be moving its task out
+        while (cell.sequence.load(std::memory_order_acquire) != position + i)
+            std::this_thread::yield();
+
+        cell.task = std::move(tasks[i]);
+        cell.sequence.store(position + i + 1, std::memory_order_release);
+    }
+
+    return claimed;
+}
+
+/**
+ * @brief
+ * Removes the task at the front of the queue
+ * @param task Receives the task
+ * @return true If a task was removed, false if none is ready
+ */
+bool TaskQueue::try_pop(Task &task)
+{
+    auto position = m_dequeue_position.load(std::memory_order_relaxed);
+    Cell *cell;
+
+    while (true)
+    {
+        cell = &m_cells[position & m_mask];
+        const auto difference =
+            distance(cell->sequence.load(std::memory_order_acquire), position + 1);
+
+        if (difference == 0)
+        {
+            if (m_dequeue_position.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+            return false;
+        else
+            position = m_dequeue_position.load(std::memory_order_relaxed);
+    }
+
+    task = std::move(cell->task);
+    cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+
+    return true;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file task_queue.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the TaskQueue class
+ * @version 0.1
+ * @date 2023-06-20
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef TASK_QUEUE_H
+#define TASK_QUEUE_H
+
+// C++ Standard Libraries
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Project files
+#include "task.h"
+
+/**
+ * @class TaskQueue
+ * @brief Bounded lock-free queue of tasks for many producers and consumers
+ * @details
+ * A ring of cells, each with a sequence number telling whose turn it is
+ * (D. Vyukov's bounded MPMC queue). Producers and consumers claim a cell
+ * with a single compare-and-swap on their own position and hand it over
+ * by publishing its next sequence number, so neither side ever blocks the
+ * other. A bulk push claims a whole run of cells with one compare-and-swap.
+ * Tasks are moved into the cells, so the queue never allocates after it
+ * is built.
+ */
+class TaskQueue
+{
+public:
+    // Constructor
+    explicit TaskQueue(std::size_t);
+
+    TaskQueue(const TaskQueue &) = delete;
+    TaskQueue &operator=(const TaskQueue &) = delete;
+
+    // Access methods
+    std::size_t capacity() const noexcept;
+    std::size_t size() const noexcept;
+
+    // Methods
+    bool try_push(Task &);
+    std::size_t try_push_bulk(Task *, std::size_t);
+    bool try_pop(Task &);
+
+private:
+    /**
+     * @brief
+     * Slot of the ring. The sequence equals the position of the next push
+     * it accepts, or that position plus one once it holds a task
+     * @struct Cell
+     */
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence{0};
+        Task task;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    std::size_t m_mask;
+
+    // Kept on separate cache lines, producers and consumers contend on one each
+    alignas(64) std::atomic<std::size_t> m_enqueue_position{0};
+    alignas(64) std::atomic<std::size_t> m_dequeue_position{0};
+};
+
+#endif //! TASK_QUEUE_H
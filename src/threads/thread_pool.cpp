@@ -13,57 +13,304 @@
 // C++ Standard Libraries
 #include <stdexcept>
 #include <memory>
+#include <algorithm>
+#include <utility>
 
 // Project files
 #include "thread_pool.h"
+#include "cpu_topology.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Pool the current thread works for, null outside of any pool
+     */
+    thread_local const ThreadPool *current_pool = nullptr;
+}
 
 // Constructor
 /**
  * @brief
  * Construct a new Thread Pool:: Thread Pool object
- * @param num_threads Number of threads to be created
+ * @param num_threads Number of threads to be created, at least one is
+ *        always created
+ * @param pin_threads Whether each thread is pinned to its own CPU. Pinned
+ *        threads keep the memory they allocate on their own NUMA node,
+ *        since Linux places pages on the node of the thread that first
+ *        touches them
+ * @param queue_capacity Number of tasks queued before submitters wait
  */
-ThreadPool::ThreadPool(std::size_t num_threads)
-    : m_stop(false)
+ThreadPool::ThreadPool(std::size_t num_threads, bool pin_threads,
+                       std::size_t queue_capacity)
+    : m_tasks(queue_capacity)
 {
+    const auto cpus = pin_threads ? cpu::placement_order() : std::vector<int>{};
+
+    num_threads = std::max<std::size_t>(num_threads, 1);
+
     for (std::size_t i{}; i < num_threads; ++i)
     {
-        m_threads.emplace_back([this]
-                               {
-            while (true)
-            {
-                std::function<void()> task;
-
-                {
-                    std::unique_lock<std::mutex> lock(this->m_queue_mutex);
-                    this->m_condition.wait(lock, [this]
-                                           { return this->m_stop || !this->m_tasks.empty(); });
-
-                    if (this->m_stop && this->m_tasks.empty())
-                        return;
-
-                    task = std::move(this->m_tasks.front());
-                    this->m_tasks.pop();
-                }
-
-                task();
-            } });
+        const int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+
+        m_threads.emplace_back([this, cpu]
+                               { work(cpu); });
     }
 }
 
-// Destructor
+// Access methods
 /**
- * @brief Destroy the Thread Pool:: Thread Pool object
+ * @brief
+ * Gets the number of threads of the pool
+ * @return std::size_t Number of threads
  */
-ThreadPool::~ThreadPool()
+std::size_t ThreadPool::size() const noexcept
+{
+    return m_threads.size();
+}
+
+/**
+ * @brief
+ * Checks whether the calling thread is one of the workers of the pool
+ * @return true If called from a task of this pool
+ */
+bool ThreadPool::is_worker() const noexcept
+{
+    return current_pool == this;
+}
+
+// Methods
+/**
+ * @brief
+ * Blocks until the queue is empty and no task is running. The pool keeps
+ * its threads and accepts new tasks afterwards
+ * @throw Whatever the first task to fail threw since the last call
+ */
+void ThreadPool::wait_idle()
+{
+    wait_unfinished();
+
+    std::exception_ptr error;
+
+    {
+        std::lock_guard<std::mutex> lock(m_error_mutex);
+        error = std::exchange(m_error, nullptr);
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+/**
+ * @brief
+ * Adds a task to the thread pool without a future for its result
+ * @param task Task to be executed
+ * @throw std::runtime_error If the thread pool is stopped
+ */
+void ThreadPool::post(Task task)
+{
+    push(&task, 1);
+}
+
+/**
+ * @brief
+ * Adds several tasks at once. They are published with a single claim on
+ * the queue and exactly as many workers as tasks are woken
+ * @param tasks Tasks to be executed, left empty
+ * @throw std::runtime_error If the thread pool is stopped
+ */
+void ThreadPool::enqueue_bulk(std::vector<Task> &tasks)
+{
+    push(tasks.data(), tasks.size());
+}
+
+/**
+ * @brief
+ * Records every task queued from now on as a span of its worker, with the
+ * time it waited in the queue. The trace must outlive the pool
+ * @param trace Trace to record in, nullptr to stop tracing
+ */
+void ThreadPool::set_trace(const Trace *trace) noexcept
+{
+    m_trace = trace;
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Queues tasks and wakes one worker per task. While the queue is full a
+ * worker runs the next task itself, other threads sleep until a worker
+ * takes a task out
+ * @param tasks First task, the queued ones are left empty
+ * @param count Number of tasks
+ * @throw std::runtime_error If the thread pool is stopped
+ */
+void ThreadPool::push(Task *tasks, std::size_t count)
+{
+    if (m_stop.load(std::memory_order_acquire))
+        throw std::runtime_error("enqueue on stopped ThreadPool");
+
+    // Counted before they are visible, so the pool never looks idle
+    // while they are queued
+    m_unfinished.fetch_add(count, std::memory_order_relaxed);
+
+    if (const auto *trace = m_trace.load(std::memory_order_relaxed))
+    {
+        const auto queued = Trace::Clock::now();
+
+        for (std::size_t i{}; i < count; ++i)
+            tasks[i] = Task([trace, queued, task = std::move(tasks[i])]() mutable
+                            {
+                trace->set_thread_name("worker");
+                Trace::Span span(*trace, "task", "pool");
+                span.set_queued(queued);
+                task(); });
+    }
+
+    auto try_push = [&]()
+    {
+        return count == 1 ? static_cast<std::size_t>(m_tasks.try_push(*tasks))
+                          : m_tasks.try_push_bulk(tasks, count);
+    };
+
+    while (count != 0)
+    {
+        auto pushed = try_push();
+
+        if (pushed == 0 && is_worker())
+        {
+            run(*tasks);
+            ++tasks;
+            --count;
+            continue;
+        }
+
+        if (pushed == 0)
+        {
+            // Announced before trying again, so a worker taking a task out
+            // in between either sees this thread or leaves room for it.
+            // A wake up meant for another submitter only costs a retry
+            m_blocked.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            pushed = try_push();
+
+            if (pushed == 0)
+                m_room.acquire();
+
+            m_blocked.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        if (pushed != 0)
+        {
+            m_ready.release(static_cast<std::ptrdiff_t>(pushed));
+            tasks += pushed;
+            count -= pushed;
+        }
+    }
+}
+
+/**
+ * @brief
+ * Runs a task, destroys what it captured and signals the pool is idle if
+ * it was the last one. An exception the task throws is kept for
+ * wait_idle() instead of ending the worker
+ * @param task Task to be executed, left empty
+ */
+void ThreadPool::run(Task &task)
 {
+    // Counted as finished however the task ends, once what it captured
+    // is gone
+    struct Finish
+    {
+        ThreadPool &pool;
+
+        ~Finish()
+        {
+            if (pool.m_unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                pool.m_unfinished.notify_all();
+        }
+    } finish{*this};
+
+    try
+    {
+        task();
+    }
+    catch (...)
     {
-        std::unique_lock<std::mutex> lock(m_queue_mutex);
-        m_stop = true;
+        std::lock_guard<std::mutex> lock(m_error_mutex);
+
+        if (!m_error)
+            m_error = std::current_exception();
     }
 
-    m_condition.notify_all();
+    task.reset();
+}
+
+/**
+ * @brief
+ * Blocks until the queue is empty and no task is running
+ */
+void ThreadPool::wait_unfinished() noexcept
+{
+    auto unfinished = m_unfinished.load(std::memory_order_acquire);
+
+    while (unfinished != 0)
+    {
+        m_unfinished.wait(unfinished, std::memory_order_acquire);
+        unfinished = m_unfinished.load(std::memory_order_acquire);
+    }
+}
+
+/**
+ * @brief
+ * Loop of a worker thread: sleeps until a task is announced, runs it, and
+ * returns once the pool is stopped and nothing is left
+ * @param cpu CPU to pin the thread to, negative to leave it unpinned
+ */
+void ThreadPool::work(int cpu)
+{
+    if (cpu >= 0)
+        cpu::pin_current_thread(cpu);
+
+    current_pool = this;
+    Task task;
+
+    while (true)
+    {
+        m_ready.acquire();
+
+        // Every count matches a queued task, but the producer of an
+        // earlier cell may not have published it yet
+        while (!m_tasks.try_pop(task))
+        {
+            if (m_stop.load(std::memory_order_acquire))
+                return;
+
+            std::this_thread::yield();
+        }
+
+        // The cell is free again, a sleeping submitter may take it
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (m_blocked.load(std::memory_order_relaxed) != 0)
+            m_room.release();
+
+        run(task);
+    }
+}
+
+// Destructor
+/**
+ * @brief Destroy the Thread Pool:: Thread Pool object. Queued tasks are
+ * run first, and an exception no wait_idle() reported is dropped
+ */
+ThreadPool::~ThreadPool()
+{
+    wait_unfinished();
+    m_stop.store(true, std::memory_order_release);
+    m_ready.release(static_cast<std::ptrdiff_t>(m_threads.size()));
 
     for (std::thread &thread : m_threads)
         thread.join();
-}
\ No newline at end of file
+}
@@ -14,29 +14,59 @@
 #define THREAD_POOL_H
 
 // C++ Standard Libraries
+#include <atomic>
+#include <exception>
 #include <vector>
-#include <queue>
 #include <thread>
 #include <functional>
-#include <mutex>
-#include <condition_variable>
 #include <future>
+#include <mutex>
+#include <semaphore>
+
+// Project files
+#include "task.h"
+#include "task_queue.h"
+#include "../stats/trace.h"
 
 /**
  * @class ThreadPool
  * @brief Implements and manages a thread pool
  * @details This class implements a thread pool,
  * which is a collection of threads that are waiting to perform a task.
+ * Tasks go through a bounded lock-free queue and sleeping workers are
+ * woken through a counting semaphore, one count per queued task, so
+ * neither side takes a lock. When the queue is full, a worker submitting
+ * a task runs it itself instead of waiting for workers that may all be
+ * submitting too, and any other thread sleeps until a worker takes a task
+ * out. The first exception escaping a task is kept and rethrown by
+ * wait_idle().
  */
 class ThreadPool
 {
 public:
+    /**
+     * @brief
+     * Number of tasks the queue holds unless told otherwise
+     */
+    static constexpr std::size_t default_queue_capacity = 4096;
+
     // Constructor
-    ThreadPool(std::size_t);
+    ThreadPool(std::size_t, bool pin_threads = false,
+               std::size_t queue_capacity = default_queue_capacity);
 
     // Destructor
     ~ThreadPool();
 
+    // Access methods
+    std::size_t size() const noexcept;
+    bool is_worker() const noexcept;
+
+    // Methods
+    void wait_idle();
+    void post(Task);
+    void enqueue_bulk(std::vector<Task> &);
+    void set_trace(const Trace *) noexcept;
+
     // Inline methods
     /**
      * @brief
@@ -56,22 +86,12 @@ public:
         try
         {
             using returnType = typename std::result_of<F(Args...)>::type;
-            auto task = std::make_shared<std::packaged_task<returnType()>>(
+            std::packaged_task<returnType()> task(
                 std::bind(std::forward<F>(func), std::forward<Args>(args)...));
 
-            std::future<returnType> result = task->get_future();
-
-            {
-                std::unique_lock<std::mutex> lock(m_queue_mutex);
-
-                if (m_stop)
-                    throw std::runtime_error("enqueue on stopped ThreadPool");
-
-                m_tasks.emplace([task]()
-                                { (*task)(); });
-            }
+            std::future<returnType> result = task.get_future();
+            post(std::move(task));
 
-            m_condition.notify_one();
             return result;
         }
         catch (const std::exception &e)
@@ -81,11 +101,27 @@ public:
     }
 
 private:
+    TaskQueue m_tasks;
+    std::counting_semaphore<> m_ready{0};
+    std::atomic<std::size_t> m_unfinished{0};
+
+    // Submitters sleeping on a full queue, woken as workers take tasks
+    std::counting_semaphore<> m_room{0};
+    std::atomic<std::size_t> m_blocked{0};
+
+    // First exception escaping a task since the last wait_idle()
+    std::mutex m_error_mutex;
+    std::exception_ptr m_error;
+
+    std::atomic<bool> m_stop{false};
+    std::atomic<const Trace *> m_trace{nullptr};
     std::vector<std::thread> m_threads;
-    std::queue<std::function<void()>> m_tasks;
-    std::mutex m_queue_mutex;
-    std::condition_variable m_condition;
-    bool m_stop;
+
+    // Methods
+    void push(Task *, std::size_t);
+    void run(Task &);
+    void wait_unfinished() noexcept;
+    void work(int);
 };
 
-#endif //! THREAD_POOL_H
\ No newline at end of file
+#endif //! THREAD_POOL_H
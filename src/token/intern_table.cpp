@@ -0,0 +1,153 @@
+/**
+ * @file intern_table.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the InternTable class
+ * @version 0.1
+ * @date 2023-06-07
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard libraries
+#include <mutex>
+#include <stdexcept>
+
+// Project files
+#include "intern_table.h"
+#include "../utils/utils.h"
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Intern Table:: Intern Table object
+ * @param shard_bits Base two logarithm of the number of shards
+ * @throw std::invalid_argument If the number of shards is too large
+ */
+InternTable::InternTable(std::size_t shard_bits)
+    : m_shard_bits(shard_bits)
+{
+    if (shard_bits > 16)
+        throw std::invalid_argument("Too many intern table shards");
+
+    m_shard_mask = (std::size_t{1} << shard_bits) - 1;
+    m_shards = std::make_unique<Shard[]>(m_shard_mask + 1);
+}
+
+// Access methods
+/**
+ * @brief
+ * Looks up the ID of a string without interning it
+ * @param value String to look up
+ * @return std::optional<std::uint32_t> ID of the string, if interned
+ */
+std::optional<std::uint32_t> InternTable::find(std::string_view value) const
+{
+    std::size_t index{};
+    const Shard &shard = shard_for(value, index);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+    const auto it = shard.ids.find(value);
+
+    if (it == shard.ids.end())
+        return std::nullopt;
+
+    return it->second;
+}
+
+/**
+ * @brief
+ * Gets the string of an ID
+ * @param id ID returned by intern()
+ * @return std::string_view Interned string, valid while the table lives
+ * @throw std::out_of_range If the ID was not issued by this table
+ */
+std::string_view InternTable::lookup(std::uint32_t id) const
+{
+    const Shard &shard = m_shards[id & m_shard_mask];
+    const std::size_t position = id >> m_shard_bits;
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+    return shard.strings.at(position);
+}
+
+/**
+ * @brief
+ * Gets the number of distinct strings in the table
+ * @return std::size_t Number of strings
+ */
+std::size_t InternTable::size() const
+{
+    std::size_t total{};
+
+    for (std::size_t i{}; i <= m_shard_mask; ++i)
+    {
+        std::shared_lock<std::shared_mutex> lock(m_shards[i].mutex);
+        total += m_shards[i].strings.size();
+    }
+
+    return total;
+}
+
+// Methods (Public)
+/**
+ * @brief
+ * Gets the ID of a string, adding it to the table if needed
+ * @param value String to intern
+ * @return std::uint32_t ID of the string
+ * @throw std::overflow_error If a shard runs out of IDs
+ */
+std::uint32_t InternTable::intern(std::string_view value)
+{
+    std::size_t index{};
+    Shard &shard = shard_for(value, index);
+
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        const auto it = shard.ids.find(value);
+
+        if (it != shard.ids.end())
+            return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+    // Another worker may have interned it between the two locks
+    const auto it = shard.ids.find(value);
+
+    if (it != shard.ids.end())
+        return it->second;
+
+    const std::size_t position = shard.strings.size();
+
+    // The largest ID is reserved for Token::no_id
+    if (position >= (std::size_t{0xFFFFFFFF} >> m_shard_bits))
+        throw std::overflow_error("Intern table shard is full");
+
+    const auto id = static_cast<std::uint32_t>((position << m_shard_bits) |
+                                               index);
+
+    // Deque elements never move, so the key view stays valid
+    const std::string &stored = shard.strings.emplace_back(value);
+    shard.ids.emplace(stored, id);
+
+    return id;
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Selects the shard responsible for a string
+ * @param value String to place
+ * @param index Output index of the shard
+ * @return Shard& Shard of the string
+ */
+InternTable::Shard &InternTable::shard_for(std::string_view value,
+                                           std::size_t &index) const
+{
+    index = static_cast<std::size_t>(utils::hash_bytes(value) >> 40) &
+            m_shard_mask;
+
+    return m_shards[index];
+}
@@ -0,0 +1,79 @@
+/**
+ * @file intern_table.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the InternTable class
+ * @version 0.1
+ * @date 2023-06-07
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef INTERN_TABLE_H
+#define INTERN_TABLE_H
+
+// C++ standard libraries
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief
+ * Concurrent string interning table
+ * @class InternTable
+ * @details
+ * Maps every distinct string to a stable 32-bit ID. The table is split in
+ * shards selected by the hash of the string, each with its own
+ * reader/writer lock, so workers interning different names rarely touch
+ * the same lock and names that are already interned only take a shared
+ * lock. The low bits of an ID are the shard and the high bits the index
+ * of the string inside the shard.
+ */
+class InternTable
+{
+public:
+    // Constructor
+    explicit InternTable(std::size_t shard_bits = 6);
+
+    // Destructor
+    ~InternTable() = default;
+
+    InternTable(const InternTable &) = delete;
+    InternTable &operator=(const InternTable &) = delete;
+
+    // Access methods
+    std::optional<std::uint32_t> find(std::string_view) const;
+    std::string_view lookup(std::uint32_t) const;
+    std::size_t size() const;
+
+    // Methods
+    std::uint32_t intern(std::string_view);
+
+private:
+    /**
+     * @brief
+     * Independent part of the table guarded by its own lock
+     * @struct Shard
+     */
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::deque<std::string> strings;
+        std::unordered_map<std::string_view, std::uint32_t> ids;
+    };
+
+    std::size_t m_shard_bits;
+    std::size_t m_shard_mask;
+    std::unique_ptr<Shard[]> m_shards;
+
+    // Methods
+    Shard &shard_for(std::string_view, std::size_t &) const;
+};
+
+#endif //! INTERN_TABLE_H
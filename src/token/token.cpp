@@ -10,11 +10,9 @@
  *
  */
 
-// C++ standard libraries
-#include <unordered_map>
-
 // Project files
 #include "token.h"
+#include "token_registry.h"
 
 // Constructor
 /**
@@ -33,9 +31,9 @@ Token::Token(std::string value, std::optional<TokenType> type)
 /**
  * @brief
  * Get the value of the token
- * @return std::string Value of the token
+ * @return const std::string& Value of the token
  */
-std::string Token::get_value() const
+const std::string &Token::get_value() const noexcept
 {
     return m_value;
 }
@@ -50,6 +48,176 @@ std::optional<TokenType> Token::get_type() const
     return m_type;
 }
 
+/**
+ * @brief
+ * Get the interned identifier ID of the token
+ * @return std::uint32_t ID of the identifier, Token::no_id otherwise
+ */
+std::uint32_t Token::get_id() const noexcept
+{
+    return m_id;
+}
+
+/**
+ * @brief
+ * Checks whether the token is a keyword
+ * @return true If the type is TokenType::Keyword
+ */
+bool Token::is_keyword() const noexcept
+{
+    return m_type == TokenType::Keyword;
+}
+
+/**
+ * @brief
+ * Checks whether the token is an identifier
+ * @return true If the type is TokenType::Identifier
+ */
+bool Token::is_identifier() const noexcept
+{
+    return m_type == TokenType::Identifier;
+}
+
+/**
+ * @brief
+ * Checks whether the token is a numeric literal
+ * @return true If the type is TokenType::NumericLiteral
+ */
+bool Token::is_numeric_literal() const noexcept
+{
+    return m_type == TokenType::NumericLiteral;
+}
+
+/**
+ * @brief
+ * Checks whether the token is an operator
+ * @return true If the type is TokenType::Operator
+ */
+bool Token::is_operator() const noexcept
+{
+    return m_type == TokenType::Operator;
+}
+
+/**
+ * @brief
+ * Checks whether the token is a separator
+ * @return true If the type is TokenType::Separator
+ */
+bool Token::is_separator() const noexcept
+{
+    return m_type == TokenType::Separator;
+}
+
+/**
+ * @brief
+ * Checks whether the token is a comment
+ * @return true If the type is TokenType::Comment
+ */
+bool Token::is_comment() const noexcept
+{
+    return m_type == TokenType::Comment;
+}
+
+/**
+ * @brief
+ * Checks whether the token is a preprocessor directive
+ * @return true If the type is TokenType::Preprocessor
+ */
+bool Token::is_preprocessor() const noexcept
+{
+    return m_type == TokenType::Preprocessor;
+}
+
+/**
+ * @brief
+ * Checks whether the token is a contextual keyword
+ * @return true If the type is TokenType::ContextualKeyword
+ */
+bool Token::is_contextual_keyword() const noexcept
+{
+    return m_type == TokenType::ContextualKeyword;
+}
+
+/**
+ * @brief
+ * Checks whether the token is an access specifier
+ * @return true If the type is TokenType::AccessSpecifier
+ */
+bool Token::is_access_specifier() const noexcept
+{
+    return m_type == TokenType::AccessSpecifier;
+}
+
+/**
+ * @brief
+ * Checks whether the token is an attribute target
+ * @return true If the type is TokenType::AttributeTarget
+ */
+bool Token::is_attribute_target() const noexcept
+{
+    return m_type == TokenType::AttributeTarget;
+}
+
+/**
+ * @brief
+ * Checks whether the token is an attribute usage
+ * @return true If the type is TokenType::AttributeUsage
+ */
+bool Token::is_attribute_usage() const noexcept
+{
+    return m_type == TokenType::AttributeUsage;
+}
+
+/**
+ * @brief
+ * Checks whether the token is an escaped identifier
+ * @return true If the type is TokenType::EscapedIdentifier
+ */
+bool Token::is_escaped_identifier() const noexcept
+{
+    return m_type == TokenType::EscapedIdentifier;
+}
+
+/**
+ * @brief
+ * Checks whether the token is an interpolated string
+ * @return true If the type is TokenType::InterpolatedStringLiteral
+ */
+bool Token::is_interpolated_string() const noexcept
+{
+    return m_type == TokenType::InterpolatedStringLiteral;
+}
+
+/**
+ * @brief
+ * Checks whether the token is a null literal
+ * @return true If the type is TokenType::NullLiteral
+ */
+bool Token::is_nullable() const noexcept
+{
+    return m_type == TokenType::NullLiteral;
+}
+
+/**
+ * @brief
+ * Checks whether the token is a verbatim string
+ * @return true If the type is TokenType::VerbatimStringLiteral
+ */
+bool Token::is_verbatim_string() const noexcept
+{
+    return m_type == TokenType::VerbatimStringLiteral;
+}
+
+/**
+ * @brief
+ * Checks whether the token is a regular expression
+ * @return true If the type is TokenType::RegularExpressionLiteral
+ */
+bool Token::is_regular_expression() const noexcept
+{
+    return m_type == TokenType::RegularExpressionLiteral;
+}
+
 // Mutator methods
 /**
  * @brief
@@ -71,6 +239,16 @@ void Token::set_type(std::optional<TokenType> type)
     m_type = type.value_or(TokenType::Other);
 }
 
+/**
+ * @brief
+ * Set the interned identifier ID of the token
+ * @param id ID of the identifier
+ */
+void Token::set_id(std::uint32_t id) noexcept
+{
+    m_id = id;
+}
+
 // Operator overloads
 /**
  * @brief
@@ -93,27 +271,7 @@ bool Token::operator==(const Token &other) const
  */
 std::string Token::get_type_string(TokenType type) const
 {
-    static const std::unordered_map<TokenType, std::string> type_strings = {
-        {TokenType::Keyword, "Keyword"},
-        {TokenType::Identifier, "Identifier"},
-        {TokenType::Literal, "Literal"},
-        {TokenType::Operator, "Operator"},
-        {TokenType::Separator, "Separator"},
-        {TokenType::Comment, "Comment"},
-        {TokenType::Preprocessor, "Preprocessor"},
-        {TokenType::ContextualKeyword, "ContextualKeyword"},
-        {TokenType::AccessSpecifier, "AccessSpecifier"},
-        {TokenType::AttributeTarget, "AttributeTarget"},
-        {TokenType::AttributeUsage, "AttributeUsage"},
-        {TokenType::EscapedIdentifier, "EscapedIdentifier"},
-        {TokenType::InterpolatedStringLiteral, "InterpolatedStringLiteral"},
-        {TokenType::NullLiteral, "NullLiteral"},
-        {TokenType::VerbatimStringLiteral, "VerbatimStringLiteral"},
-        {TokenType::RegularExpressionLiteral, "RegularExpressionLiteral"},
-        {TokenType::NumericLiteral, "NumericLiteral"},
-        {TokenType::Other, "Other"}};
-
-    return type_strings.at(type);
+    return ::to_string(type);
 }
 
 // Methods (Public)
@@ -124,5 +282,17 @@ std::string Token::get_type_string(TokenType type) const
  */
 std::string Token::to_string() const
 {
-    return "Token: " + m_value + " (" + get_type_string(m_type) + ")";
+    return get_type_string(m_type) + ": " + m_value;
+}
+
+// Functions
+/**
+ * @brief
+ * Get the name of a token type
+ * @param type Type of the token
+ * @return std::string Name of the token type
+ */
+std::string to_string(TokenType type)
+{
+    return std::string(token_info(type).name);
 }
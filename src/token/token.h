@@ -17,6 +17,7 @@
 #include <string>
 #include <optional>
 #include <ostream>
+#include <cstdint>
 
 /**
  * @brief
@@ -42,9 +43,19 @@ enum class TokenType
     VerbatimStringLiteral,
     RegularExpressionLiteral,
     NumericLiteral,
+    InactiveCode,
     Other
 };
 
+/**
+ * @brief
+ * Number of values of the TokenType enumeration
+ */
+constexpr std::size_t token_type_count =
+    static_cast<std::size_t>(TokenType::Other) + 1;
+
+std::string to_string(TokenType);
+
 /**
  * @brief
  * Class for the tokens of the lexer
@@ -53,6 +64,9 @@ enum class TokenType
 class Token
 {
 public:
+    // Identifier ID of tokens that are not identifiers
+    static constexpr std::uint32_t no_id = 0xFFFFFFFF;
+
     // Constructor
     Token() = default;
     explicit Token(std::string, std::optional<TokenType> = std::nullopt);
@@ -61,12 +75,30 @@ public:
     ~Token() = default;
 
     // Access methods
-    std::string get_value() const;
+    const std::string &get_value() const noexcept;
     std::optional<TokenType> get_type() const;
+    std::uint32_t get_id() const noexcept;
+    bool is_keyword() const noexcept;
+    bool is_identifier() const noexcept;
+    bool is_numeric_literal() const noexcept;
+    bool is_operator() const noexcept;
+    bool is_separator() const noexcept;
+    bool is_comment() const noexcept;
+    bool is_preprocessor() const noexcept;
+    bool is_contextual_keyword() const noexcept;
+    bool is_access_specifier() const noexcept;
+    bool is_attribute_target() const noexcept;
+    bool is_attribute_usage() const noexcept;
+    bool is_escaped_identifier() const noexcept;
+    bool is_interpolated_string() const noexcept;
+    bool is_nullable() const noexcept;
+    bool is_verbatim_string() const noexcept;
+    bool is_regular_expression() const noexcept;
 
     // Mutator methods
     void set_value(std::string);
     void set_type(std::optional<TokenType> type);
+    void set_id(std::uint32_t) noexcept;
 
     // Operator overload
     bool operator==(const Token &) const;
@@ -77,6 +109,7 @@ public:
 private:
     std::string m_value;
     TokenType m_type;
+    std::uint32_t m_id{no_id};
 
     // Functions
     std::string get_type_string(TokenType) const;
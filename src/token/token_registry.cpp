@@ -0,0 +1,94 @@
+/**
+ * @file token_registry.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Generation of the stylesheet from the token registry
+ * @version 0.1
+ * @date 2023-06-25
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard libraries
+#include <cctype>
+
+// Project files
+#include "token_registry.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Gets the CSS variable holding the color of a token type
+     * @param name Name of the token type, in PascalCase
+     * @return std::string Variable name, as in --numeric-literal-color
+     */
+    std::string color_variable(std::string_view name)
+    {
+        std::string variable = "--";
+
+        for (std::size_t i{}; i < name.size(); ++i)
+        {
+            const auto c = static_cast<unsigned char>(name[i]);
+
+            if (std::isupper(c) && i != 0)
+                variable += '-';
+
+            variable += static_cast<char>(std::tolower(c));
+        }
+
+        return variable + "-color";
+    }
+}
+
+/**
+ * @brief
+ * Generates the stylesheet of the HTML output, with one color variable
+ * and one class per token type of the registry
+ * @return std::string Contents of styles.css
+ */
+std::string generate_styles()
+{
+    std::string css =
+        "/* Generated by styles_gen from src/token/token_registry.h, do not edit */\n"
+        "@import url(\"https://fonts.googleapis.com/css2?family=Victor+Mono:"
+        "wght@300;400;700&display=swap\");\n"
+        "\n"
+        "/* Colors */\n"
+        ":root {\n"
+        "  --background-color: #1e1e1e;\n"
+        "  --text-color: #d4d4d4;\n"
+        "  --body-color: #d4d4d4;\n";
+
+    for (const auto &info : token_types)
+        css += "  " + color_variable(info.name) + ": " + std::string(info.color) + ";\n";
+
+    css += "}\n"
+           "\n"
+           "/* Base styles */\n"
+           "code {\n"
+           "  font-family: \"Victor Mono\", monospace;\n"
+           "  font-size: 1em;\n"
+           "  line-height: 1.5em;\n"
+           "  color: var(--body-color);\n"
+           "}\n"
+           "\n"
+           "/* Tokens */\n";
+
+    for (const auto &info : token_types)
+    {
+        css += "." + std::string(info.name) + " {\n  color: var(" +
+               color_variable(info.name) + ");\n";
+
+        if (!info.style.empty())
+            css += "  " + std::string(info.style) + "\n";
+
+        css += "}\n";
+
+        if (&info != &token_types.back())
+            css += "\n";
+    }
+
+    return css;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file token_registry.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Compile-time registry of the token types
+ * @version 0.1
+ * @date 2023-06-25
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef TOKEN_REGISTRY_H
+#define TOKEN_REGISTRY_H
+
+// C++ standard libraries
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Project files
+#include "token.h"
+#include "../utils/csharp_language.h"
+
+/**
+ * @brief
+ * Everything the lexer knows about one token type
+ * @struct TokenTypeInfo
+ */
+struct TokenTypeInfo
+{
+    TokenType type;
+
+    // Name of the type, also its CSS class
+    std::string_view name;
+
+    // Whether the HTML output wraps the tokens in a span of the class
+    bool highlighted;
+
+    // CSS color and extra declarations of the class
+    std::string_view color;
+    std::string_view style;
+
+    // Source words classified as this type
+    std::span<const char *const> words;
+};
+
+/**
+ * @brief
+ * Registry of the token types, in the order of the TokenType enumeration.
+ * Source words that appear in several lists take the first type listed.
+ * Lookup tables, the text names and styles.css are all derived from it.
+ */
+inline constexpr std::array<TokenTypeInfo, token_type_count> token_types{{
+    {TokenType::Keyword, "Keyword", true, "#506d96", "font-weight: bold;",
+     csharp::m_keywords},
+    {TokenType::Identifier, "Identifier", true, "#9cdcfe", "", {}},
+    {TokenType::Literal, "Literal", true, "#d19a66", "", csharp::m_literals},
+    {TokenType::Operator, "Operator", true, "#b5cea8", "", csharp::m_operators},
+    {TokenType::Separator, "Separator", true, "#bfbfbf", "",
+     csharp::m_separators},
+    {TokenType::Comment, "Comment", true, "#6a9955", "font-style: italic;",
+     csharp::m_comments},
+    {TokenType::Preprocessor, "Preprocessor", true, "#d4d4d4", "",
+     csharp::m_preprocessor},
+    {TokenType::ContextualKeyword, "ContextualKeyword", true, "#4ec9b0",
+     "font-weight: bold;", csharp::m_contextual_keywords},
+    {TokenType::AccessSpecifier, "AccessSpecifier", true, "#4ec9b0", "",
+     csharp::m_access_specifiers},
+    {TokenType::AttributeTarget, "AttributeTarget", true, "#c586c0", "",
+     csharp::m_attribute_targets},
+    {TokenType::AttributeUsage, "AttributeUsage", true, "#c586c0", "",
+     csharp::m_attribute_usage},
+    {TokenType::EscapedIdentifier, "EscapedIdentifier", true, "#9cdcfe", "",
+     csharp::m_escaped_identifiers},
+    {TokenType::InterpolatedStringLiteral, "InterpolatedStringLiteral", true,
+     "#ce9178", "", csharp::m_interpolated_strings},
+    {TokenType::NullLiteral, "NullLiteral", true, "#569cd6", "",
+     csharp::m_nullables},
+    {TokenType::VerbatimStringLiteral, "VerbatimStringLiteral", true,
+     "#ce9178", "", csharp::m_verbatim_strings},
+    {TokenType::RegularExpressionLiteral, "RegularExpressionLiteral", true,
+     "#d16969", "", {}},
+    {TokenType::NumericLiteral, "NumericLiteral", true, "#d19a66", "", {}},
+    {TokenType::InactiveCode, "InactiveCode", true, "#808080", "opacity: 0.6;",
+     {}},
+    {TokenType::Other, "Other", false, "#d4d4d4", "", {}},
+}};
+
+/**
+ * @brief
+ * Gets the registry entry of a token type
+ * @param type Type of the token
+ * @return const TokenTypeInfo& Entry of the type
+ */
+constexpr const TokenTypeInfo &token_info(TokenType type)
+{
+    return token_types[static_cast<std::size_t>(type)];
+}
+
+/**
+ * @brief
+ * Gets the token type of a name, the inverse of to_string
+ * @param name Name of the type, as in "Keyword"
+ * @return std::optional<TokenType> Type, none if no type has the name
+ */
+constexpr std::optional<TokenType> token_type_of(std::string_view name)
+{
+    for (const auto &info : token_types)
+        if (info.name == name)
+            return info.type;
+
+    return std::nullopt;
+}
+
+namespace token_registry
+{
+    /**
+     * @brief
+     * Checks that every entry sits at the index of its type
+     * @return true If the registry follows the enumeration
+     */
+    consteval bool is_ordered()
+    {
+        for (std::size_t i{}; i < token_types.size(); ++i)
+            if (static_cast<std::size_t>(token_types[i].type) != i)
+                return false;
+
+        return true;
+    }
+
+    static_assert(is_ordered(), "token_types must follow the TokenType order");
+
+    constexpr std::string_view tag_open = "<span class=\"";
+    constexpr std::string_view tag_close = "\">";
+
+    /**
+     * @brief
+     * Number of characters of all the opening tags together
+     * @return std::size_t Size of the tag storage
+     */
+    consteval std::size_t tags_size()
+    {
+        std::size_t size{};
+
+        for (const auto &info : token_types)
+            if (info.highlighted)
+                size += tag_open.size() + info.name.size() + tag_close.size();
+
+        return size;
+    }
+
+    /**
+     * @brief
+     * Characters of the opening tags, one after the other
+     */
+    inline constexpr auto tag_storage = []()
+    {
+        std::array<char, tags_size()> storage{};
+        std::size_t position{};
+
+        auto append = [&](std::string_view text)
+        {
+            for (const char c : text)
+                storage[position++] = c;
+        };
+
+        for (const auto &info : token_types)
+        {
+            if (!info.highlighted)
+                continue;
+
+            append(tag_open);
+            append(info.name);
+            append(tag_close);
+        }
+
+        return storage;
+    }();
+}
+
+/**
+ * @brief
+ * Opening HTML tag of every token type, indexed by type, empty for the
+ * types that are not highlighted
+ */
+inline constexpr std::array<std::string_view, token_type_count> token_html_tags = []()
+{
+    std::array<std::string_view, token_type_count> tags{};
+    std::size_t position{};
+
+    for (const auto &info : token_types)
+    {
+        if (!info.highlighted)
+            continue;
+
+        const auto size = token_registry::tag_open.size() + info.name.size() +
+                          token_registry::tag_close.size();
+
+        tags[static_cast<std::size_t>(info.type)] =
+            std::string_view(token_registry::tag_storage.data() + position, size);
+        position += size;
+    }
+
+    return tags;
+}();
+
+/**
+ * @brief
+ * Total number of source words of the registry
+ * @return std::size_t Number of words
+ */
+constexpr std::size_t token_word_count()
+{
+    std::size_t count{};
+
+    for (const auto &info : token_types)
+        count += info.words.size();
+
+    return count;
+}
+
+std::string generate_styles();
+
+#endif //! TOKEN_REGISTRY_H
@@ -0,0 +1,118 @@
+/**
+ * @file bench.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the benchmark helpers
+ * @version 0.1
+ * @date 2023-06-21
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+
+// POSIX
+#include <fcntl.h>
+#include <unistd.h>
+
+// Project files
+#include "bench.h"
+
+namespace utils
+{
+    /**
+     * @brief
+     * Gets a percentile of sorted samples, by the nearest rank method, so
+     * the result is always one of the samples
+     * @param sorted Samples in ascending order
+     * @param fraction Percentile between 0 and 1
+     * @return double Percentile, 0 without samples
+     */
+    double percentile(const std::vector<double> &sorted, double fraction)
+    {
+        if (sorted.empty())
+            return 0;
+
+        const auto rank = static_cast<std::size_t>(
+            std::ceil(fraction * static_cast<double>(sorted.size())));
+
+        return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    /**
+     * @brief
+     * Summarizes the timings of repeated runs
+     * @param samples Timings of the runs
+     * @return Summary Mean, sample standard deviation, median, 99th
+     *         percentile and range of the timings
+     */
+    Summary summarize(std::vector<double> samples)
+    {
+        Summary summary;
+
+        if (samples.empty())
+            return summary;
+
+        std::sort(samples.begin(), samples.end());
+
+        const auto count = static_cast<double>(samples.size());
+        summary.count = samples.size();
+        summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / count;
+
+        if (samples.size() > 1)
+        {
+            double squares{};
+
+            for (const auto sample : samples)
+                squares += (sample - summary.mean) * (sample - summary.mean);
+
+            summary.stddev = std::sqrt(squares / (count - 1));
+        }
+
+        summary.p50 = percentile(samples, 0.50);
+        summary.p99 = percentile(samples, 0.99);
+        summary.min = samples.front();
+        summary.max = samples.back();
+
+        return summary;
+    }
+
+    /**
+     * @brief
+     * Evicts files from the page cache so the next run reads them from the
+     * disk. Dirty pages are written back first. The whole cache is dropped
+     * when the process may write to /proc/sys/vm/drop_caches; otherwise
+     * only the pages of the given files are, which needs no privileges
+     * @param filenames Files to evict when the whole cache cannot be
+     * @return true If the whole page cache was dropped
+     */
+    bool drop_page_caches(const std::vector<std::string> &filenames)
+    {
+        ::sync();
+
+        {
+            std::ofstream drop_caches("/proc/sys/vm/drop_caches");
+
+            if (drop_caches && (drop_caches << "1").flush())
+                return true;
+        }
+
+        for (const auto &filename : filenames)
+        {
+            const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+
+            if (fd < 0)
+                continue;
+
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,44 @@
+/**
+ * @file bench.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the benchmark helpers
+ * @version 0.1
+ * @date 2023-06-21
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+// C++ standard library
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+    /**
+     * @brief
+     * Summary of the timings of repeated runs, in the unit of the samples
+     * @struct Summary
+     */
+    struct Summary
+    {
+        std::size_t count{0};
+        double mean{0};
+        double stddev{0};
+        double p50{0};
+        double p99{0};
+        double min{0};
+        double max{0};
+    };
+
+    double percentile(const std::vector<double> &sorted, double fraction);
+    Summary summarize(std::vector<double> samples);
+    bool drop_page_caches(const std::vector<std::string> &filenames);
+}
+
+#endif //! BENCH_H
@@ -0,0 +1,53 @@
+/**
+ * @file binary.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Helpers to write and read the integers of binary files
+ * @version 0.1
+ * @date 2023-06-27
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef BINARY_H
+#define BINARY_H
+
+// C++ standard library
+#include <cstring>
+#include <string>
+
+namespace utils
+{
+    /**
+     * @brief
+     * Appends an integer to a buffer in the byte order of the host
+     * @tparam T Integer type
+     * @param buffer Buffer to append to
+     * @param value Value to append
+     */
+    template <class T>
+    void append_integer(std::string &buffer, T value)
+    {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        buffer.append(bytes, sizeof(T));
+    }
+
+    /**
+     * @brief
+     * Reads an integer stored in the byte order of the host
+     * @tparam T Integer type
+     * @param data Bytes to read, at least sizeof(T) of them
+     * @return T Value read
+     */
+    template <class T>
+    T load_integer(const char *data) noexcept
+    {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+}
+
+#endif //! BINARY_H
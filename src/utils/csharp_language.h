@@ -12,6 +12,9 @@
 
 #pragma once
 
+// C++ standard libraries
+#include <array>
+
 namespace csharp
 {
     // Array data for the tokens (basic)
@@ -20,7 +23,7 @@ namespace csharp
      * Array of C# keywords for the lexer
      * @constexpr std::array<const char *, 77> keywords
      */
-    constexpr std::array<const char *, 77> m_keywords = {
+    inline constexpr std::array<const char *, 77> m_keywords = {
         "abstract", "as", "base", "bool", "break", "byte", "case", "catch", "char", "checked", "class", "const", "continue", "decimal", "default", "delegate", "do", "double", "else", "enum", "event", "explicit", "extern", "false", "finally", "fixed", "float", "for", "foreach", "goto", "if", "implicit", "in", "int", "interface", "internal", "is", "lock", "long", "namespace", "new", "null", "object", "operator", "out", "override", "params", "private", "protected", "public", "readonly", "ref", "return", "sbyte", "sealed", "short", "sizeof", "stackalloc", "static", "string", "struct", "switch", "this", "throw", "true", "try", "typeof", "uint", "ulong", "unchecked", "unsafe", "ushort", "using", "virtual", "void", "volatile", "while"};
 
     /**
@@ -28,7 +31,7 @@ namespace csharp
      * Array of C# operators for the lexer
      * @constexpr std::array<const char *, 35> operators
      */
-    constexpr std::array<const char *, 38> m_operators = {
+    inline constexpr std::array<const char *, 38> m_operators = {
         "+", "-", "*", "/", "%", "++", "--", "+=", "-=", "*=", "/=", "%=", "==", "!=", ">", "<", ">=", "<=", "&&", "||", "!", "&", "|", "^", "~", "<<", ">>", ">>=", "<<=", "&=", "|=", "^=", "??", "=>", "is", "as", ":", "::"};
 
     /**
@@ -36,7 +39,7 @@ namespace csharp
      * Array of C# separators for the lexer
      * @constexpr std::array<const char *, 12> separators
      */
-    constexpr std::array<const char *, 12> m_separators = {
+    inline constexpr std::array<const char *, 12> m_separators = {
         "(", ")", "{", "}", "[", "]", ",", ";", ":", "?", ".", "::"};
 
     /**
@@ -45,7 +48,7 @@ namespace csharp
      * @constexpr std::array<const char *, 3> comments
      * @note The last element is an empty string to avoid a bug in the lexer
      */
-    constexpr std::array<const char *, 4> m_comments = {
+    inline constexpr std::array<const char *, 4> m_comments = {
         "//", "/*", "*/", ""};
 
     /**
@@ -53,24 +56,25 @@ namespace csharp
      * Array of C# literals for the lexer
      * @constexpr std::array<const char *, 5> literals
      */
-    constexpr std::array<const char *, 5> m_literals = {
+    inline constexpr std::array<const char *, 5> m_literals = {
         "true", "false", "null", "this", "base"};
 
     /**
      * @brief
      * Array of C# preprocessor directives for the lexer
-     * @constexpr std::array<const char *, 12> preprocessor_directives
+     * @constexpr std::array<const char *, 15> preprocessor_directives
      */
-    constexpr std::array<const char *, 12> m_preprocessor = {
+    inline constexpr std::array<const char *, 15> m_preprocessor = {
         "#define", "#undef", "#if", "#ifdef", "#ifndef", "#else", "#elif", "#endif",
-        "#error", "#warning", "#line", "#pragma"};
+        "#error", "#warning", "#line", "#pragma", "#region", "#endregion",
+        "#nullable"};
 
     /**
      * @brief
      * Array of C# contextual keywords for the lexer
      * @constexpr std::array<const char *, 3> contextual_keywords
      */
-    constexpr std::array<const char *, 3> m_contextual_keywords = {
+    inline constexpr std::array<const char *, 3> m_contextual_keywords = {
         "var", "nameof", "yield"};
 
     // Array data for the tokens (advanced)
@@ -79,7 +83,7 @@ namespace csharp
      * Array of C# access specifiers for the lexer
      * @constexpr std::array<const char *, 6> access_specifiers
      */
-    constexpr std::array<const char *, 6> m_access_specifiers = {
+    inline constexpr std::array<const char *, 6> m_access_specifiers = {
         "public", "private", "protected", "internal", "protected internal", "private protected"};
 
     /**
@@ -87,7 +91,7 @@ namespace csharp
      * Array of C# attribute targets for the lexer
      * @constexpr std::array<const char *, 4> attribute_targets
      */
-    constexpr std::array<const char *, 4> m_attribute_targets = {
+    inline constexpr std::array<const char *, 4> m_attribute_targets = {
         "assembly", "field", "method", "return"};
 
     /**
@@ -95,7 +99,7 @@ namespace csharp
      * Array of C# attribute usages for the lexer
      * @constexpr std::array<const char *, 3> attribute_usages
      */
-    constexpr std::array<const char *, 3> m_attribute_usage = {
+    inline constexpr std::array<const char *, 3> m_attribute_usage = {
         "attribute", "extern", "assembly"};
 
     /**
@@ -103,7 +107,7 @@ namespace csharp
      * Array of C# escaped identifiers for the lexer
      * @constexpr std::array<const char *, 2> escaped_identifiers
      */
-    constexpr std::array<const char *, 2> m_escaped_identifiers = {
+    inline constexpr std::array<const char *, 2> m_escaped_identifiers = {
         "@", "__arglist"};
 
     /**
@@ -111,7 +115,7 @@ namespace csharp
      * Array of C# interpolated strings for the lexer
      * @constexpr std::array<const char *, 2> interpolated_strings
      */
-    constexpr std::array<const char *, 2> m_interpolated_strings = {
+    inline constexpr std::array<const char *, 2> m_interpolated_strings = {
         "$", "@$"};
 
     /**
@@ -119,7 +123,7 @@ namespace csharp
      * Array of C# nullables for the lexer
      * @constexpr std::array<const char *, 2> nullables
      */
-    constexpr std::array<const char *, 2> m_nullables = {
+    inline constexpr std::array<const char *, 2> m_nullables = {
         "?", "??"};
 
     /**
@@ -127,6 +131,6 @@ namespace csharp
      * Array of C# preprocessor directives for the lexer
      * @constexpr std::array<const char *, 12> preprocessor_directives
      */
-    constexpr std::array<const char *, 2> m_verbatim_strings = {
+    inline constexpr std::array<const char *, 2> m_verbatim_strings = {
         "@", "@\"\""};
 }
\ No newline at end of file
@@ -0,0 +1,394 @@
+/**
+ * @file encoding.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the text encoding helpers
+ * @version 0.1
+ * @date 2023-06-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Project files
+#include "encoding.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Number of leading bytes inspected to recognise UTF-16 without a BOM
+     */
+    constexpr std::size_t sniff_length = 4096;
+
+    /**
+     * @brief
+     * UTF-8 encoding of U+FFFD, written for malformed UTF-16
+     */
+    constexpr char replacement[] = "\xEF\xBF\xBD";
+
+    /**
+     * @brief
+     * Reads a byte as an unsigned value
+     * @param data Buffer
+     * @param index Offset of the byte
+     * @return unsigned Byte value
+     */
+    inline unsigned byte_at(const std::string_view &data, std::size_t index)
+    {
+        return static_cast<unsigned char>(data[index]);
+    }
+
+    /**
+     * @brief
+     * Finds the first byte that is not ASCII
+     * @details Checks 16 bytes per step with SSE2, or 8 bytes per step on
+     * other targets, so ASCII text is validated at close to memory speed.
+     * @param data Buffer to scan
+     * @param begin Offset to start at
+     * @return std::size_t Offset of the first non ASCII byte, or the size
+     */
+    std::size_t skip_ascii(const std::string_view &data, std::size_t begin)
+    {
+        const char *bytes = data.data();
+        std::size_t i = begin;
+
+#if defined(__SSE2__)
+        for (; i + 16 <= data.size(); i += 16)
+        {
+            const auto block = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(bytes + i));
+            const auto mask = _mm_movemask_epi8(block);
+
+            if (mask != 0)
+                return i + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+#else
+        for (; i + 8 <= data.size(); i += 8)
+        {
+            std::uint64_t block;
+            std::memcpy(&block, bytes + i, sizeof(block));
+
+            if (block & 0x8080808080808080ull)
+                break;
+        }
+#endif
+
+        while (i < data.size() && byte_at(data, i) < 0x80)
+            ++i;
+
+        return i;
+    }
+
+    /**
+     * @brief
+     * Checks one multi-byte UTF-8 sequence against RFC 3629: no overlong
+     * forms, no surrogates and nothing above U+10FFFF
+     * @param data Buffer
+     * @param i Offset of the lead byte
+     * @return std::size_t Length of the sequence, 0 if it is invalid
+     */
+    std::size_t utf8_sequence_length(const std::string_view &data,
+                                     std::size_t i)
+    {
+        const unsigned lead = byte_at(data, i);
+        std::size_t length{};
+        unsigned low = 0x80;
+        unsigned high = 0xBF;
+
+        if (lead >= 0xC2 && lead <= 0xDF)
+            length = 2;
+        else if (lead >= 0xE0 && lead <= 0xEF)
+        {
+            length = 3;
+            low = lead == 0xE0 ? 0xA0 : 0x80;
+            high = lead == 0xED ? 0x9F : 0xBF;
+        }
+        else if (lead >= 0xF0 && lead <= 0xF4)
+        {
+            length = 4;
+            low = lead == 0xF0 ? 0x90 : 0x80;
+            high = lead == 0xF4 ? 0x8F : 0xBF;
+        }
+        else
+            return 0;
+
+        if (i + length > data.size())
+            return 0;
+
+        // The first continuation byte has the tighter range
+        const unsigned second = byte_at(data, i + 1);
+
+        if (second < low || second > high)
+            return 0;
+
+        for (std::size_t k{2}; k < length; ++k)
+        {
+            const unsigned next = byte_at(data, i + k);
+
+            if (next < 0x80 || next > 0xBF)
+                return 0;
+        }
+
+        return length;
+    }
+
+    /**
+     * @brief
+     * Writes a code point as UTF-8
+     * @param output Output position, advanced past the written bytes
+     * @param code Code point
+     */
+    inline void write_utf8(char *&output, std::uint32_t code)
+    {
+        if (code < 0x80)
+            *output++ = static_cast<char>(code);
+        else if (code < 0x800)
+        {
+            *output++ = static_cast<char>(0xC0 | (code >> 6));
+            *output++ = static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            *output++ = static_cast<char>(0xE0 | (code >> 12));
+            *output++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            *output++ = static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            *output++ = static_cast<char>(0xF0 | (code >> 18));
+            *output++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            *output++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            *output++ = static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+}
+
+namespace utils
+{
+    /**
+     * @brief
+     * Gets the length of the byte order mark at the start of a buffer
+     * @param data Buffer
+     * @return std::size_t 3 for UTF-8, 2 for UTF-16, 0 without a BOM
+     */
+    std::size_t bom_length(const std::string_view &data) noexcept
+    {
+        if (data.size() >= 3 && byte_at(data, 0) == 0xEF &&
+            byte_at(data, 1) == 0xBB && byte_at(data, 2) == 0xBF)
+            return 3;
+
+        if (data.size() >= 2 &&
+            ((byte_at(data, 0) == 0xFF && byte_at(data, 1) == 0xFE) ||
+             (byte_at(data, 0) == 0xFE && byte_at(data, 1) == 0xFF)))
+            return 2;
+
+        return 0;
+    }
+
+    /**
+     * @brief
+     * Detects the encoding of a source file
+     * @details A BOM decides. Without one, UTF-16 is recognised by the
+     * zero high bytes of ASCII characters, which never appear in UTF-8
+     * source. Anything else is UTF-8 if it validates, Latin-1 otherwise.
+     * @param data Contents of the file
+     * @return Encoding Detected encoding
+     */
+    Encoding detect_encoding(const std::string_view &data) noexcept
+    {
+        if (bom_length(data) == 3)
+            return Encoding::Utf8;
+
+        if (bom_length(data) == 2)
+            return byte_at(data, 0) == 0xFF ? Encoding::Utf16LE
+                                            : Encoding::Utf16BE;
+
+        const auto sample = std::min(data.size(), sniff_length) & ~std::size_t{1};
+        std::size_t even_zeros{};
+        std::size_t odd_zeros{};
+
+        for (std::size_t i{}; i < sample; i += 2)
+        {
+            even_zeros += data[i] == '\0';
+            odd_zeros += data[i + 1] == '\0';
+        }
+
+        const auto units = sample / 2;
+
+        if (units != 0 && odd_zeros * 2 >= units && even_zeros * 20 < units)
+            return Encoding::Utf16LE;
+
+        if (units != 0 && even_zeros * 2 >= units && odd_zeros * 20 < units)
+            return Encoding::Utf16BE;
+
+        return is_valid_utf8(data) ? Encoding::Utf8 : Encoding::Latin1;
+    }
+
+    /**
+     * @brief
+     * Validates UTF-8. ASCII runs are skipped a vector at a time and only
+     * multi-byte sequences are checked byte by byte
+     * @param data Buffer to validate
+     * @return true If the buffer is well formed UTF-8
+     */
+    bool is_valid_utf8(const std::string_view &data) noexcept
+    {
+        for (std::size_t i = skip_ascii(data, 0); i < data.size();
+             i = skip_ascii(data, i))
+        {
+            const auto length = utf8_sequence_length(data, i);
+
+            if (length == 0)
+                return false;
+
+            i += length;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief
+     * Transcodes UTF-16 to UTF-8. Runs of ASCII characters are narrowed
+     * eight at a time with SSE2. Unpaired surrogates and a trailing odd
+     * byte become U+FFFD.
+     * @param data UTF-16 bytes, without the BOM
+     * @param big_endian Whether the code units are big endian
+     * @return std::string UTF-8 text
+     */
+    std::string decode_utf16(const std::string_view &data, bool big_endian)
+    {
+        const auto units = data.size() / 2;
+        const auto *bytes = reinterpret_cast<const unsigned char *>(data.data());
+
+        // Every unit takes at most 3 bytes, a surrogate pair takes 4
+        std::string result(units * 3 + sizeof(replacement), '\0');
+        char *output = result.data();
+
+        auto unit_at = [&](std::size_t index) -> std::uint32_t
+        {
+            const unsigned first = bytes[2 * index];
+            const unsigned second = bytes[2 * index + 1];
+
+            return big_endian ? (first << 8) | second : (second << 8) | first;
+        };
+
+        std::size_t i{};
+
+        while (i < units)
+        {
+#if defined(__SSE2__)
+            if (i + 8 <= units)
+            {
+                auto block = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(bytes + 2 * i));
+
+                if (big_endian)
+                    block = _mm_or_si128(_mm_slli_epi16(block, 8),
+                                         _mm_srli_epi16(block, 8));
+
+                const auto high = _mm_and_si128(block, _mm_set1_epi16(
+                                                           static_cast<short>(0xFF80)));
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(
+                        high, _mm_setzero_si128())) == 0xFFFF)
+                {
+                    _mm_storel_epi64(reinterpret_cast<__m128i *>(output),
+                                     _mm_packus_epi16(block, block));
+                    output += 8;
+                    i += 8;
+                    continue;
+                }
+            }
+#endif
+
+            const auto unit = unit_at(i++);
+
+            if (unit < 0xD800 || unit > 0xDFFF)
+            {
+                write_utf8(output, unit);
+                continue;
+            }
+
+            const auto next = i < units ? unit_at(i) : 0;
+
+            if (unit <= 0xDBFF && next >= 0xDC00 && next <= 0xDFFF)
+            {
+                write_utf8(output,
+                           0x10000 + ((unit - 0xD800) << 10) + (next - 0xDC00));
+                ++i;
+                continue;
+            }
+
+            output = std::copy_n(replacement, 3, output);
+        }
+
+        if (data.size() % 2 != 0)
+            output = std::copy_n(replacement, 3, output);
+
+        result.resize(static_cast<std::size_t>(output - result.data()));
+        return result;
+    }
+
+    /**
+     * @brief
+     * Transcodes Latin-1 to UTF-8
+     * @param data Latin-1 bytes
+     * @return std::string UTF-8 text
+     */
+    std::string decode_latin1(const std::string_view &data)
+    {
+        std::string result;
+        result.reserve(data.size() + data.size() / 8);
+
+        for (std::size_t i{}; i < data.size();)
+        {
+            const auto ascii_end = skip_ascii(data, i);
+            result.append(data.substr(i, ascii_end - i));
+
+            for (i = ascii_end; i < data.size() && byte_at(data, i) >= 0x80; ++i)
+            {
+                result += static_cast<char>(0xC0 | (byte_at(data, i) >> 6));
+                result += static_cast<char>(0x80 | (byte_at(data, i) & 0x3F));
+            }
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief
+     * Converts the contents of a source file to UTF-8 without a BOM. Valid
+     * UTF-8 is returned as is, after a single validation pass
+     * @param data Contents of the file
+     * @return std::string UTF-8 text
+     */
+    std::string to_utf8(std::string data)
+    {
+        const auto bom = bom_length(data);
+
+        switch (detect_encoding(data))
+        {
+        case Encoding::Utf16LE:
+            return decode_utf16(std::string_view(data).substr(bom), false);
+        case Encoding::Utf16BE:
+            return decode_utf16(std::string_view(data).substr(bom), true);
+        case Encoding::Latin1:
+            return decode_latin1(data);
+        case Encoding::Utf8:
+        default:
+            data.erase(0, bom);
+            return data;
+        }
+    }
+}
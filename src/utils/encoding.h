@@ -0,0 +1,44 @@
+/**
+ * @file encoding.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the text encoding helpers
+ * @version 0.1
+ * @date 2023-06-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef ENCODING_H
+#define ENCODING_H
+
+// C++ standard library
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace utils
+{
+    /**
+     * @brief
+     * Encodings a source file can be stored in
+     * @enum Encoding
+     */
+    enum class Encoding
+    {
+        Utf8,
+        Utf16LE,
+        Utf16BE,
+        Latin1
+    };
+
+    std::size_t bom_length(const std::string_view &data) noexcept;
+    Encoding detect_encoding(const std::string_view &data) noexcept;
+    bool is_valid_utf8(const std::string_view &data) noexcept;
+    std::string decode_utf16(const std::string_view &data, bool big_endian);
+    std::string decode_latin1(const std::string_view &data);
+    std::string to_utf8(std::string data);
+}
+
+#endif //! ENCODING_H
@@ -0,0 +1,84 @@
+/**
+ * @file fsharp_language.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the F# language constants
+ * @version 0.1
+ * @date 2023-06-26
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+// C++ standard libraries
+#include <array>
+
+namespace fsharp
+{
+    /**
+     * @brief
+     * Array of F# keywords for the lexer
+     * @constexpr std::array<const char *, 64> keywords
+     */
+    inline constexpr std::array<const char *, 64> m_keywords = {
+        "abstract", "and", "as", "assert", "base", "begin", "class", "const", "default", "delegate", "do", "done", "downcast", "downto", "elif", "else", "end", "exception", "extern", "finally", "fixed", "for", "fun", "function", "global", "if", "in", "inherit", "inline", "interface", "lazy", "let", "match", "member", "module", "mutable", "namespace", "new", "not", "of", "open", "or", "override", "rec", "return", "select", "sig", "static", "struct", "then", "to", "try", "type", "upcast", "use", "val", "void", "when", "while", "with", "yield", "unit", "int", "string"};
+
+    /**
+     * @brief
+     * Array of F# operators for the lexer
+     * @constexpr std::array<const char *, 24> operators
+     */
+    inline constexpr std::array<const char *, 24> m_operators = {
+        "+", "-", "*", "/", "%", "=", "<>", "<", ">", "<=", ">=", "&&", "||", "!", "->", "<-", "|>", "<|", ">>", "<<", "::", ":=", "@", "^"};
+
+    /**
+     * @brief
+     * Array of F# separators for the lexer
+     * @constexpr std::array<const char *, 11> separators
+     */
+    inline constexpr std::array<const char *, 11> m_separators = {
+        "(", ")", "[", "]", "{", "}", ",", ";", ".", ":", "|"};
+
+    /**
+     * @brief
+     * Array of F# literals for the lexer
+     * @constexpr std::array<const char *, 4> literals
+     */
+    inline constexpr std::array<const char *, 4> m_literals = {
+        "true", "false", "null", "this"};
+
+    /**
+     * @brief
+     * Array of F# preprocessor directives for the lexer
+     * @constexpr std::array<const char *, 9> preprocessor_directives
+     */
+    inline constexpr std::array<const char *, 9> m_preprocessor = {
+        "#if", "#else", "#endif", "#light", "#load", "#r", "#nowarn", "#I",
+        "#time"};
+
+    /**
+     * @brief
+     * Array of F# contextual keywords for the lexer
+     * @constexpr std::array<const char *, 5> contextual_keywords
+     */
+    inline constexpr std::array<const char *, 5> m_contextual_keywords = {
+        "async", "seq", "task", "query", "printfn"};
+
+    /**
+     * @brief
+     * Array of F# access specifiers for the lexer
+     * @constexpr std::array<const char *, 3> access_specifiers
+     */
+    inline constexpr std::array<const char *, 3> m_access_specifiers = {
+        "public", "private", "internal"};
+
+    /**
+     * @brief
+     * Array of F# comments for the lexer
+     * @constexpr std::array<const char *, 3> comments
+     */
+    inline constexpr std::array<const char *, 3> m_comments = {
+        "//", "(*", "*)"};
+}
@@ -0,0 +1,530 @@
+/**
+ * @file json.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the JSON reader
+ * @version 0.1
+ * @date 2023-06-28
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+// Project files
+#include "json.h"
+
+namespace utils
+{
+    /**
+     * @brief
+     * Recursive descent parser of a JSON document
+     * @class JsonParser
+     */
+    class JsonParser
+    {
+    public:
+        // Constructor
+        explicit JsonParser(std::string_view text) : m_text(text) {}
+
+        // Methods
+        /**
+         * @brief
+         * Parses the whole document
+         * @return JsonValue Root value
+         * @throw std::runtime_error If the document is not valid JSON
+         */
+        JsonValue parse()
+        {
+            auto value = parse_value(0);
+            skip_spaces();
+
+            if (m_position != m_text.size())
+                fail("unexpected data after the document");
+
+            return value;
+        }
+
+    private:
+        // Nesting limit, so that a hostile document cannot exhaust the stack
+        static constexpr std::size_t max_depth = 256;
+
+        std::string_view m_text;
+        std::size_t m_position{0};
+
+        /**
+         * @brief
+         * Throws a parse error at the current position
+         * @param message Description of the error
+         * @throw std::runtime_error Always
+         */
+        [[noreturn]] void fail(const std::string &message) const
+        {
+            throw std::runtime_error("Invalid JSON at offset " +
+                                     std::to_string(m_position) + ": " +
+                                     message);
+        }
+
+        /**
+         * @brief
+         * Skips the whitespace before the next token
+         */
+        void skip_spaces() noexcept
+        {
+            while (m_position < m_text.size() &&
+                   (m_text[m_position] == ' ' || m_text[m_position] == '\t' ||
+                    m_text[m_position] == '\n' || m_text[m_position] == '\r'))
+                ++m_position;
+        }
+
+        /**
+         * @brief
+         * Consumes a character if it comes next
+         * @param c Expected character
+         * @return true If the character was consumed
+         */
+        bool consume(char c) noexcept
+        {
+            skip_spaces();
+
+            if (m_position < m_text.size() && m_text[m_position] == c)
+            {
+                ++m_position;
+                return true;
+            }
+
+            return false;
+        }
+
+        /**
+         * @brief
+         * Consumes a character that must come next
+         * @param c Expected character
+         * @throw std::runtime_error If another character comes next
+         */
+        void expect(char c)
+        {
+            if (!consume(c))
+                fail(std::string("expected '") + c + "'");
+        }
+
+        /**
+         * @brief
+         * Parses any value
+         * @param depth Nesting depth of the value
+         * @return JsonValue Parsed value
+         */
+        JsonValue parse_value(std::size_t depth)
+        {
+            if (depth > max_depth)
+                fail("nested too deeply");
+
+            skip_spaces();
+
+            if (m_position >= m_text.size())
+                fail("unexpected end of the document");
+
+            JsonValue value;
+            const char c = m_text[m_position];
+
+            if (c == '{')
+            {
+                ++m_position;
+                value.m_kind = JsonValue::Kind::Object;
+
+                if (consume('}'))
+                    return value;
+
+                do
+                {
+                    skip_spaces();
+                    auto name = parse_string();
+                    expect(':');
+                    value.m_members.emplace_back(std::move(name),
+                                                 parse_value(depth + 1));
+                } while (consume(','));
+
+                expect('}');
+            }
+            else if (c == '[')
+            {
+                ++m_position;
+                value.m_kind = JsonValue::Kind::Array;
+
+                if (consume(']'))
+                    return value;
+
+                do
+                    value.m_items.push_back(parse_value(depth + 1));
+                while (consume(','));
+
+                expect(']');
+            }
+            else if (c == '"')
+            {
+                value.m_kind = JsonValue::Kind::String;
+                value.m_text = parse_string();
+            }
+            else if (c == '-' || (c >= '0' && c <= '9'))
+            {
+                value.m_kind = JsonValue::Kind::Number;
+                value.m_text = parse_number();
+            }
+            else if (m_text.substr(m_position, 4) == "true")
+            {
+                m_position += 4;
+                value.m_kind = JsonValue::Kind::Boolean;
+                value.m_boolean = true;
+            }
+            else if (m_text.substr(m_position, 5) == "false")
+            {
+                m_position += 5;
+                value.m_kind = JsonValue::Kind::Boolean;
+            }
+            else if (m_text.substr(m_position, 4) == "null")
+                m_position += 4;
+            else
+                fail("unexpected character");
+
+            return value;
+        }
+
+        /**
+         * @brief
+         * Parses a number, keeping its text
+         * @return std::string Text of the number
+         */
+        std::string parse_number()
+        {
+            const auto begin = m_position;
+
+            if (m_text[m_position] == '-')
+                ++m_position;
+
+            while (m_position < m_text.size() &&
+                   ((m_text[m_position] >= '0' && m_text[m_position] <= '9') ||
+                    m_text[m_position] == '.' || m_text[m_position] == 'e' ||
+                    m_text[m_position] == 'E' || m_text[m_position] == '+' ||
+                    m_text[m_position] == '-'))
+                ++m_position;
+
+            return std::string(m_text.substr(begin, m_position - begin));
+        }
+
+        /**
+         * @brief
+         * Parses four hexadecimal digits of a \u escape
+         * @return unsigned Code unit
+         */
+        unsigned parse_hex()
+        {
+            if (m_text.size() - m_position < 4)
+                fail("truncated escape");
+
+            unsigned code{};
+            const auto digits = m_text.substr(m_position, 4);
+            const auto [end, error] = std::from_chars(digits.data(),
+                                                      digits.data() + 4, code, 16);
+
+            if (error != std::errc{} || end != digits.data() + 4)
+                fail("invalid escape");
+
+            m_position += 4;
+            return code;
+        }
+
+        /**
+         * @brief
+         * Parses a string, decoding its escapes. Other bytes are kept as
+         * they are, so a string cut inside a UTF-8 sequence reads back the
+         * same
+         * @return std::string Contents of the string
+         */
+        std::string parse_string()
+        {
+            if (m_position >= m_text.size() || m_text[m_position] != '"')
+                fail("expected a string");
+
+            ++m_position;
+            std::string result;
+
+            while (true)
+            {
+                if (m_position >= m_text.size())
+                    fail("unterminated string");
+
+                const char c = m_text[m_position++];
+
+                if (c == '"')
+                    return result;
+
+                if (c != '\\')
+                {
+                    result += c;
+                    continue;
+                }
+
+                if (m_position >= m_text.size())
+                    fail("unterminated string");
+
+                switch (m_text[m_position++])
+                {
+                case '"':
+                    result += '"';
+                    break;
+                case '\\':
+                    result += '\\';
+                    break;
+                case '/':
+                    result += '/';
+                    break;
+                case 'b':
+                    result += '\b';
+                    break;
+                case 'f':
+                    result += '\f';
+                    break;
+                case 'n':
+                    result += '\n';
+                    break;
+                case 'r':
+                    result += '\r';
+                    break;
+                case 't':
+                    result += '\t';
+                    break;
+                case 'u':
+                    append_code_point(result);
+                    break;
+                default:
+                    fail("invalid escape");
+                }
+            }
+        }
+
+        /**
+         * @brief
+         * Decodes a \u escape, with its low surrogate if it has one, and
+         * appends it as UTF-8
+         * @param result String to append to
+         */
+        void append_code_point(std::string &result)
+        {
+            unsigned code = parse_hex();
+
+            if (code >= 0xD800 && code < 0xDC00 &&
+                m_text.substr(m_position, 2) == "\\u")
+            {
+                m_position += 2;
+                const unsigned low = parse_hex();
+
+                if (low < 0xDC00 || low >= 0xE000)
+                    fail("invalid surrogate pair");
+
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            }
+
+            if (code < 0x80)
+                result += static_cast<char>(code);
+            else if (code < 0x800)
+            {
+                result += static_cast<char>(0xC0 | (code >> 6));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000)
+            {
+                result += static_cast<char>(0xE0 | (code >> 12));
+                result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else
+            {
+                result += static_cast<char>(0xF0 | (code >> 18));
+                result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+    };
+
+    // Access methods
+    /**
+     * @brief
+     * Gets the kind of the value
+     * @return JsonValue::Kind Kind of the value
+     */
+    JsonValue::Kind JsonValue::get_kind() const noexcept
+    {
+        return m_kind;
+    }
+
+    /**
+     * @brief
+     * Gets a boolean value
+     * @return bool Value
+     * @throw std::runtime_error If the value is not a boolean
+     */
+    bool JsonValue::as_bool() const
+    {
+        if (m_kind != Kind::Boolean)
+            throw std::runtime_error("JSON value is not a boolean");
+
+        return m_boolean;
+    }
+
+    /**
+     * @brief
+     * Gets a number as a floating point value
+     * @return double Value
+     * @throw std::runtime_error If the value is not a number
+     */
+    double JsonValue::as_double() const
+    {
+        if (m_kind != Kind::Number)
+            throw std::runtime_error("JSON value is not a number");
+
+        return std::strtod(m_text.c_str(), nullptr);
+    }
+
+    /**
+     * @brief
+     * Gets a number as an unsigned integer, exactly
+     * @return std::uint64_t Value
+     * @throw std::runtime_error If the value is not a non negative integer
+     */
+    std::uint64_t JsonValue::as_uint() const
+    {
+        std::uint64_t value{};
+        const auto *end = m_text.data() + m_text.size();
+
+        if (m_kind != Kind::Number ||
+            std::from_chars(m_text.data(), end, value).ptr != end)
+            throw std::runtime_error("JSON value is not an unsigned integer: " +
+                                     m_text);
+
+        return value;
+    }
+
+    /**
+     * @brief
+     * Gets a string value
+     * @return const std::string& Contents of the string
+     * @throw std::runtime_error If the value is not a string
+     */
+    const std::string &JsonValue::as_string() const
+    {
+        if (m_kind != Kind::String)
+            throw std::runtime_error("JSON value is not a string");
+
+        return m_text;
+    }
+
+    /**
+     * @brief
+     * Gets the items of an array
+     * @return const std::vector<JsonValue>& Items, in order
+     * @throw std::runtime_error If the value is not an array
+     */
+    const std::vector<JsonValue> &JsonValue::as_array() const
+    {
+        if (m_kind != Kind::Array)
+            throw std::runtime_error("JSON value is not an array");
+
+        return m_items;
+    }
+
+    /**
+     * @brief
+     * Gets the members of an object
+     * @return const std::vector<std::pair<std::string, JsonValue>>&
+     *         Members, in order
+     * @throw std::runtime_error If the value is not an object
+     */
+    const std::vector<std::pair<std::string, JsonValue>> &
+    JsonValue::as_object() const
+    {
+        if (m_kind != Kind::Object)
+            throw std::runtime_error("JSON value is not an object");
+
+        return m_members;
+    }
+
+    /**
+     * @brief
+     * Gets a member of an object
+     * @param name Name of the member
+     * @return const JsonValue* Member, nullptr if the value is not an
+     *         object or has no such member
+     */
+    const JsonValue *JsonValue::find(std::string_view name) const
+    {
+        for (const auto &[member, value] : m_members)
+            if (member == name)
+                return &value;
+
+        return nullptr;
+    }
+
+    /**
+     * @brief
+     * Gets a member that must exist
+     * @param name Name of the member
+     * @return const JsonValue& Member
+     * @throw std::runtime_error If the object has no such member
+     */
+    const JsonValue &JsonValue::at(std::string_view name) const
+    {
+        const auto *value = find(name);
+
+        if (!value)
+            throw std::runtime_error("Missing JSON member: " + std::string(name));
+
+        return *value;
+    }
+
+    /**
+     * @brief
+     * Parses a JSON document
+     * @param text Document to parse
+     * @return JsonValue Root value
+     * @throw std::runtime_error If the document is not valid JSON
+     */
+    JsonValue parse_json(std::string_view text)
+    {
+        return JsonParser(text).parse();
+    }
+
+    /**
+     * @brief
+     * Reads and parses a JSON file
+     * @param filename File to read
+     * @return JsonValue Root value
+     * @throw std::runtime_error If the file cannot be read or is not valid
+     *        JSON
+     */
+    JsonValue load_json(const std::string &filename)
+    {
+        std::ifstream input(filename, std::ios::binary);
+
+        if (!input)
+            throw std::runtime_error("Cannot open file: " + filename);
+
+        std::ostringstream contents;
+        contents << input.rdbuf();
+
+        try
+        {
+            return parse_json(contents.str());
+        }
+        catch (const std::runtime_error &e)
+        {
+            throw std::runtime_error(filename + ": " + e.what());
+        }
+    }
+}
@@ -0,0 +1,129 @@
+/**
+ * @file json.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Helpers for reading and writing JSON documents
+ * @version 0.1
+ * @date 2023-06-09
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef JSON_H
+#define JSON_H
+
+// C++ standard library
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace utils
+{
+    // Escapes a string for JSON
+    /**
+     * @brief
+     * Appends a string to a JSON document as a quoted, escaped string
+     * @param output - Document to append to
+     * @param value - String to append
+     */
+    inline void append_json_string(std::string &output, std::string_view value)
+    {
+        output += '"';
+
+        for (const char c : value)
+        {
+            switch (c)
+            {
+            case '"':
+                output += "\\\"";
+                break;
+            case '\\':
+                output += "\\\\";
+                break;
+            case '\n':
+                output += "\\n";
+                break;
+            case '\r':
+                output += "\\r";
+                break;
+            case '\t':
+                output += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    output += escaped;
+                }
+                else
+                    output += c;
+                break;
+            }
+        }
+
+        output += '"';
+    }
+
+    /**
+     * @brief
+     * Value of a parsed JSON document
+     * @class JsonValue
+     * @details
+     * Numbers keep their text, so that 64-bit counters are read back
+     * exactly. Object members keep their order.
+     */
+    class JsonValue
+    {
+    public:
+        /**
+         * @brief
+         * Kinds of JSON values
+         * @enum Kind
+         */
+        enum class Kind
+        {
+            Null,
+            Boolean,
+            Number,
+            String,
+            Array,
+            Object
+        };
+
+        // Constructor
+        JsonValue() = default;
+
+        // Access methods
+        Kind get_kind() const noexcept;
+        bool as_bool() const;
+        double as_double() const;
+        std::uint64_t as_uint() const;
+        const std::string &as_string() const;
+        const std::vector<JsonValue> &as_array() const;
+        const std::vector<std::pair<std::string, JsonValue>> &as_object() const;
+        const JsonValue *find(std::string_view) const;
+        const JsonValue &at(std::string_view) const;
+
+    private:
+        friend class JsonParser;
+
+        Kind m_kind{Kind::Null};
+        bool m_boolean{false};
+
+        // Contents of a string, or text of a number
+        std::string m_text;
+
+        std::vector<JsonValue> m_items;
+        std::vector<std::pair<std::string, JsonValue>> m_members;
+    };
+
+    JsonValue parse_json(std::string_view);
+    JsonValue load_json(const std::string &);
+}
+
+#endif //! JSON_H
@@ -0,0 +1,176 @@
+/**
+ * @file lru_cache.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration and implementation of the LruCache class
+ * @version 0.1
+ * @date 2023-06-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+// C++ standard library
+#include <cstddef>
+#include <limits>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace utils
+{
+    /**
+     * @brief
+     * Least recently used cache with a fixed number of entries and a
+     * bound on the total cost of the values, such as their size in bytes
+     * @class LruCache
+     * @tparam Key Key type, must be hashable
+     * @tparam Value Value type
+     * @details The cache is not thread safe, callers are expected to
+     * guard it with their own mutex.
+     */
+    template <typename Key, typename Value>
+    class LruCache
+    {
+    public:
+        // Constructor
+        /**
+         * @brief
+         * Construct a new Lru Cache object
+         * @param capacity Maximum number of entries kept in the cache
+         * @param max_cost Maximum total cost of the entries
+         */
+        explicit LruCache(std::size_t capacity,
+                          std::size_t max_cost = std::numeric_limits<std::size_t>::max())
+            : m_capacity(capacity), m_max_cost(max_cost)
+        {
+            m_index.reserve(capacity);
+        }
+
+        // Access methods
+        /**
+         * @brief
+         * Looks up a key and marks it as the most recently used entry
+         * @param key Key to look up
+         * @return std::optional<Value> Cached value, if present
+         */
+        std::optional<Value> get(const Key &key)
+        {
+            const auto it = m_index.find(key);
+
+            if (it == m_index.end())
+                return std::nullopt;
+
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return it->second->value;
+        }
+
+        /**
+         * @brief
+         * Gets the number of entries in the cache
+         * @return std::size_t Number of entries
+         */
+        std::size_t size() const noexcept
+        {
+            return m_index.size();
+        }
+
+        /**
+         * @brief
+         * Gets the maximum number of entries of the cache
+         * @return std::size_t Capacity of the cache
+         */
+        std::size_t capacity() const noexcept
+        {
+            return m_capacity;
+        }
+
+        /**
+         * @brief
+         * Gets the total cost of the entries in the cache
+         * @return std::size_t Total cost
+         */
+        std::size_t cost() const noexcept
+        {
+            return m_cost;
+        }
+
+        // Mutator methods
+        /**
+         * @brief
+         * Inserts or replaces a value, evicting the least recently used
+         * entries until both the number of entries and their cost fit.
+         * A value that costs more than the whole cache is not kept
+         * @param key Key of the entry
+         * @param value Value of the entry
+         * @param cost Cost of the value
+         */
+        void put(const Key &key, Value value, std::size_t cost = 1)
+        {
+            if (const auto it = m_index.find(key); it != m_index.end())
+                erase(it);
+
+            if (m_capacity == 0 || cost > m_max_cost)
+                return;
+
+            while (!m_entries.empty() &&
+                   (m_index.size() >= m_capacity || m_cost + cost > m_max_cost))
+                erase(m_index.find(m_entries.back().key));
+
+            m_entries.push_front(Entry{key, std::move(value), cost});
+            m_index.emplace(key, m_entries.begin());
+            m_cost += cost;
+        }
+
+        /**
+         * @brief
+         * Removes every entry from the cache
+         */
+        void clear() noexcept
+        {
+            m_index.clear();
+            m_entries.clear();
+            m_cost = 0;
+        }
+
+    private:
+        /**
+         * @brief
+         * Entry of the cache
+         * @struct Entry
+         */
+        struct Entry
+        {
+            Key key;
+            Value value;
+            std::size_t cost;
+        };
+
+        using Index = std::unordered_map<Key, typename std::list<Entry>::iterator>;
+
+        std::size_t m_capacity;
+        std::size_t m_max_cost;
+        std::size_t m_cost{0};
+        std::list<Entry> m_entries;
+        Index m_index;
+
+        // Methods (Private)
+        /**
+         * @brief
+         * Removes an entry
+         * @param it Entry in the index
+         */
+        void erase(typename Index::iterator it)
+        {
+            m_cost -= it->second->cost;
+            m_entries.erase(it->second);
+            m_index.erase(it);
+        }
+    };
+}
+
+#endif //! LRU_CACHE_H
@@ -0,0 +1,292 @@
+/**
+ * @file options.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the command line options
+ * @version 0.1
+ * @date 2023-06-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <stdexcept>
+#include <string_view>
+
+// Project files
+#include "options.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Splits a "--name=value" argument
+     * @param argument Argument to split
+     * @param name Expected option name, including the leading dashes
+     * @param value Output value
+     * @return true If the argument is the named option
+     */
+    bool match_option(const std::string_view &argument,
+                      const std::string_view &name, std::string &value)
+    {
+        if (argument.substr(0, name.size()) != name ||
+            argument.size() <= name.size() || argument[name.size()] != '=')
+            return false;
+
+        value = argument.substr(name.size() + 1);
+        return true;
+    }
+
+    /**
+     * @brief
+     * Parses a non negative integer option value
+     * @param name Option name, used in the error message
+     * @param value Value to parse
+     * @return std::size_t Parsed value
+     * @throw std::invalid_argument If the value is not a number
+     */
+    std::size_t parse_size(const std::string_view &name,
+                           const std::string &value)
+    {
+        std::size_t parsed{};
+
+        try
+        {
+            std::size_t end{};
+            parsed = std::stoull(value, &end);
+
+            if (end != value.size() || value[0] == '-')
+                throw std::invalid_argument(value);
+        }
+        catch (const std::exception &)
+        {
+            throw std::invalid_argument("Invalid value for " +
+                                        std::string(name) + ": " + value);
+        }
+
+        return parsed;
+    }
+
+    /**
+     * @brief
+     * Adds the comma separated symbols of a --define option
+     * @param value Value to parse
+     * @param symbols Symbols to add to
+     */
+    void parse_defines(const std::string &value, std::vector<std::string> &symbols)
+    {
+        std::size_t begin{};
+
+        while (begin <= value.size())
+        {
+            auto end = value.find(',', begin);
+
+            if (end == std::string::npos)
+                end = value.size();
+
+            if (end > begin)
+                symbols.push_back(value.substr(begin, end - begin));
+
+            begin = end + 1;
+        }
+    }
+
+    /**
+     * @brief
+     * Parses the value of the --mode option
+     * @param value Value to parse
+     * @return utils::RunMode Selected lexers
+     * @throw std::invalid_argument If the value is not a mode
+     */
+    utils::RunMode parse_mode(const std::string &value)
+    {
+        if (value == "single")
+            return utils::RunMode::Single;
+
+        if (value == "multi")
+            return utils::RunMode::Multi;
+
+        if (value == "both")
+            return utils::RunMode::Both;
+
+        throw std::invalid_argument("Invalid value for --mode: " + value);
+    }
+}
+
+namespace utils
+{
+    /**
+     * @brief
+     * Parses the command line of the program
+     * @param argc Number of arguments
+     * @param argv Arguments
+     * @return Options Parsed options
+     * @throw std::invalid_argument If the command line is invalid
+     */
+    Options parse_options(int argc, char **argv)
+    {
+        Options options;
+        std::string value;
+        auto strategy = ShardStrategy::Hash;
+
+        for (int i{1}; i < argc; ++i)
+        {
+            const std::string_view argument{argv[i]};
+
+            if (argument == "--daemon" || argument == "--watch")
+            {
+                if (i + 1 >= argc)
+                    throw std::invalid_argument(std::string(argument) +
+                                                " needs an argument");
+
+                auto &target = argument == "--daemon"
+                                   ? options.daemon_socket
+                                   : options.watch_directory;
+                target = argv[++i];
+            }
+            else if (match_option(argument, "--daemon", value))
+                options.daemon_socket = value;
+            else if (match_option(argument, "--watch", value))
+                options.watch_directory = value;
+            else if (match_option(argument, "--cache-size", value))
+                options.cache_capacity = parse_size("--cache-size", value);
+            else if (match_option(argument, "--cache-memory", value))
+                options.cache_memory_mb = parse_size("--cache-memory", value);
+            else if (match_option(argument, "--debounce", value))
+                options.debounce_ms = parse_size("--debounce", value);
+            else if (match_option(argument, "--max-delay", value))
+                options.max_delay_ms = parse_size("--max-delay", value);
+            else if (match_option(argument, "--stats", value))
+                options.stats_output = value;
+            else if (match_option(argument, "--threads", value))
+                options.threads = parse_size("--threads", value);
+            else if (argument == "--pin")
+                options.pin_threads = true;
+            else if (match_option(argument, "--split-size", value))
+                options.split_size = parse_size("--split-size", value);
+            else if (match_option(argument, "--group-size", value))
+                options.group_size = parse_size("--group-size", value);
+            else if (match_option(argument, "--deadline", value))
+                options.deadline_ms = parse_size("--deadline", value);
+            else if (match_option(argument, "--max-token", value))
+                options.max_token_length = parse_size("--max-token", value);
+            else if (match_option(argument, "--memory-budget", value))
+                options.memory_budget_mb = parse_size("--memory-budget", value);
+            else if (match_option(argument, "--page-lines", value))
+                options.page_lines = parse_size("--page-lines", value);
+            else if (argument.starts_with("--define="))
+            {
+                // An empty value leaves every symbol undefined
+                if (!options.defines)
+                    options.defines.emplace();
+
+                parse_defines(std::string(argument.substr(9)), *options.defines);
+            }
+            else if (match_option(argument, "--mode", value))
+                options.mode = parse_mode(value);
+            else if (argument == "--bench")
+                options.bench = true;
+            else if (match_option(argument, "--warmup", value))
+                options.warmup = parse_size("--warmup", value);
+            else if (match_option(argument, "--repeat", value))
+                options.repetitions = parse_size("--repeat", value);
+            else if (argument == "--drop-caches")
+                options.drop_caches = true;
+            else if (argument == "--perf")
+                options.perf_counters = true;
+            else if (match_option(argument, "--trace", value))
+                options.trace_output = value;
+            else if (match_option(argument, "--bundle", value))
+                options.bundle_output = value;
+            else if (match_option(argument, "--index", value))
+                options.index_output = value;
+            else if (match_option(argument, "--shard", value))
+                options.shard = parse_shard(value);
+            else if (match_option(argument, "--shard-by", value))
+                strategy = parse_shard_strategy(value);
+            else if (match_option(argument, "--manifest", value))
+                options.manifest_output = value;
+            else if (argument.substr(0, 2) == "--")
+                throw std::invalid_argument("Unknown option: " +
+                                            std::string(argument));
+            else if (options.input_directory.empty())
+                options.input_directory = argument;
+            else
+                throw std::invalid_argument("Unexpected argument: " +
+                                            std::string(argument));
+        }
+
+        if (options.repetitions == 0)
+            throw std::invalid_argument("Invalid value for --repeat: 0");
+
+        options.shard.strategy = strategy;
+
+        if (options.input_directory.empty() && options.daemon_socket.empty() &&
+            options.watch_directory.empty())
+            throw std::invalid_argument("Missing input directory");
+
+        return options;
+    }
+
+    /**
+     * @brief
+     * Parses the command line of the merge subcommand, whose first
+     * argument is "merge"
+     * @param argc Number of arguments
+     * @param argv Arguments
+     * @return MergeOptions Parsed options
+     * @throw std::invalid_argument If the command line is invalid
+     */
+    MergeOptions parse_merge_options(int argc, char **argv)
+    {
+        MergeOptions options;
+        std::string value;
+
+        for (int i{2}; i < argc; ++i)
+        {
+            const std::string_view argument{argv[i]};
+
+            if (match_option(argument, "--manifest", value))
+                options.manifest_output = value;
+            else if (match_option(argument, "--stats", value))
+                options.stats_output = value;
+            else if (match_option(argument, "--bundle", value))
+                options.bundle_output = value;
+            else if (argument.substr(0, 2) == "--")
+                throw std::invalid_argument("Unknown option: " +
+                                            std::string(argument));
+            else
+                options.manifests.emplace_back(argument);
+        }
+
+        if (options.manifests.empty())
+            throw std::invalid_argument("Missing shard manifests");
+
+        return options;
+    }
+
+    /**
+     * @brief
+     * Builds the usage message of the program
+     * @param program Name of the executable
+     * @return std::string Usage message
+     */
+    std::string usage(const std::string &program)
+    {
+        return "Usage: " + program + " <input_directory> [--stats=FILE.json] [--split-size=BYTES] [--deadline=MS]\n"
+               "       " + std::string(program.size(), ' ') + "  [--memory-budget=MB] [--group-size=BYTES] [--mode=single|multi|both]\n"
+               "       " + std::string(program.size(), ' ') + "  [--bench] [--warmup=N] [--repeat=N] [--drop-caches] [--perf]\n"
+               "       " + std::string(program.size(), ' ') + "  [--trace=FILE.json] [--bundle=FILE] [--index=FILE]\n"
+               "       " + std::string(program.size(), ' ') + "  [--shard=I/N] [--shard-by=hash|size] [--manifest=FILE.json]\n"
+               "       " + std::string(program.size(), ' ') + "  [--page-lines=N]\n"
+               "       " + program + " merge <manifest.json>... [--manifest=FILE.json] [--stats=FILE.json]\n"
+               "       " + std::string(program.size(), ' ') + "  [--bundle=FILE]\n"
+               "       " + program + " unbundle <bundle> <output_directory>\n"
+               "       " + program + " lookup <index> <identifier>...\n"
+               "       " + program + " --daemon <socket_path> [--cache-size=N] [--cache-memory=MB]\n"
+               "       " + program + " --watch <input_directory> [--debounce=MS] [--max-delay=MS]\n"
+               "Common options: [--threads=N] [--pin] [--max-token=BYTES]\n"
+               "                [--define=SYMBOL[,SYMBOL...]]\n";
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * @file options.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the command line options
+ * @version 0.1
+ * @date 2023-06-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+// C++ standard library
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Project files
+#include "../shard/shard.h"
+
+namespace utils
+{
+    /**
+     * @brief
+     * Lexers run on the input directory
+     * @enum RunMode
+     */
+    enum class RunMode
+    {
+        Single,
+        Multi,
+        Both
+    };
+
+    /**
+     * @brief
+     * Options parsed from the command line
+     * @struct Options
+     */
+    struct Options
+    {
+        std::string input_directory;
+        std::string daemon_socket;
+        std::size_t cache_capacity{256};
+        std::size_t cache_memory_mb{256};
+        std::string watch_directory;
+        std::size_t debounce_ms{100};
+        std::size_t max_delay_ms{2000};
+        std::string stats_output;
+        std::size_t threads{0};
+        bool pin_threads{false};
+        std::size_t split_size{1024 * 1024};
+        std::size_t group_size{256 * 1024};
+        std::size_t deadline_ms{0};
+        std::size_t max_token_length{64 * 1024};
+        std::size_t memory_budget_mb{0};
+
+        // Lines per page of a paginated output, 0 for one document per file
+        std::size_t page_lines{0};
+
+        // Symbols of the conditional directives, unknown when not set
+        std::optional<std::vector<std::string>> defines;
+
+        RunMode mode{RunMode::Both};
+        bool bench{false};
+        std::size_t warmup{1};
+        std::size_t repetitions{10};
+        bool drop_caches{false};
+        bool perf_counters{false};
+        std::string trace_output;
+        std::string bundle_output;
+        std::string index_output;
+        ShardSpec shard;
+        std::string manifest_output;
+    };
+
+    /**
+     * @brief
+     * Options of the merge subcommand
+     * @struct MergeOptions
+     */
+    struct MergeOptions
+    {
+        std::vector<std::string> manifests;
+        std::string manifest_output;
+        std::string stats_output;
+        std::string bundle_output;
+    };
+
+    Options parse_options(int argc, char **argv);
+    MergeOptions parse_merge_options(int argc, char **argv);
+    std::string usage(const std::string &program);
+}
+
+#endif //! OPTIONS_H
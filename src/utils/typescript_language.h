@@ -0,0 +1,75 @@
+/**
+ * @file typescript_language.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the TypeScript language constants
+ * @version 0.1
+ * @date 2023-06-26
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+// C++ standard libraries
+#include <array>
+
+namespace typescript
+{
+    /**
+     * @brief
+     * Array of TypeScript keywords for the lexer
+     * @constexpr std::array<const char *, 48> keywords
+     */
+    inline constexpr std::array<const char *, 48> m_keywords = {
+        "break", "case", "catch", "class", "const", "continue", "debugger", "default", "delete", "do", "else", "enum", "export", "extends", "finally", "for", "function", "if", "import", "in", "new", "return", "switch", "throw", "try", "typeof", "var", "void", "while", "with", "let", "static", "implements", "interface", "package", "abstract", "any", "boolean", "number", "string", "symbol", "bigint", "object", "never", "unknown", "namespace", "module", "constructor"};
+
+    /**
+     * @brief
+     * Array of TypeScript operators for the lexer
+     * @constexpr std::array<const char *, 45> operators
+     */
+    inline constexpr std::array<const char *, 45> m_operators = {
+        "+", "-", "*", "/", "%", "**", "++", "--", "=", "+=", "-=", "*=", "/=", "%=", "==", "!=", "===", "!==", ">", "<", ">=", "<=", "&&", "||", "??", "!", "&", "|", "^", "~", "<<", ">>", ">>>", "&=", "|=", "^=", "&&=", "||=", "?\?=", "=>", "?.", "...", "keyof", "instanceof", "satisfies"};
+
+    /**
+     * @brief
+     * Array of TypeScript separators for the lexer
+     * @constexpr std::array<const char *, 11> separators
+     */
+    inline constexpr std::array<const char *, 11> m_separators = {
+        "(", ")", "{", "}", "[", "]", ",", ";", ".", ":", "?"};
+
+    /**
+     * @brief
+     * Array of TypeScript literals for the lexer
+     * @constexpr std::array<const char *, 6> literals
+     */
+    inline constexpr std::array<const char *, 6> m_literals = {
+        "true", "false", "null", "undefined", "this", "super"};
+
+    /**
+     * @brief
+     * Array of TypeScript contextual keywords for the lexer
+     * @constexpr std::array<const char *, 14> contextual_keywords
+     */
+    inline constexpr std::array<const char *, 14> m_contextual_keywords = {
+        "as", "async", "await", "declare", "from", "get", "infer", "is", "of", "readonly", "require", "set", "type", "yield"};
+
+    /**
+     * @brief
+     * Array of TypeScript access specifiers for the lexer
+     * @constexpr std::array<const char *, 3> access_specifiers
+     */
+    inline constexpr std::array<const char *, 3> m_access_specifiers = {
+        "public", "private", "protected"};
+
+    /**
+     * @brief
+     * Array of TypeScript comments for the lexer
+     * @constexpr std::array<const char *, 3> comments
+     */
+    inline constexpr std::array<const char *, 3> m_comments = {
+        "//", "/*", "*/"};
+}
@@ -15,6 +15,9 @@
 
 // C++ standard library
 #include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
 
 namespace utils
 {
@@ -26,16 +29,55 @@ namespace utils
      * @tparam Args - Arguments type
      * @param func - Function to measure
      * @param args - Arguments of the function
-     * @return auto - Time of the function
+     * @return double - Time of the function in milliseconds
      */
     template <typename F, typename... Args>
     auto measure_time(F func, Args &&...args)
     {
-        auto start = std::chrono::high_resolution_clock::now();
+        auto start = std::chrono::steady_clock::now();
         func(std::forward<Args>(args)...);
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = std::chrono::steady_clock::now();
 
-        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // Hashes a byte buffer
+    /**
+     * @brief
+     * 64-bit FNV-1a hash of a byte buffer
+     * @param data - Bytes to hash
+     * @return std::uint64_t - Hash of the bytes
+     */
+    constexpr std::uint64_t hash_bytes(std::string_view data) noexcept
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+
+        for (const char c : data)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    // Names the pages of a paginated output
+    /**
+     * @brief
+     * Name of a page of an output split into pages, as in a.p2.html for
+     * the second page of a.html
+     * @param output - Name of the whole output, which becomes its index
+     * @param page - Number of the page, starting at 1
+     * @return std::string - Name of the page
+     */
+    inline std::string page_output_name(std::string_view output, std::size_t page)
+    {
+        constexpr std::string_view extension = ".html";
+
+        if (output.ends_with(extension))
+            output.remove_suffix(extension.size());
+
+        return std::string(output) + ".p" + std::to_string(page) + std::string(extension);
     }
 }
 
@@ -0,0 +1,92 @@
+/**
+ * @file vb_language.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the Visual Basic .NET language constants
+ * @version 0.1
+ * @date 2023-06-26
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+// C++ standard libraries
+#include <array>
+
+namespace vb
+{
+    // Visual Basic is case insensitive, words are listed in lowercase
+
+    /**
+     * @brief
+     * Array of Visual Basic keywords for the lexer
+     * @constexpr std::array<const char *, 131> keywords
+     */
+    inline constexpr std::array<const char *, 131> m_keywords = {
+        "addhandler", "addressof", "alias", "as", "boolean", "byref", "byte", "byval", "call",
+        "case", "catch", "cbool", "cbyte", "cchar", "cdate", "cdbl", "cdec", "char", "cint",
+        "class", "clng", "cobj", "const", "continue", "csbyte", "cshort", "csng", "cstr", "ctype",
+        "cuint", "culng", "cushort", "date", "decimal", "declare", "default", "delegate", "dim",
+        "directcast", "do", "double", "each", "else", "elseif", "end", "endif", "enum", "erase",
+        "error", "event", "exit", "finally", "for", "function", "get", "gettype",
+        "getxmlnamespace", "global", "gosub", "goto", "handles", "if", "implements", "imports",
+        "in", "inherits", "integer", "interface", "let", "lib", "long", "loop", "module",
+        "mustinherit", "mustoverride", "namespace", "narrowing", "new", "next", "notinheritable",
+        "notoverridable", "object", "of", "on", "operator", "option", "optional", "overloads",
+        "overridable", "overrides", "paramarray", "partial", "property", "raiseevent", "readonly",
+        "redim", "removehandler", "resume", "return", "sbyte", "select", "set", "shadows",
+        "shared", "short", "single", "static", "step", "stop", "string", "structure", "sub",
+        "synclock", "then", "throw", "to", "try", "trycast", "typeof", "uinteger", "ulong",
+        "ushort", "using", "variant", "wend", "when", "while", "widening", "with", "withevents",
+        "writeonly"};
+
+    /**
+     * @brief
+     * Array of Visual Basic operators for the lexer
+     * @constexpr std::array<const char *, 30> operators
+     */
+    inline constexpr std::array<const char *, 30> m_operators = {
+        "+", "-", "*", "/", "\\", "^", "&", "=", "<>", "<", ">", "<=", ">=", "<<", ">>", "+=", "-=", "*=", "/=", "&=", "and", "andalso", "or", "orelse", "not", "xor", "mod", "is", "isnot", "like"};
+
+    /**
+     * @brief
+     * Array of Visual Basic separators for the lexer
+     * @constexpr std::array<const char *, 8> separators
+     */
+    inline constexpr std::array<const char *, 8> m_separators = {
+        "(", ")", "{", "}", ",", ".", ":", "_"};
+
+    /**
+     * @brief
+     * Array of Visual Basic literals for the lexer
+     * @constexpr std::array<const char *, 6> literals
+     */
+    inline constexpr std::array<const char *, 6> m_literals = {
+        "true", "false", "nothing", "me", "mybase", "myclass"};
+
+    /**
+     * @brief
+     * Array of Visual Basic contextual keywords for the lexer
+     * @constexpr std::array<const char *, 6> contextual_keywords
+     */
+    inline constexpr std::array<const char *, 6> m_contextual_keywords = {
+        "async", "await", "iterator", "yield", "from", "key"};
+
+    /**
+     * @brief
+     * Array of Visual Basic access specifiers for the lexer
+     * @constexpr std::array<const char *, 4> access_specifiers
+     */
+    inline constexpr std::array<const char *, 4> m_access_specifiers = {
+        "public", "private", "protected", "friend"};
+
+    /**
+     * @brief
+     * Array of Visual Basic comments for the lexer
+     * @constexpr std::array<const char *, 1> comments
+     */
+    inline constexpr std::array<const char *, 1> m_comments = {
+        "'"};
+}
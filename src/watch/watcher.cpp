@@ -0,0 +1,320 @@
+/**
+ * @file watcher.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Implementation of the Watcher class
+ * @version 0.1
+ * @date 2023-06-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard libraries
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+// POSIX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// Project files
+#include "watcher.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Interval at which an idle watch loop checks for a stop request
+     */
+    constexpr int poll_interval_ms = 200;
+
+    /**
+     * @brief
+     * Events that mean a file has new contents
+     */
+    constexpr std::uint32_t changed_mask = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+    /**
+     * @brief
+     * Events that mean a file is gone
+     */
+    constexpr std::uint32_t removed_mask = IN_DELETE | IN_MOVED_FROM;
+
+    /**
+     * @brief
+     * Milliseconds left until a time point, 0 once it is reached
+     * @param deadline Time point
+     * @return int Milliseconds left
+     */
+    int milliseconds_until(std::chrono::steady_clock::time_point deadline)
+    {
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+
+        return static_cast<int>(std::max<std::chrono::milliseconds::rep>(left.count(), 0));
+    }
+}
+
+// Constructor
+/**
+ * @brief
+ * Construct a new Watcher:: Watcher object
+ * @param lexer Lexer used to highlight the files
+ * @param directory Directory to watch
+ * @param debounce Quiet interval that ends a burst of events
+ * @param max_delay Longest a burst is collected, however busy it is
+ * @throw std::runtime_error If the directory cannot be watched
+ */
+Watcher::Watcher(Lexer &lexer, std::string directory,
+                 std::chrono::milliseconds debounce,
+                 std::chrono::milliseconds max_delay)
+    : m_lexer(lexer),
+      m_directory(std::move(directory)),
+      m_debounce(debounce),
+      m_max_delay(std::max(max_delay, debounce)),
+      m_inotify_fd(-1),
+      m_stopping(false)
+{
+    m_inotify_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (m_inotify_fd < 0)
+        throw std::runtime_error(std::string("inotify_init1 failed: ") +
+                                 std::strerror(errno));
+
+    if (::inotify_add_watch(m_inotify_fd, m_directory.c_str(),
+                            changed_mask | removed_mask) < 0)
+    {
+        const std::string error = std::strerror(errno);
+        ::close(m_inotify_fd);
+
+        throw std::runtime_error("Cannot watch " + m_directory + ": " + error);
+    }
+}
+
+// Destructor
+/**
+ * @brief
+ * Destroy the Watcher:: Watcher object
+ */
+Watcher::~Watcher()
+{
+    if (m_inotify_fd >= 0)
+        ::close(m_inotify_fd);
+}
+
+// Methods (Public)
+/**
+ * @brief
+ * Brings the output up to date and then re-highlights changed files
+ * until stop() is called
+ */
+void Watcher::run()
+{
+    sync();
+
+    while (!m_stopping)
+    {
+        const bool pending = !m_changed.empty() || !m_removed.empty();
+        int timeout = poll_interval_ms;
+
+        if (pending)
+            timeout = std::min(static_cast<int>(m_debounce.count()),
+                               milliseconds_until(m_burst_start + m_max_delay));
+
+        pollfd watcher{m_inotify_fd, POLLIN, 0};
+        const auto ready = ::poll(&watcher, 1, timeout);
+
+        if (ready < 0 && errno != EINTR)
+            throw std::runtime_error(std::string("poll failed: ") +
+                                     std::strerror(errno));
+
+        if (ready > 0)
+            read_events();
+
+        if (m_overflowed)
+        {
+            sync();
+            continue;
+        }
+
+        // A quiet directory or a burst past its maximum delay is flushed
+        if ((ready == 0 && pending) ||
+            ((!m_changed.empty() || !m_removed.empty()) &&
+             std::chrono::steady_clock::now() >= m_burst_start + m_max_delay))
+            flush();
+    }
+}
+
+/**
+ * @brief
+ * Requests the watch loop to finish, whether it has started yet or not.
+ * Safe to call from a signal handler
+ */
+void Watcher::stop() noexcept
+{
+    m_stopping = true;
+}
+
+// Methods (Private)
+/**
+ * @brief
+ * Queues every source file whose output is missing or older than the
+ * source, and every known file that is gone, so that the first burst and
+ * the one after lost events only pay for what actually changed
+ */
+void Watcher::sync()
+{
+    m_overflowed = false;
+    auto gone = m_known;
+
+    for (const auto &entry : std::filesystem::directory_iterator(m_directory))
+    {
+        const auto path = entry.path().string();
+
+        if (!entry.is_regular_file() || !is_source_file(path))
+            continue;
+
+        gone.erase(path);
+        m_known.insert(path);
+
+        if (m_lexer.is_stale(path))
+            queue(path, true);
+    }
+
+    for (const auto &path : gone)
+        queue(path, false);
+
+    if (!m_changed.empty() || !m_removed.empty())
+        flush();
+}
+
+/**
+ * @brief
+ * Drains the inotify descriptor into the pending change sets
+ */
+void Watcher::read_events()
+{
+    alignas(inotify_event) char buffer[64 * 1024];
+
+    while (true)
+    {
+        const auto length = ::read(m_inotify_fd, buffer, sizeof(buffer));
+
+        if (length <= 0)
+            return;
+
+        for (ssize_t offset{}; offset < length;)
+        {
+            const auto *event =
+                reinterpret_cast<const inotify_event *>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            // Events were dropped, only a full comparison finds them
+            if (event->mask & IN_Q_OVERFLOW)
+                m_overflowed = true;
+
+            if (event->len == 0 || (event->mask & IN_ISDIR))
+                continue;
+
+            const auto path =
+                (std::filesystem::path(m_directory) / event->name).string();
+
+            if (!is_source_file(path))
+                continue;
+
+            if (event->mask & changed_mask)
+                queue(path, true);
+            else if (event->mask & removed_mask)
+                queue(path, false);
+        }
+    }
+}
+
+/**
+ * @brief
+ * Adds a file to the current burst, starting the burst if it is the
+ * first one. The latest event of a burst decides what happens to the file
+ * @param path Source file
+ * @param changed Whether the file has new contents rather than being gone
+ */
+void Watcher::queue(const std::string &path, bool changed)
+{
+    if (m_changed.empty() && m_removed.empty())
+        m_burst_start = std::chrono::steady_clock::now();
+
+    if (changed)
+    {
+        m_removed.erase(path);
+        m_changed.insert(path);
+    }
+    else
+    {
+        m_changed.erase(path);
+        m_removed.insert(path);
+    }
+}
+
+/**
+ * @brief
+ * Re-highlights the changed files of the current burst on the thread pool
+ * of the lexer and removes the output of deleted files
+ */
+void Watcher::flush()
+{
+    Batch batch(m_lexer.get_pool());
+    std::atomic<std::size_t> updated{0};
+    std::mutex error_mutex;
+
+    for (const auto &filename : m_changed)
+    {
+        m_known.insert(filename);
+        batch.submit([this, filename, &updated, &error_mutex]()
+                     {
+            try
+            {
+                m_lexer.refresh(filename);
+                ++updated;
+            }
+            catch (const std::exception &e)
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                std::cerr << "Error: " << filename << ": " << e.what()
+                          << std::endl;
+            } });
+    }
+
+    for (const auto &filename : m_removed)
+    {
+        m_known.erase(filename);
+        m_lexer.remove_output(filename);
+    }
+
+    batch.wait();
+
+    std::cout << "Re-highlighted " << updated.load() << " file(s), removed "
+              << m_removed.size() << std::endl;
+
+    m_changed.clear();
+    m_removed.clear();
+}
+
+/**
+ * @brief
+ * Checks whether a path is a file the lexer handles
+ * @param filename Path to check
+ * @return true If the path is a source file of a language the lexer
+ *         highlights
+ */
+bool Watcher::is_source_file(const std::string &filename) const
+{
+    return language_of(filename).has_value();
+}
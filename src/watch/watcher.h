@@ -0,0 +1,90 @@
+/**
+ * @file watcher.h
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Declaration of the Watcher class
+ * @version 0.1
+ * @date 2023-06-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef WATCHER_H
+#define WATCHER_H
+
+// C++ standard libraries
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <string>
+
+// Project files
+#include "../lexer/lexer.h"
+
+/**
+ * @brief
+ * Re-highlights the files of a directory as they change
+ * @class Watcher
+ * @details
+ * Subscribes to inotify events on the input directory and collects them
+ * until the directory has been quiet for the debounce interval, or until
+ * the first event of the burst is older than the maximum delay, so files
+ * that never stop changing are still lexed again. Only the files that were
+ * created, modified or removed in that burst are lexed again (or have
+ * their output removed), as one batch on the thread pool of the lexer.
+ * When the kernel drops events because its queue overflowed, the whole
+ * directory is compared with the outputs again.
+ *
+ * Like a run, only the files at the top of the directory are watched:
+ * subdirectories are neither lexed nor watched.
+ */
+class Watcher
+{
+public:
+    // Constructor
+    Watcher(Lexer &, std::string directory,
+            std::chrono::milliseconds debounce,
+            std::chrono::milliseconds max_delay);
+
+    // Destructor
+    ~Watcher();
+
+    Watcher(const Watcher &) = delete;
+    Watcher &operator=(const Watcher &) = delete;
+
+    // Methods
+    void run();
+    void stop() noexcept;
+
+private:
+    Lexer &m_lexer;
+    std::string m_directory;
+    std::chrono::milliseconds m_debounce;
+    std::chrono::milliseconds m_max_delay;
+    int m_inotify_fd;
+
+    // Set once by stop(), before or during run()
+    std::atomic<bool> m_stopping;
+
+    std::set<std::string> m_changed;
+    std::set<std::string> m_removed;
+
+    // Source files with an output, to find those removed unseen
+    std::set<std::string> m_known;
+
+    // Time of the first event of the current burst
+    std::chrono::steady_clock::time_point m_burst_start;
+
+    // Whether events were lost since the last sync
+    bool m_overflowed{false};
+
+    // Methods
+    void sync();
+    void read_events();
+    void queue(const std::string &, bool);
+    void flush();
+    bool is_source_file(const std::string &) const;
+};
+
+#endif //! WATCHER_H
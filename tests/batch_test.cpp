@@ -0,0 +1,120 @@
+/**
+ * @file batch_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the Batch class
+ * @version 0.1
+ * @date 2023-06-16
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/threads/batch.h"
+
+/**
+ * @brief
+ * Checks that wait returns once every task of the batch has run, and that
+ * failing tasks are counted instead of propagated
+ * @param BatchTest - Test suite
+ * @param WaitRunsEveryTask - Test name
+ */
+TEST(BatchTest, WaitRunsEveryTask)
+{
+    ThreadPool pool(4);
+    Batch batch(pool);
+    std::atomic<int> counter{0};
+
+    for (int i{}; i < 100; ++i)
+        batch.submit([&counter]()
+                     { ++counter; });
+
+    batch.submit([]()
+                 { throw std::runtime_error("failure"); });
+
+    batch.wait();
+
+    EXPECT_EQ(counter, 100);
+    EXPECT_EQ(batch.get_pending(), 0u);
+    EXPECT_EQ(batch.get_failed(), 1u);
+    EXPECT_EQ(batch.get_dropped(), 0u);
+}
+
+/**
+ * @brief
+ * Checks that cancelling a batch drops the tasks that have not started
+ * @param BatchTest - Test suite
+ * @param CancelDropsQueuedTasks - Test name
+ */
+TEST(BatchTest, CancelDropsQueuedTasks)
+{
+    ThreadPool pool(1);
+    Batch batch(pool);
+    std::promise<void> started;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<int> counter{0};
+
+    // Keeps the only worker busy while the other tasks are queued
+    batch.submit([&started, released]()
+                 {
+        started.set_value();
+        released.wait(); });
+    started.get_future().wait();
+
+    for (int i{}; i < 10; ++i)
+        batch.submit([&counter]()
+                     { ++counter; });
+
+    batch.cancel();
+    release.set_value();
+    batch.wait();
+
+    EXPECT_TRUE(batch.is_cancelled());
+    EXPECT_EQ(counter, 0);
+    EXPECT_EQ(batch.get_dropped(), 10u);
+}
+
+/**
+ * @brief
+ * Checks that a past deadline drops the queued tasks of one batch without
+ * affecting another batch on the same pool
+ * @param BatchTest - Test suite
+ * @param DeadlineIsPerBatch - Test name
+ */
+TEST(BatchTest, DeadlineIsPerBatch)
+{
+    ThreadPool pool(2);
+    Batch expired(pool);
+    Batch current(pool);
+    std::atomic<int> counter{0};
+
+    expired.set_deadline(Batch::Clock::now() - std::chrono::seconds(1));
+
+    for (int i{}; i < 10; ++i)
+    {
+        expired.submit([&counter]()
+                       { ++counter; });
+        current.submit([&counter]()
+                       { ++counter; });
+    }
+
+    expired.wait();
+    current.wait();
+    pool.wait_idle();
+
+    EXPECT_TRUE(expired.should_stop());
+    EXPECT_FALSE(current.should_stop());
+    EXPECT_EQ(expired.get_dropped(), 10u);
+    EXPECT_EQ(counter, 10);
+}
@@ -0,0 +1,61 @@
+/**
+ * @file bench_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the benchmark helpers
+ * @version 0.1
+ * @date 2023-06-21
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <vector>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/utils/bench.h"
+
+/**
+ * @brief
+ * Checks the summary of unordered samples, with a sample standard
+ * deviation and percentiles taken by nearest rank
+ * @param BenchTest - Test suite
+ * @param SummarizeSamples - Test name
+ */
+TEST(BenchTest, SummarizeSamples)
+{
+    const auto summary = utils::summarize({4, 2, 8, 6});
+
+    EXPECT_EQ(summary.count, 4u);
+    EXPECT_DOUBLE_EQ(summary.mean, 5);
+    EXPECT_NEAR(summary.stddev, 2.5819889, 1e-6);
+    EXPECT_DOUBLE_EQ(summary.p50, 4);
+    EXPECT_DOUBLE_EQ(summary.p99, 8);
+    EXPECT_DOUBLE_EQ(summary.min, 2);
+    EXPECT_DOUBLE_EQ(summary.max, 8);
+}
+
+/**
+ * @brief
+ * Checks percentiles on the edges: no samples, one sample, and a tail
+ * that only the 99th percentile of a large set reaches
+ * @param BenchTest - Test suite
+ * @param PercentileEdges - Test name
+ */
+TEST(BenchTest, PercentileEdges)
+{
+    std::vector<double> samples(200, 1.0);
+    samples[197] = 50;
+    samples[198] = 60;
+    samples[199] = 100;
+
+    EXPECT_DOUBLE_EQ(utils::percentile({}, 0.5), 0);
+    EXPECT_DOUBLE_EQ(utils::percentile({3}, 0.99), 3);
+    EXPECT_DOUBLE_EQ(utils::percentile(samples, 0.50), 1);
+    EXPECT_DOUBLE_EQ(utils::percentile(samples, 0.99), 50);
+    EXPECT_DOUBLE_EQ(utils::summarize({7}).stddev, 0);
+}
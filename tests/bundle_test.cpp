@@ -0,0 +1,142 @@
+/**
+ * @file bundle_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the BundleWriter and BundleReader classes
+ * @version 0.1
+ * @date 2023-06-27
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/output/bundle.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Gets a bundle path in the temporary directory, removing what a
+     * previous run left there
+     * @param name Name of the bundle
+     * @return std::string Path of the bundle
+     */
+    std::string bundle_path(const std::string &name)
+    {
+        const auto path = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove(path);
+        return path.string();
+    }
+}
+
+/**
+ * @brief
+ * Checks that documents written concurrently through reserved regions,
+ * including a linked name, are read back by name, and that regions that
+ * were never committed stay out of the index
+ * @param BundleTest - Test suite
+ * @param ConcurrentWritersRoundTrip - Test name
+ */
+TEST(BundleTest, ConcurrentWritersRoundTrip)
+{
+    const auto path = bundle_path("lexer_bundle_test.bundle");
+    const std::size_t writers = 4;
+    const std::size_t documents = 50;
+
+    auto contents = [](std::size_t writer, std::size_t document)
+    {
+        // Sizes that do not fall on page boundaries
+        return std::string(writer * 1000 + document * 37 + 1,
+                           static_cast<char>('a' + (writer + document) % 26));
+    };
+
+    {
+        BundleWriter bundle(path);
+        std::vector<std::thread> threads;
+
+        for (std::size_t writer{}; writer < writers; ++writer)
+        {
+            threads.emplace_back([&, writer]()
+                                 {
+                for (std::size_t document{}; document < documents; ++document)
+                {
+                    const auto text = contents(writer, document);
+                    auto region = bundle.reserve(text.size());
+                    std::copy(text.begin(), text.end(), region.data());
+                    region.commit(std::to_string(writer) + "/" +
+                                  std::to_string(document) + ".html");
+                } });
+        }
+
+        for (auto &thread : threads)
+            thread.join();
+
+        auto abandoned = bundle.reserve(100);
+        abandoned.release();
+
+        EXPECT_TRUE(bundle.link("copy.html", "0/0.html"));
+        EXPECT_FALSE(bundle.link("missing.html", "none.html"));
+        EXPECT_EQ(bundle.get_document_count(), writers * documents + 1);
+
+        bundle.finish();
+    }
+
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    BundleReader reader(path);
+    EXPECT_EQ(reader.size(), writers * documents + 1);
+    EXPECT_FALSE(reader.contains("missing.html"));
+    EXPECT_FALSE(reader.read("none.html").has_value());
+
+    for (std::size_t writer{}; writer < writers; ++writer)
+        for (std::size_t document{}; document < documents; ++document)
+            EXPECT_EQ(reader.read(std::to_string(writer) + "/" +
+                                  std::to_string(document) + ".html"),
+                      contents(writer, document));
+
+    EXPECT_EQ(reader.read("copy.html"), contents(0, 0));
+    EXPECT_EQ(reader.find("copy.html")->offset, reader.find("0/0.html")->offset);
+
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief
+ * Checks that an unfinished bundle is not published and that files that
+ * are not bundles are rejected
+ * @param BundleTest - Test suite
+ * @param RejectsUnfinishedAndForeignFiles - Test name
+ */
+TEST(BundleTest, RejectsUnfinishedAndForeignFiles)
+{
+    const auto path = bundle_path("lexer_bundle_unfinished.bundle");
+
+    {
+        BundleWriter bundle(path);
+        auto region = bundle.reserve(5);
+        std::copy_n("hello", 5, region.data());
+        region.commit("hello.html");
+    }
+
+    EXPECT_FALSE(std::filesystem::exists(path));
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+    EXPECT_THROW(BundleReader{path}, std::runtime_error);
+
+    std::ofstream(path) << "<html>not a bundle</html>";
+    EXPECT_THROW(BundleReader{path}, std::runtime_error);
+
+    std::filesystem::remove(path);
+}
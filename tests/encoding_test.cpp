@@ -0,0 +1,91 @@
+/**
+ * @file encoding_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the text encoding helpers
+ * @version 0.1
+ * @date 2023-06-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <string>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/utils/encoding.h"
+
+/**
+ * @brief
+ * Checks UTF-8 validation on sequences at the edges of RFC 3629
+ * @param EncodingTest - Test suite
+ * @param ValidatesUtf8 - Test name
+ */
+TEST(EncodingTest, ValidatesUtf8)
+{
+    const std::string ascii(100, 'a');
+
+    EXPECT_TRUE(utils::is_valid_utf8(ascii));
+    EXPECT_TRUE(utils::is_valid_utf8(ascii + "\xC3\xA9" + ascii));
+    EXPECT_TRUE(utils::is_valid_utf8("\xF0\x9F\x98\x80"));
+    EXPECT_TRUE(utils::is_valid_utf8("\xEF\xBB\xBF" "class"));
+
+    EXPECT_FALSE(utils::is_valid_utf8(ascii + "\xE9" + ascii));
+    EXPECT_FALSE(utils::is_valid_utf8("\xC0\xAF"));
+    EXPECT_FALSE(utils::is_valid_utf8("\xED\xA0\x80"));
+    EXPECT_FALSE(utils::is_valid_utf8("\xF4\x90\x80\x80"));
+    EXPECT_FALSE(utils::is_valid_utf8(ascii + "\xE2\x82"));
+}
+
+/**
+ * @brief
+ * Checks that every supported encoding converts to the same UTF-8 text
+ * @param EncodingTest - Test suite
+ * @param ConvertsToUtf8 - Test name
+ */
+TEST(EncodingTest, ConvertsToUtf8)
+{
+    const std::string expected = "var s = \"caf\xC3\xA9 \xF0\x9F\x98\x80\"; // long enough line";
+    const std::u16string text = u"var s = \"café \U0001F600\"; // long enough line";
+
+    std::string little_endian;
+    std::string big_endian;
+
+    for (const char16_t unit : text)
+    {
+        little_endian += static_cast<char>(unit & 0xFF);
+        little_endian += static_cast<char>(unit >> 8);
+        big_endian += static_cast<char>(unit >> 8);
+        big_endian += static_cast<char>(unit & 0xFF);
+    }
+
+    EXPECT_EQ(utils::detect_encoding(little_endian), utils::Encoding::Utf16LE);
+    EXPECT_EQ(utils::detect_encoding(big_endian), utils::Encoding::Utf16BE);
+
+    EXPECT_EQ(utils::to_utf8("\xFF\xFE" + little_endian), expected);
+    EXPECT_EQ(utils::to_utf8("\xFE\xFF" + big_endian), expected);
+    EXPECT_EQ(utils::to_utf8(little_endian), expected);
+    EXPECT_EQ(utils::to_utf8(big_endian), expected);
+    EXPECT_EQ(utils::to_utf8("\xEF\xBB\xBF" + expected), expected);
+    EXPECT_EQ(utils::to_utf8(expected), expected);
+    EXPECT_EQ(utils::to_utf8("caf\xE9"), "caf\xC3\xA9");
+}
+
+/**
+ * @brief
+ * Checks that malformed UTF-16 becomes replacement characters
+ * @param EncodingTest - Test suite
+ * @param ReplacesMalformedUtf16 - Test name
+ */
+TEST(EncodingTest, ReplacesMalformedUtf16)
+{
+    // Lone high surrogate, lone low surrogate, then a trailing odd byte
+    const std::string data("a\0\x00\xD8" "b\0\x00\xDC" "c", 9);
+
+    EXPECT_EQ(utils::decode_utf16(data, false),
+              "a\xEF\xBF\xBD" "b\xEF\xBF\xBD\xEF\xBF\xBD");
+}
@@ -0,0 +1,191 @@
+/**
+ * @file identifier_index_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the IndexBuilder and IdentifierIndex classes
+ * @version 0.1
+ * @date 2023-06-30
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/index/identifier_index.h"
+#include "../src/lexer/lexer.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Gets an index path in the temporary directory, removing what a
+     * previous run left there
+     * @param name Name of the index
+     * @return std::string Path of the index
+     */
+    std::string index_path(const std::string &name)
+    {
+        const auto path = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove(path);
+        return path.string();
+    }
+}
+
+/**
+ * @brief
+ * Checks that postings added from several threads, and those of a linked
+ * copy, are found sorted by file and offset once the index is written
+ * @param IdentifierIndexTest - Test suite
+ * @param ThreadsMergeIntoSortedPostings - Test name
+ */
+TEST(IdentifierIndexTest, ThreadsMergeIntoSortedPostings)
+{
+    const auto path = index_path("lexer_index_test.idx");
+    const std::vector<std::string> files{"a.cs", "b.cs", "c.cs", "copy.cs"};
+
+    InternTable identifiers;
+    const auto value = identifiers.intern("value");
+    const auto count = identifiers.intern("count");
+
+    {
+        IndexBuilder builder;
+        std::vector<std::thread> threads;
+
+        for (std::size_t file{}; file < 3; ++file)
+        {
+            threads.emplace_back([&, file]()
+                                 {
+                for (std::size_t offset{}; offset < 100; ++offset)
+                    builder.add(value, file, 1000 - offset * 10);
+
+                if (file == 2)
+                    builder.add(count, file, 7); });
+        }
+
+        for (auto &thread : threads)
+            thread.join();
+
+        builder.link(3, 2);
+        EXPECT_EQ(builder.get_posting_count(), 301u);
+        builder.write(path, files, identifiers);
+    }
+
+    const IdentifierIndex index(path);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(index.get_file_count(), 4u);
+    EXPECT_EQ(index.get_file(3), "copy.cs");
+    EXPECT_THROW(index.get_file(4), std::out_of_range);
+
+    const auto postings = index.find("value");
+    ASSERT_EQ(postings.size(), 400u);
+    EXPECT_EQ(postings.front().file, 0u);
+    EXPECT_EQ(postings.front().offset, 10u);
+    EXPECT_EQ(postings.back().file, 3u);
+    EXPECT_EQ(postings.back().offset, 1000u);
+
+    const auto counted = index.find("count");
+    ASSERT_EQ(counted.size(), 2u);
+    EXPECT_EQ(counted[1].file, 3u);
+    EXPECT_EQ(counted[1].offset, 7u);
+
+    EXPECT_TRUE(index.find("missing").empty());
+    EXPECT_TRUE(index.find("").empty());
+
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief
+ * Checks that files that are not whole indexes are refused
+ * @param IdentifierIndexTest - Test suite
+ * @param RejectsForeignAndTruncatedFiles - Test name
+ */
+TEST(IdentifierIndexTest, RejectsForeignAndTruncatedFiles)
+{
+    const auto path = index_path("lexer_index_test_bad.idx");
+
+    {
+        InternTable identifiers;
+        IndexBuilder builder;
+        builder.add(identifiers.intern("name"), 0, 1);
+        builder.write(path, {"a.cs"}, identifiers);
+    }
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 12);
+    EXPECT_THROW(IdentifierIndex{path}, std::runtime_error);
+
+    std::ofstream(path, std::ios::trunc) << "not an index at all, clearly not one";
+    EXPECT_THROW(IdentifierIndex{path}, std::runtime_error);
+    EXPECT_THROW(IdentifierIndex{path + ".missing"}, std::runtime_error);
+
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief
+ * Checks that the offsets of a run refer to the UTF-8 text that is lexed,
+ * without the BOM and after UTF-16 is converted
+ * @param IdentifierIndexTest - Test suite
+ * @param OffsetsReferToUtf8Text - Test name
+ */
+TEST(IdentifierIndexTest, OffsetsReferToUtf8Text)
+{
+    namespace fs = std::filesystem;
+
+    const auto root = fs::temp_directory_path() / "lexer_index_test_run";
+    fs::remove_all(root);
+    fs::create_directories(root / "b");
+    fs::create_directories(root / "outputParallel");
+
+    const auto bom = (root / "bom.cs").string();
+    const auto wide = (root / "wide.cs").string();
+
+    std::ofstream(bom, std::ios::binary) << "\xEF\xBB\xBFint alpha;";
+
+    // "// é\nint beta;" as UTF-16LE, where beta is at byte 22 of the file
+    {
+        std::ofstream output(wide, std::ios::binary);
+        output << "\xFF\xFE";
+
+        for (const char16_t c : std::u16string(u"// é\nint beta;"))
+            output << static_cast<char>(c & 0xFF) << static_cast<char>(c >> 8);
+    }
+
+    // The lexer writes to ../outputParallel
+    const auto previous = fs::current_path();
+    fs::current_path(root / "b");
+
+    const auto path = (root / "ids.idx").string();
+
+    {
+        Lexer lexer;
+        lexer.set_worker_count(2);
+        lexer.set_index(path);
+        lexer.start_multi({bom, wide});
+    }
+
+    fs::current_path(previous);
+
+    const IdentifierIndex index(path);
+
+    const auto alpha = index.find("alpha");
+    ASSERT_EQ(alpha.size(), 1u);
+    EXPECT_EQ(alpha[0].offset, 4u);
+
+    const auto beta = index.find("beta");
+    ASSERT_EQ(beta.size(), 1u);
+    EXPECT_EQ(beta[0].offset, 10u);
+
+    fs::remove_all(root);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file intern_table_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the InternTable class
+ * @version 0.1
+ * @date 2023-06-07
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <string>
+#include <thread>
+#include <vector>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/token/intern_table.h"
+
+/**
+ * @brief
+ * Checks that equal strings share an ID and different strings do not
+ * @param InternTableTest - Test suite
+ * @param SameStringSameId - Test name
+ */
+TEST(InternTableTest, SameStringSameId)
+{
+    InternTable table;
+    const auto first = table.intern("Console");
+    const auto second = table.intern("WriteLine");
+
+    EXPECT_EQ(table.intern("Console"), first);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(table.lookup(first), "Console");
+    EXPECT_EQ(table.lookup(second), "WriteLine");
+    EXPECT_EQ(table.size(), 2u);
+}
+
+/**
+ * @brief
+ * Checks that find does not add strings to the table
+ * @param InternTableTest - Test suite
+ * @param FindDoesNotIntern - Test name
+ */
+TEST(InternTableTest, FindDoesNotIntern)
+{
+    InternTable table;
+
+    EXPECT_EQ(table.find("missing"), std::nullopt);
+    EXPECT_EQ(table.size(), 0u);
+
+    const auto id = table.intern("present");
+    EXPECT_EQ(table.find("present"), id);
+}
+
+/**
+ * @brief
+ * Checks that workers interning the same names concurrently agree on
+ * their IDs
+ * @param InternTableTest - Test suite
+ * @param ConcurrentIntern - Test name
+ */
+TEST(InternTableTest, ConcurrentIntern)
+{
+    constexpr std::size_t num_threads = 8;
+    constexpr std::size_t num_names = 2000;
+
+    InternTable table(3);
+    std::vector<std::vector<std::uint32_t>> ids(num_threads);
+    std::vector<std::thread> threads;
+
+    for (std::size_t t{}; t < num_threads; ++t)
+    {
+        threads.emplace_back([&, t]()
+                             {
+            for (std::size_t i{}; i < num_names; ++i)
+                ids[t].push_back(table.intern("name" + std::to_string(i))); });
+    }
+
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(table.size(), num_names);
+
+    for (std::size_t t{1}; t < num_threads; ++t)
+        EXPECT_EQ(ids[t], ids[0]);
+
+    for (std::size_t i{}; i < num_names; ++i)
+        EXPECT_EQ(table.lookup(ids[0][i]), "name" + std::to_string(i));
+}
@@ -0,0 +1,116 @@
+/**
+ * @file lru_cache_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the LruCache class
+ * @version 0.1
+ * @date 2023-06-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <string>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/utils/lru_cache.h"
+
+/**
+ * @brief
+ * Checks that a stored value can be read back
+ * @param LruCacheTest - Test suite
+ * @param GetAfterPut - Test name
+ */
+TEST(LruCacheTest, GetAfterPut)
+{
+    utils::LruCache<std::string, int> cache(2);
+    cache.put("a", 1);
+
+    EXPECT_EQ(cache.get("a"), 1);
+    EXPECT_EQ(cache.get("b"), std::nullopt);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+/**
+ * @brief
+ * Checks that the least recently used entry is evicted first
+ * @param LruCacheTest - Test suite
+ * @param EvictsLeastRecentlyUsed - Test name
+ */
+TEST(LruCacheTest, EvictsLeastRecentlyUsed)
+{
+    utils::LruCache<std::string, int> cache(2);
+    cache.put("a", 1);
+    cache.put("b", 2);
+
+    // Touch "a" so that "b" becomes the oldest entry
+    EXPECT_EQ(cache.get("a"), 1);
+    cache.put("c", 3);
+
+    EXPECT_EQ(cache.get("a"), 1);
+    EXPECT_EQ(cache.get("b"), std::nullopt);
+    EXPECT_EQ(cache.get("c"), 3);
+    EXPECT_EQ(cache.size(), 2u);
+}
+
+/**
+ * @brief
+ * Checks that putting an existing key replaces its value
+ * @param LruCacheTest - Test suite
+ * @param ReplacesExistingKey - Test name
+ */
+TEST(LruCacheTest, ReplacesExistingKey)
+{
+    utils::LruCache<std::string, int> cache(2);
+    cache.put("a", 1);
+    cache.put("a", 2);
+
+    EXPECT_EQ(cache.get("a"), 2);
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+/**
+ * @brief
+ * Checks that a cache without capacity never stores anything
+ * @param LruCacheTest - Test suite
+ * @param ZeroCapacity - Test name
+ */
+TEST(LruCacheTest, ZeroCapacity)
+{
+    utils::LruCache<std::string, int> cache(0);
+    cache.put("a", 1);
+
+    EXPECT_EQ(cache.get("a"), std::nullopt);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+/**
+ * @brief
+ * Checks that entries are evicted once their total cost exceeds the
+ * bound, and that a value costing more than the bound is not kept
+ * @param LruCacheTest - Test suite
+ * @param EvictsByCost - Test name
+ */
+TEST(LruCacheTest, EvictsByCost)
+{
+    utils::LruCache<std::string, std::string> cache(10, 100);
+    cache.put("a", "first", 40);
+    cache.put("b", "second", 40);
+    cache.put("c", "third", 40);
+
+    EXPECT_EQ(cache.get("a"), std::nullopt);
+    EXPECT_EQ(cache.get("b"), "second");
+    EXPECT_EQ(cache.cost(), 80u);
+
+    // Replacing a value replaces its cost
+    cache.put("b", "smaller", 10);
+    EXPECT_EQ(cache.cost(), 50u);
+
+    cache.put("huge", "value", 101);
+    EXPECT_EQ(cache.get("huge"), std::nullopt);
+    EXPECT_EQ(cache.size(), 2u);
+}
@@ -0,0 +1,126 @@
+/**
+ * @file memory_budget_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the MemoryBudget class
+ * @version 0.1
+ * @date 2023-06-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/threads/memory_budget.h"
+
+/**
+ * @brief
+ * Checks that an acquire waits until enough memory is released
+ * @param MemoryBudgetTest - Test suite
+ * @param AcquireWaitsForRelease - Test name
+ */
+TEST(MemoryBudgetTest, AcquireWaitsForRelease)
+{
+    MemoryBudget budget(100);
+    auto first = budget.acquire(60);
+    std::atomic<bool> acquired{false};
+
+    std::thread waiter([&]()
+                       {
+        auto second = budget.acquire(60);
+        acquired = true; });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(acquired);
+    EXPECT_EQ(budget.get_in_use(), 60u);
+
+    first.release();
+    waiter.join();
+
+    EXPECT_TRUE(acquired);
+    EXPECT_EQ(budget.get_in_use(), 0u);
+    EXPECT_EQ(budget.get_peak(), 60u);
+}
+
+/**
+ * @brief
+ * Checks that a request larger than the budget is admitted alone
+ * @param MemoryBudgetTest - Test suite
+ * @param OversizedRunsAlone - Test name
+ */
+TEST(MemoryBudgetTest, OversizedRunsAlone)
+{
+    MemoryBudget budget(100);
+
+    {
+        auto huge = budget.acquire(500);
+        EXPECT_EQ(huge.get_bytes(), 500u);
+        EXPECT_EQ(budget.get_in_use(), 500u);
+    }
+
+    EXPECT_EQ(budget.get_in_use(), 0u);
+}
+
+/**
+ * @brief
+ * Checks that moving a lease keeps a single release
+ * @param MemoryBudgetTest - Test suite
+ * @param MovedLeaseReleasesOnce - Test name
+ */
+TEST(MemoryBudgetTest, MovedLeaseReleasesOnce)
+{
+    MemoryBudget budget(100);
+    auto lease = budget.acquire(40);
+    auto other = budget.acquire(30);
+
+    MemoryBudget::Lease moved(std::move(lease));
+    EXPECT_EQ(lease.get_bytes(), 0u);
+
+    moved = std::move(other);
+    EXPECT_EQ(budget.get_in_use(), 30u);
+
+    moved.release();
+    moved.release();
+    EXPECT_EQ(budget.get_in_use(), 0u);
+}
+
+/**
+ * @brief
+ * Checks that a part split from a lease is released apart, and that a
+ * split never takes more than the lease holds
+ * @param MemoryBudgetTest - Test suite
+ * @param SplitLeaseReleasesApart - Test name
+ */
+TEST(MemoryBudgetTest, SplitLeaseReleasesApart)
+{
+    MemoryBudget budget(100);
+    auto lease = budget.acquire(60);
+
+    {
+        auto part = lease.split(25);
+        EXPECT_EQ(part.get_bytes(), 25u);
+        EXPECT_EQ(lease.get_bytes(), 35u);
+        EXPECT_EQ(budget.get_in_use(), 60u);
+    }
+
+    EXPECT_EQ(budget.get_in_use(), 35u);
+
+    auto rest = lease.split(1000);
+    EXPECT_EQ(rest.get_bytes(), 35u);
+    EXPECT_EQ(lease.get_bytes(), 0u);
+
+    lease.release();
+    EXPECT_EQ(budget.get_in_use(), 35u);
+
+    rest.release();
+    EXPECT_EQ(budget.get_in_use(), 0u);
+    EXPECT_EQ(MemoryBudget::Lease().split(10).get_bytes(), 0u);
+}
@@ -0,0 +1,74 @@
+#!/bin/sh
+#
+# Lexes a file with a block comment across a page boundary, and a copy of
+# it, into pages and checks the pages, their index and that single,
+# parallel and bundled runs agree.
+#
+# Usage: pages_test.sh <Lexer>
+
+set -eu
+
+if [ "$#" -ne 1 ]; then
+    echo "Usage: $0 <Lexer>" >&2
+    exit 2
+fi
+
+lexer=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+mkdir "$work/in"
+
+# 23 lines, the comment spans lines 11 to 17
+{
+    for i in 0 1 2 3 4 5 6 7 8 9; do
+        echo "int a$i = $i;"
+    done
+
+    echo "/* start"
+
+    for i in 0 1 2 3 4; do
+        echo "   comment $i"
+    done
+
+    echo "end */ int z = 1;"
+
+    for i in 0 1 2 3 4 5; do
+        echo "var s$i = \"x\";"
+    done
+} >"$work/in/a.cs"
+
+# A file shorter than a page stays one document
+echo "int b = 1;" >"$work/in/b.cs"
+
+# A copy gets pages and an index page of its own
+cp "$work/in/a.cs" "$work/in/c.cs"
+
+# The lexer writes to ../outputSingle and ../outputParallel
+mkdir -p "$work/run/b" "$work/run/outputSingle" "$work/run/outputParallel"
+cd "$work/run/b"
+
+"$lexer" ../../in --page-lines=12 >/dev/null
+diff -r ../outputSingle ../outputParallel
+
+out=../outputParallel
+test -f $out/a.p1.html
+test -f $out/a.p2.html
+test ! -f $out/a.p3.html
+test ! -f $out/b.p1.html
+
+grep -q '<a href="a.p1.html">Lines 1-12</a>' $out/a.html
+grep -q '<a href="a.p2.html">Lines 13-23</a>' $out/a.html
+grep -q '<a href="c.p2.html">Lines 13-23</a>' $out/c.html
+cmp $out/a.p2.html $out/c.p2.html
+
+# The second page starts inside the comment
+test "$(sed -n '/<pre><code>/{n;p;q;}' $out/a.p2.html)" = \
+    '<span class="Comment">   comment 1'
+
+"$lexer" ../../in --mode=multi --page-lines=12 --bundle=../pages.bundle \
+    >/dev/null
+"$lexer" unbundle ../pages.bundle ../unbundled >/dev/null
+diff -r $out ../unbundled
+
+echo "paginated output: OK"
@@ -0,0 +1,83 @@
+/**
+ * @file perf_counters_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the PerfCounters class
+ * @version 0.1
+ * @date 2023-06-22
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <thread>
+#include <vector>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/stats/perf_counters.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Burns some CPU time the compiler cannot remove
+     * @return unsigned Meaningless value
+     */
+    unsigned spin()
+    {
+        volatile unsigned value{};
+
+        for (unsigned i{}; i < 2000000; ++i)
+            value = value + i;
+
+        return value;
+    }
+}
+
+/**
+ * @brief
+ * Checks that nothing is counted while the counters are disabled, and
+ * that the scopes of several threads are summed into their stage
+ * @param PerfCountersTest - Test suite
+ * @param ScopesAreSummedPerStage - Test name
+ */
+TEST(PerfCountersTest, ScopesAreSummedPerStage)
+{
+    PerfCounters counters;
+
+    {
+        PerfCounters::Scope scope(counters, PerfCounters::Stage::Scan);
+        spin();
+    }
+
+    EXPECT_EQ(counters.get_counts(PerfCounters::Stage::Scan)[PerfCounters::TaskClock], 0u);
+
+    if (!counters.set_enabled(true))
+        GTEST_SKIP() << "perf events are not available";
+
+    std::vector<std::thread> threads;
+
+    for (int i{}; i < 3; ++i)
+        threads.emplace_back([&counters]()
+                             {
+            PerfCounters::Scope scope(counters, PerfCounters::Stage::Render);
+            spin(); });
+
+    for (auto &thread : threads)
+        thread.join();
+
+    counters.add_source_bytes(1024);
+
+    EXPECT_GT(counters.get_counts(PerfCounters::Stage::Render)[PerfCounters::TaskClock], 0u);
+    EXPECT_EQ(counters.get_counts(PerfCounters::Stage::Write)[PerfCounters::TaskClock], 0u);
+    EXPECT_EQ(counters.get_source_bytes(), 1024u);
+
+    counters.reset();
+
+    EXPECT_EQ(counters.get_counts(PerfCounters::Stage::Render)[PerfCounters::TaskClock], 0u);
+    EXPECT_EQ(counters.get_source_bytes(), 0u);
+}
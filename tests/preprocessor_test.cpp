@@ -0,0 +1,146 @@
+/**
+ * @file preprocessor_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the Preprocessor class
+ * @version 0.1
+ * @date 2023-06-29
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/lexer/preprocessor.h"
+#include "../src/lexer/scanner.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Gets the text of the inactive regions of a source
+     * @param preprocessor Preprocessor to search with
+     * @param source Source code
+     * @param scan Whether the directives of active code are found by the
+     *        C# scanner
+     * @return std::vector<std::string> Text of every region, in order
+     */
+    std::vector<std::string> inactive_text(const Preprocessor &preprocessor,
+                                           std::string_view source,
+                                           bool scan = false)
+    {
+        std::vector<std::string> regions;
+        Scanner scanner(source);
+        Preprocessor::DirectiveFinder find_directive;
+
+        if (scan)
+            find_directive = [&scanner](std::size_t begin)
+            { return scanner.find_directive(begin); };
+
+        for (const auto &range : preprocessor.find_inactive(source, find_directive))
+            regions.emplace_back(source.substr(range.begin, range.end - range.begin));
+
+        return regions;
+    }
+}
+
+/**
+ * @brief
+ * Checks the branches left out by #if, #elif and #else, including nested
+ * ones and the symbols defined by the file
+ * @param PreprocessorTest - Test suite
+ * @param FindsInactiveBranches - Test name
+ */
+TEST(PreprocessorTest, FindsInactiveBranches)
+{
+    const std::string source = "#define A\n"
+                               "  #if !A // comment\n"
+                               "x\n"
+                               "  #elif (A && true) == true\n"
+                               "y\n"
+                               "#else\n"
+                               "z\n"
+                               "#endif\n"
+                               "#if false\n"
+                               "#if true\n"
+                               "#else\n"
+                               "#endif\n"
+                               "#endif\n"
+                               "w # not a directive\n";
+
+    EXPECT_EQ(inactive_text(Preprocessor(), source),
+              (std::vector<std::string>{"\nx\n  ", "\nz\n",
+                                        "\n#if true\n#else\n#endif\n"}));
+
+    // A region that is never closed runs to the end
+    EXPECT_EQ(inactive_text(Preprocessor(), "#if false\r\nx"),
+              (std::vector<std::string>{"\r\nx"}));
+    EXPECT_TRUE(Preprocessor().find_inactive("a # b\n#endif\n#else\n").empty());
+}
+
+/**
+ * @brief
+ * Checks that unknown symbols keep every branch after them active, and
+ * that configured symbols leave the others undefined
+ * @param PreprocessorTest - Test suite
+ * @param UnknownSymbolsStayActive - Test name
+ */
+TEST(PreprocessorTest, UnknownSymbolsStayActive)
+{
+    const std::string source = "#if DEBUG\n"
+                               "d\n"
+                               "#elif RELEASE || TRACE\n"
+                               "r\n"
+                               "#else\n"
+                               "e\n"
+                               "#endif\n";
+
+    EXPECT_FALSE(Preprocessor().has_symbols());
+    EXPECT_TRUE(inactive_text(Preprocessor(), source).empty());
+    EXPECT_EQ(inactive_text(Preprocessor({"DEBUG"}), source),
+              (std::vector<std::string>{"\nr\n", "\ne\n"}));
+    EXPECT_EQ(inactive_text(Preprocessor({"TRACE"}), source),
+              (std::vector<std::string>{"\nd\n", "\ne\n"}));
+    EXPECT_EQ(inactive_text(Preprocessor(std::vector<std::string>{}), source),
+              (std::vector<std::string>{"\nd\n", "\nr\n"}));
+
+    // Malformed conditions are unknown
+    EXPECT_TRUE(Preprocessor({"A"}).find_inactive("#if (A\nx\n#endif\n").empty());
+}
+
+/**
+ * @brief
+ * Checks that a '#' starting a line inside a comment or a string of active
+ * code is not a directive, and that comments of inactive code do not hide
+ * the directive that closes it
+ * @param PreprocessorTest - Test suite
+ * @param IgnoresDirectivesInComments - Test name
+ */
+TEST(PreprocessorTest, IgnoresDirectivesInComments)
+{
+    const std::string commented = "/*\n#if false\n*/\nint a;\n";
+
+    EXPECT_TRUE(inactive_text(Preprocessor(), commented, true).empty());
+    EXPECT_EQ(inactive_text(Preprocessor(), commented),
+              (std::vector<std::string>{"\n*/\nint a;\n"}));
+
+    const std::string source = "var s = \"/*\"; // /*\n"
+                               "#if false\n"
+                               "/* x\n"
+                               "#endif\n"
+                               "int a; */\n"
+                               "#if false\n"
+                               "y\n"
+                               "#endif\n";
+
+    EXPECT_EQ(inactive_text(Preprocessor(), source, true),
+              (std::vector<std::string>{"\n/* x\n", "\ny\n"}));
+}
@@ -0,0 +1,202 @@
+/**
+ * @file scanner_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the Scanner class
+ * @version 0.1
+ * @date 2023-06-17
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/lexer/scanner.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Splits a source with the scanner
+     * @param source Source code
+     * @return std::vector<std::string> Tokens in order
+     */
+    std::vector<std::string> scan(const std::string &source)
+    {
+        std::vector<std::string> tokens;
+        Scanner scanner(source);
+        std::string_view token;
+
+        while (scanner.next(token))
+            tokens.emplace_back(token);
+
+        return tokens;
+    }
+
+    /**
+     * @brief
+     * Splits a source with the regular expression the scanner replaces
+     * @param source Source code, kept short: std::regex recurses per byte
+     * @return std::vector<std::string> Tokens in order
+     */
+    std::vector<std::string> scan_regex(const std::string &source)
+    {
+        static const std::regex tokenizer(
+            R"(\".*\"|\b_?[0-9]+(?:\.[0-9]+)?\b|\w+|\s+|\/\/[^\n]*|\/\*[\s\S]*?\*\/|[{}()\[\];,.:?><+\-*/%&=!@#$~,_`\\|\"])",
+            std::regex::optimize | std::regex_constants::ECMAScript);
+
+        std::vector<std::string> tokens;
+
+        for (auto it = std::sregex_token_iterator(source.begin(), source.end(),
+                                                  tokenizer);
+             it != std::sregex_token_iterator(); ++it)
+            if (it->length() != 0)
+                tokens.push_back(it->str());
+
+        return tokens;
+    }
+}
+
+/**
+ * @brief
+ * Checks the tokens of a small C# snippet
+ * @param ScannerTest - Test suite
+ * @param SplitsSnippet - Test name
+ */
+TEST(ScannerTest, SplitsSnippet)
+{
+    const std::vector<std::string> expected{
+        "x", " ", "=", " ", "1.5", ";", " ", "// done", "\n",
+        "/* a\nb */", "s", "=", "\"a\" + \"b\"", ";"};
+
+    EXPECT_EQ(scan("x = 1.5; // done\n/* a\nb */s=\"a\" + \"b\";"), expected);
+}
+
+/**
+ * @brief
+ * Checks that unterminated strings and comments fall back to punctuation
+ * @param ScannerTest - Test suite
+ * @param UnterminatedTokens - Test name
+ */
+TEST(ScannerTest, UnterminatedTokens)
+{
+    const std::vector<std::string> expected{
+        "\"", "a", "\n", "/", "*", " ", "b", " ", "/", "*"};
+
+    EXPECT_EQ(scan("\"a\n/* b /*"), expected);
+}
+
+/**
+ * @brief
+ * Compares the scanner with the regular expression on random inputs made
+ * of the characters that drive its decisions
+ * @param ScannerTest - Test suite
+ * @param MatchesRegex - Test name
+ */
+TEST(ScannerTest, MatchesRegex)
+{
+    constexpr std::string_view alphabet = "ab_09.\"/*\n\r \t'{};^\\=\x80";
+    std::mt19937 generator(2023);
+
+    for (int round{}; round < 20000; ++round)
+    {
+        std::string source(generator() % 24, ' ');
+
+        for (auto &c : source)
+            c = alphabet[generator() % alphabet.size()];
+
+        ASSERT_EQ(scan(source), scan_regex(source)) << "Source: " << source;
+    }
+}
+
+/**
+ * @brief
+ * Checks the strings and comments of the other languages: escaped and
+ * multiline strings in TypeScript, doubled quotes and apostrophe comments
+ * in Visual Basic, and parenthesized block comments in F#
+ * @param ScannerTest - Test suite
+ * @param OtherLanguages - Test name
+ */
+TEST(ScannerTest, OtherLanguages)
+{
+    auto scan_as = [](auto description, const std::string &source)
+    {
+        std::vector<std::string> tokens;
+        BasicScanner<decltype(description)> scanner(source);
+        std::string_view token;
+
+        while (scanner.next(token))
+            tokens.emplace_back(token);
+
+        return tokens;
+    };
+
+    EXPECT_EQ(scan_as(TypeScriptLanguage{}, "a='x\\'y'+`1\n2`;$b \"u"),
+              (std::vector<std::string>{"a", "=", "'x\\'y'", "+", "`1\n2`", ";",
+                                        "$b", " ", "\"", "u"}));
+    EXPECT_EQ(scan_as(VisualBasicLanguage{}, "s = \"a \"\"b\"\" 'c\" ' d\n"),
+              (std::vector<std::string>{"s", " ", "=", " ", "\"a \"\"b\"\" 'c\"",
+                                        " ", "' d", "\n"}));
+    EXPECT_EQ(scan_as(FSharpLanguage{}, "(* a\n*) let x' = \"/*\""),
+              (std::vector<std::string>{"(* a\n*)", " ", "let", " ", "x'", " ",
+                                        "=", " ", "\"/*\""}));
+}
+
+/**
+ * @brief
+ * Checks that a '#' starting a line is a directive up to the end of the
+ * line, and that inactive regions are returned whole
+ * @param ScannerTest - Test suite
+ * @param DirectivesAndInactiveRegions - Test name
+ */
+TEST(ScannerTest, DirectivesAndInactiveRegions)
+{
+    const std::string source = "  #if X // y\r\nint a;\n#endif\nb#c";
+    const std::vector<SourceRange> inactive{{12, 21}};
+    Scanner scanner(source, inactive);
+    std::string_view token;
+    ScanKind kind;
+
+    std::vector<std::string> tokens;
+    std::vector<ScanKind> kinds;
+
+    while (scanner.next(token, kind))
+    {
+        tokens.emplace_back(token);
+        kinds.push_back(kind);
+    }
+
+    EXPECT_EQ(tokens, (std::vector<std::string>{"  ", "#if X // y", "\r\nint a;\n",
+                                                "#endif", "\n", "b", "#", "c"}));
+    EXPECT_EQ(kinds[1], ScanKind::Directive);
+    EXPECT_EQ(kinds[2], ScanKind::Inactive);
+    EXPECT_EQ(kinds[3], ScanKind::Directive);
+    EXPECT_EQ(kinds[6], ScanKind::Token);
+}
+
+/**
+ * @brief
+ * Checks that files are assigned a language by their extension
+ * @param ScannerTest - Test suite
+ * @param LanguageOfExtension - Test name
+ */
+TEST(ScannerTest, LanguageOfExtension)
+{
+    EXPECT_EQ(language_of("src/a.cs"), Language::CSharp);
+    EXPECT_EQ(language_of("Module1.vb"), Language::VisualBasic);
+    EXPECT_EQ(language_of("lib.fsx"), Language::FSharp);
+    EXPECT_EQ(language_of("app.component.tsx"), Language::TypeScript);
+    EXPECT_EQ(language_of("notes.txt"), std::nullopt);
+    EXPECT_EQ(language_of("dir.ts/README"), std::nullopt);
+    EXPECT_EQ(language_name(Language::FSharp), "F#");
+}
@@ -0,0 +1,233 @@
+/**
+ * @file server_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the RequestReader and Server classes
+ * @version 0.1
+ * @date 2023-06-02
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+// POSIX
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/server/request_reader.h"
+#include "../src/server/server.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Connects to a Unix domain socket, waiting for the daemon to listen
+     * @param path Path of the socket
+     * @return int Connected socket, -1 if the daemon never listened
+     */
+    int connect_to(const std::string &path)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+        for (int attempt{}; attempt < 500; ++attempt)
+        {
+            const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+            if (::connect(fd, reinterpret_cast<sockaddr *>(&address),
+                          sizeof(address)) == 0)
+                return fd;
+
+            ::close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        return -1;
+    }
+
+    /**
+     * @brief
+     * Sends a request and reads its response: the header line and the
+     * body it announces
+     * @param fd Connected socket
+     * @param request Bytes of the request
+     * @return std::string Response, without the line break of the header
+     */
+    std::string exchange(int fd, const std::string &request)
+    {
+        if (::send(fd, request.data(), request.size(), MSG_NOSIGNAL) !=
+            static_cast<ssize_t>(request.size()))
+            return "";
+
+        std::string response;
+        char c;
+
+        while (::recv(fd, &c, 1, 0) == 1 && c != '\n')
+            response += c;
+
+        if (response.starts_with("OK "))
+        {
+            std::size_t remaining = std::stoull(response.substr(3));
+            char chunk[4096];
+
+            while (remaining > 0)
+            {
+                const auto result = ::recv(fd, chunk,
+                                           std::min(remaining, sizeof(chunk)), 0);
+
+                if (result <= 0)
+                    break;
+
+                response.append(chunk, static_cast<std::size_t>(result));
+                remaining -= static_cast<std::size_t>(result);
+            }
+        }
+
+        return response;
+    }
+}
+
+/**
+ * @brief
+ * Checks that requests split across several reads, or sent together,
+ * come out whole and in order
+ * @param RequestReaderTest - Test suite
+ * @param SplitsPipelinedRequests - Test name
+ */
+TEST(RequestReaderTest, SplitsPipelinedRequests)
+{
+    RequestReader reader;
+    const std::string bytes =
+        "html FILE /tmp/a b.cs\ntokens SOURCE 5\nint xhtml PING\n";
+
+    // Nothing is complete until its payload is
+    reader.append(bytes.data(), 30);
+    auto request = reader.next();
+    ASSERT_TRUE(request);
+    EXPECT_EQ(request->format, "html");
+    EXPECT_EQ(request->kind, "FILE");
+    EXPECT_EQ(request->payload, "/tmp/a b.cs");
+    EXPECT_FALSE(reader.next());
+
+    reader.append(bytes.data() + 30, bytes.size() - 30);
+    request = reader.next();
+    ASSERT_TRUE(request);
+    EXPECT_EQ(request->kind, "SOURCE");
+    EXPECT_EQ(request->payload, "int x");
+    EXPECT_TRUE(request->error.empty());
+
+    request = reader.next();
+    ASSERT_TRUE(request);
+    EXPECT_EQ(request->error, "Unknown request: PING");
+    EXPECT_FALSE(request->close);
+    EXPECT_FALSE(reader.next());
+    EXPECT_EQ(reader.buffered(), 0u);
+}
+
+/**
+ * @brief
+ * Checks that a source length that cannot be trusted ends the connection
+ * @param RequestReaderTest - Test suite
+ * @param RejectsBadLengths - Test name
+ */
+TEST(RequestReaderTest, RejectsBadLengths)
+{
+    for (const std::string header : {"html SOURCE x\n", "html SOURCE -1\n",
+                                     "html SOURCE 99999999999\n"})
+    {
+        RequestReader reader;
+        reader.append(header.data(), header.size());
+
+        const auto request = reader.next();
+        ASSERT_TRUE(request) << header;
+        EXPECT_FALSE(request->error.empty()) << header;
+        EXPECT_TRUE(request->close) << header;
+        EXPECT_FALSE(reader.next()) << header;
+    }
+
+    RequestReader reader;
+    const std::string line(RequestReader::max_header_size + 1, 'a');
+    reader.append(line.data(), line.size());
+    EXPECT_EQ(reader.next()->error, "Header too long");
+}
+
+/**
+ * @brief
+ * Checks that an idle client does not keep the only worker from serving
+ * another client, and that the results of the cache are reused
+ * @param ServerTest - Test suite
+ * @param IdleClientsHoldNoWorker - Test name
+ */
+TEST(ServerTest, IdleClientsHoldNoWorker)
+{
+    const auto path = (std::filesystem::temp_directory_path() /
+                       "lexer_server_test.sock")
+                          .string();
+
+    Lexer lexer;
+    Server server(lexer, path, 1, 16, 1024 * 1024);
+    std::thread daemon([&server]()
+                       { server.run(); });
+
+    const int idle = connect_to(path);
+    const int active = connect_to(path);
+    ASSERT_GE(idle, 0);
+    ASSERT_GE(active, 0);
+
+    // A partial request keeps the first client connected and idle
+    ASSERT_EQ(::send(idle, "html SOURCE 100\nint", 19, MSG_NOSIGNAL), 19);
+
+    const auto first = exchange(active, "tokens SOURCE 9\nint x = 1");
+    EXPECT_TRUE(first.starts_with("OK ")) << first;
+    EXPECT_NE(first.find("x"), std::string::npos);
+
+    // The same source again comes from the cache, another one does not
+    EXPECT_EQ(exchange(active, "tokens SOURCE 9\nint x = 1"), first);
+
+    const auto second = exchange(active, "tokens SOURCE 9\nint y = 1");
+    EXPECT_TRUE(second.starts_with("OK ")) << second;
+    EXPECT_NE(second, first);
+
+    EXPECT_EQ(exchange(active, "html FILE /nonexistent/file.cs\n"),
+              "ERR Cannot open file: /nonexistent/file.cs");
+
+    server.stop();
+    daemon.join();
+
+    ::close(idle);
+    ::close(active);
+}
+
+/**
+ * @brief
+ * Checks that a stop requested before the daemon starts is not lost
+ * @param ServerTest - Test suite
+ * @param StopBeforeRun - Test name
+ */
+TEST(ServerTest, StopBeforeRun)
+{
+    const auto path = (std::filesystem::temp_directory_path() /
+                       "lexer_server_stop_test.sock")
+                          .string();
+
+    Lexer lexer;
+    Server server(lexer, path, 1, 16, 1024 * 1024);
+    server.stop();
+    server.run();
+
+    SUCCEED();
+}
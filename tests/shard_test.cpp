@@ -0,0 +1,163 @@
+/**
+ * @file shard_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the sharding of runs and the merge of their results
+ * @version 0.1
+ * @date 2023-06-28
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/shard/shard.h"
+#include "../src/stats/token_stats.h"
+
+/**
+ * @brief
+ * Checks that the shards of both strategies are disjoint, cover every
+ * file, and that size-balanced shards get about the same bytes
+ * @param ShardTest - Test suite
+ * @param PartitionsCoverEveryFileOnce - Test name
+ */
+TEST(ShardTest, PartitionsCoverEveryFileOnce)
+{
+    std::vector<std::string> keys;
+    std::vector<std::uintmax_t> sizes;
+
+    for (std::size_t i{}; i < 200; ++i)
+    {
+        keys.push_back("file" + std::to_string(i) + ".cs");
+        sizes.push_back((i * 7919) % 100000);
+    }
+
+    for (const auto strategy : {ShardStrategy::Hash, ShardStrategy::Size})
+    {
+        std::vector<std::size_t> owners(keys.size(), 0);
+        std::vector<std::uintmax_t> loads;
+
+        for (std::size_t shard{}; shard < 3; ++shard)
+        {
+            const auto selected = select_shard(keys, sizes, {shard, 3, strategy});
+            std::uintmax_t load{};
+
+            EXPECT_TRUE(std::is_sorted(selected.begin(), selected.end()));
+
+            for (const auto index : selected)
+            {
+                ++owners[index];
+                load += sizes[index];
+            }
+
+            loads.push_back(load);
+        }
+
+        EXPECT_TRUE(std::all_of(owners.begin(), owners.end(),
+                                [](std::size_t count)
+                                { return count == 1; }));
+
+        if (strategy == ShardStrategy::Size)
+        {
+            const auto [lightest, heaviest] =
+                std::minmax_element(loads.begin(), loads.end());
+            EXPECT_LE(*heaviest - *lightest, 100000u);
+        }
+    }
+}
+
+/**
+ * @brief
+ * Checks the parsing of --shard values
+ * @param ShardTest - Test suite
+ * @param ParsesShardValues - Test name
+ */
+TEST(ShardTest, ParsesShardValues)
+{
+    const auto shard = parse_shard("1/4");
+    EXPECT_EQ(shard.index, 1u);
+    EXPECT_EQ(shard.count, 4u);
+
+    EXPECT_THROW(parse_shard("4/4"), std::invalid_argument);
+    EXPECT_THROW(parse_shard("1"), std::invalid_argument);
+    EXPECT_THROW(parse_shard("a/2"), std::invalid_argument);
+    EXPECT_THROW(parse_shard("0/0"), std::invalid_argument);
+    EXPECT_EQ(parse_shard_strategy("size"), ShardStrategy::Size);
+    EXPECT_THROW(parse_shard_strategy("round-robin"), std::invalid_argument);
+}
+
+/**
+ * @brief
+ * Checks that manifests only merge when they form one whole run, and
+ * that the merged files are sorted by path
+ * @param ShardTest - Test suite
+ * @param MergeNeedsEveryShardOnce - Test name
+ */
+TEST(ShardTest, MergeNeedsEveryShardOnce)
+{
+    ShardManifest first;
+    first.shard_count = 2;
+    first.files = {{"in/b.cs", "b.html", 10}};
+
+    ShardManifest second = first;
+    second.shard = 1;
+    second.dropped = 3;
+    second.files = {{"in/a.cs", "a.html", 20}};
+
+    const auto merged = merge_manifests({first, second});
+    ASSERT_EQ(merged.files.size(), 2u);
+    EXPECT_EQ(merged.files[0].path, "in/a.cs");
+    EXPECT_EQ(merged.shard_count, 1u);
+    EXPECT_EQ(merged.dropped, 3u);
+
+    EXPECT_THROW(merge_manifests({first}), std::runtime_error);
+    EXPECT_THROW(merge_manifests({first, first}), std::runtime_error);
+
+    second.files.push_back(first.files.front());
+    EXPECT_THROW(merge_manifests({first, second}), std::runtime_error);
+}
+
+/**
+ * @brief
+ * Checks that saved statistics load back equal, including previews with
+ * escaped and non ASCII characters, so that merged shards match a run
+ * over the whole corpus
+ * @param ShardTest - Test suite
+ * @param StatisticsRoundTrip - Test name
+ */
+TEST(ShardTest, StatisticsRoundTrip)
+{
+    TokenStats file;
+    file.add("class", TokenType::Keyword);
+    file.add("  \n", TokenType::Other);
+    file.add("\"tab\there \\ \x01 \xc3\xa9\"", TokenType::Literal);
+    file.add("// comment", TokenType::Comment);
+    file.set_source_bytes(42);
+
+    CorpusStats stats;
+    stats.add_file("in/b.cs", file);
+    stats.add_file("in/a.cs", file);
+    stats.sort_files();
+    stats.merge();
+
+    const auto path =
+        (std::filesystem::temp_directory_path() / "lexer_stats_test.json").string();
+    stats.save(path);
+
+    const auto loaded = CorpusStats::load(path);
+    EXPECT_EQ(loaded.to_json(), stats.to_json());
+    EXPECT_EQ(loaded.get_files().front().first, "in/a.cs");
+    EXPECT_EQ(loaded.get_total().get_source_bytes(), 84u);
+
+    std::filesystem::remove(path);
+}
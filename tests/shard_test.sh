@@ -0,0 +1,80 @@
+#!/bin/sh
+#
+# Runs a synthetic corpus as three local shard processes, merges them and
+# checks the merged outputs and statistics against an unsharded run.
+# Shards by hash write bundles, shards by size share an output directory.
+#
+# Usage: shard_test.sh <Lexer> <corpus_gen>
+
+set -eu
+
+if [ "$#" -ne 2 ]; then
+    echo "Usage: $0 <Lexer> <corpus_gen>" >&2
+    exit 2
+fi
+
+lexer=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+corpus_gen=$(cd "$(dirname "$2")" && pwd)/$(basename "$2")
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+"$corpus_gen" --out="$work/in" --files=60 --mean-size=4096 --seed=47 >/dev/null
+
+# A duplicate, lexed once when both copies land in the same shard
+cp "$work/in/file0000000.cs" "$work/in/copy.cs"
+
+# The lexer writes to ../outputParallel
+mkdir -p "$work/run/b" "$work/run/outputSingle" "$work/run/outputParallel"
+cd "$work/run/b"
+
+"$lexer" ../../in --mode=multi --stats=../whole.json >/dev/null
+mv ../outputParallel ../whole
+
+for strategy in hash size; do
+    rm -rf ../outputParallel ../merged
+    mkdir ../outputParallel
+
+    pids=""
+
+    for shard in 0 1 2; do
+        bundle=""
+
+        if [ "$strategy" = hash ]; then
+            bundle="--bundle=../shard$shard.bundle"
+        fi
+
+        "$lexer" ../../in --mode=multi --shard=$shard/3 --shard-by=$strategy \
+            --stats=../stats$shard.json --manifest=../manifest$shard.json \
+            $bundle >/dev/null &
+        pids="$pids $!"
+    done
+
+    for pid in $pids; do
+        wait "$pid"
+    done
+
+    if [ "$strategy" = hash ]; then
+        "$lexer" merge ../manifest0.json ../manifest1.json ../manifest2.json \
+            --manifest=../merged.json --stats=../merged_stats.json \
+            --bundle=../merged.bundle >/dev/null
+        "$lexer" unbundle ../merged.bundle ../merged >/dev/null
+    else
+        "$lexer" merge ../manifest0.json ../manifest1.json ../manifest2.json \
+            --manifest=../merged.json --stats=../merged_stats.json >/dev/null
+        mv ../outputParallel ../merged
+    fi
+
+    diff -r ../whole ../merged
+    cmp ../whole.json ../merged_stats.json
+
+    # Every file once in the merged manifest
+    test "$(grep -c '"path"' ../merged.json)" -eq 61
+
+    # An incomplete set of shards is refused
+    if "$lexer" merge ../manifest0.json ../manifest2.json 2>/dev/null; then
+        echo "merge accepted a missing shard" >&2
+        exit 1
+    fi
+
+    echo "shards by $strategy: OK"
+done
@@ -0,0 +1,63 @@
+#!/bin/sh
+#
+# Lexes a corpus with files cut into tiny chunks and with whole files, and
+# checks that both runs write the same outputs and statistics, with and
+# without configured symbols.
+#
+# Usage: split_test.sh <Lexer> <corpus_gen>
+
+set -eu
+
+if [ "$#" -ne 2 ]; then
+    echo "Usage: $0 <Lexer> <corpus_gen>" >&2
+    exit 2
+fi
+
+lexer=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+corpus_gen=$(cd "$(dirname "$2")" && pwd)/$(basename "$2")
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+"$corpus_gen" --out="$work/in" --files=20 --mean-size=8192 \
+    --pathological=0.2 --seed=32 >/dev/null
+
+# Blank lines, #if regions and a token longer than --max-token, wherever
+# the chunk boundaries fall
+long=$(printf '%02000d' 0 | tr 0 x)
+i=0
+
+while [ $i -lt 300 ]; do
+    echo "int v$i = $i; // line $i"
+    echo
+
+    if [ $((i % 40)) -eq 0 ]; then
+        printf '#if DEBUG\n  int d%s;\n\n#else\n  int r%s;\n#endif\n' $i $i
+    fi
+
+    if [ $i -eq 150 ]; then
+        echo "var $long = 1;"
+    fi
+
+    i=$((i + 1))
+done >"$work/in/directives.cs"
+
+# The lexer writes to ../outputParallel
+mkdir -p "$work/run/b" "$work/run/outputSingle" "$work/run/outputParallel"
+cd "$work/run/b"
+
+for define in "" "--define=DEBUG"; do
+    for split in 0 777; do
+        rm -rf ../outputParallel
+        mkdir ../outputParallel
+
+        "$lexer" ../../in --mode=multi --max-token=1000 --split-size=$split \
+            --stats=../stats$split.json $define >/dev/null
+        mv ../outputParallel ../out$split
+    done
+
+    diff -r ../out0 ../out777
+    cmp ../stats0.json ../stats777.json
+    rm -rf ../out0 ../out777
+
+    echo "split files ${define:-without symbols}: OK"
+done
@@ -0,0 +1,243 @@
+/**
+ * @file task_queue_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the Task and TaskQueue classes
+ * @version 0.1
+ * @date 2023-06-20
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/threads/batch.h"
+#include "../src/threads/task_queue.h"
+
+/**
+ * @brief
+ * Checks that tasks hold move-only and oversized callables, and release
+ * what they captured when reset
+ * @param TaskQueueTest - Test suite
+ * @param TaskHoldsAnyCallable - Test name
+ */
+TEST(TaskQueueTest, TaskHoldsAnyCallable)
+{
+    int calls{};
+    auto owned = std::make_unique<int>(1);
+    std::array<char, 4 * Task::inline_size> large{};
+    large[0] = 2;
+
+    Task small([&calls, owned = std::move(owned)]()
+               { calls += *owned; });
+    Task big([&calls, large]()
+             { calls += large[0]; });
+
+    Task moved(std::move(small));
+    moved();
+    big();
+
+    EXPECT_FALSE(small);
+    EXPECT_EQ(calls, 3);
+
+    auto shared = std::make_shared<int>(0);
+    Task holder([shared]() {});
+
+    EXPECT_EQ(shared.use_count(), 2);
+    holder.reset();
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+/**
+ * @brief
+ * Checks that the queue is first in first out, reports when it is full,
+ * and that a bulk push only takes what fits
+ * @param TaskQueueTest - Test suite
+ * @param BoundedFifo - Test name
+ */
+TEST(TaskQueueTest, BoundedFifo)
+{
+    TaskQueue queue(8);
+    std::vector<int> order;
+    std::vector<Task> tasks;
+
+    for (int i{}; i < 10; ++i)
+        tasks.emplace_back([&order, i]()
+                           { order.push_back(i); });
+
+    EXPECT_EQ(queue.capacity(), 8u);
+    EXPECT_TRUE(queue.try_push(tasks[0]));
+    EXPECT_EQ(queue.try_push_bulk(tasks.data() + 1, 9), 7u);
+    EXPECT_FALSE(queue.try_push(tasks[8]));
+    EXPECT_EQ(queue.size(), 8u);
+
+    Task task;
+
+    while (queue.try_pop(task))
+        task();
+
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+    EXPECT_EQ(queue.try_push_bulk(tasks.data() + 8, 2), 2u);
+}
+
+/**
+ * @brief
+ * Checks that every task is popped exactly once with several producers,
+ * some pushing in bulk, and several consumers, through a small ring that
+ * wraps around many times
+ * @param TaskQueueTest - Test suite
+ * @param ConcurrentProducersAndConsumers - Test name
+ */
+TEST(TaskQueueTest, ConcurrentProducersAndConsumers)
+{
+    constexpr int producers = 4;
+    constexpr int per_producer = 20000;
+
+    TaskQueue queue(64);
+    std::atomic<long> sum{0};
+    std::atomic<int> popped{0};
+    std::vector<std::thread> threads;
+
+    for (int producer{}; producer < producers; ++producer)
+        threads.emplace_back([&, producer]()
+                             {
+            std::vector<Task> tasks;
+
+            for (int i{}; i < per_producer; i += 4)
+            {
+                tasks.clear();
+
+                for (int k{}; k < 4; ++k)
+                    tasks.emplace_back([&sum, value = i + k]()
+                                       { sum += value; });
+
+                std::size_t pushed{};
+
+                while (pushed < tasks.size())
+                {
+                    pushed += producer % 2 == 0
+                                  ? queue.try_push_bulk(tasks.data() + pushed,
+                                                        tasks.size() - pushed)
+                                  : queue.try_push(tasks[pushed]);
+                    std::this_thread::yield();
+                }
+            } });
+
+    for (int consumer{}; consumer < 4; ++consumer)
+        threads.emplace_back([&]()
+                             {
+            Task task;
+
+            while (popped < producers * per_producer)
+            {
+                if (queue.try_pop(task))
+                {
+                    task();
+                    task.reset();
+                    ++popped;
+                }
+                else
+                    std::this_thread::yield();
+            } });
+
+    for (auto &thread : threads)
+        thread.join();
+
+    const long expected = static_cast<long>(per_producer - 1) * per_producer / 2;
+
+    EXPECT_EQ(popped, producers * per_producer);
+    EXPECT_EQ(sum, producers * expected);
+}
+
+/**
+ * @brief
+ * Checks that a pool with a tiny queue runs every task of bulk
+ * submissions made from its own workers, which run what does not fit
+ * instead of waiting
+ * @param TaskQueueTest - Test suite
+ * @param PoolBulkFromWorkers - Test name
+ */
+TEST(TaskQueueTest, PoolBulkFromWorkers)
+{
+    ThreadPool pool(2, false, 4);
+    Batch batch(pool);
+    std::atomic<int> counter{0};
+
+    batch.submit_bulk(0, 8, [&batch, &counter](std::size_t)
+                      { batch.submit_bulk(0, 100, [&counter](std::size_t)
+                                          { ++counter; }); });
+
+    batch.wait();
+    pool.wait_idle();
+
+    EXPECT_EQ(counter, 800);
+    EXPECT_EQ(batch.get_pending(), 0u);
+}
+
+/**
+ * @brief
+ * Checks that a task throwing does not end its worker nor keep wait_idle
+ * from returning, and that wait_idle reports the exception once
+ * @param TaskQueueTest - Test suite
+ * @param PoolKeepsTaskExceptions - Test name
+ */
+TEST(TaskQueueTest, PoolKeepsTaskExceptions)
+{
+    ThreadPool pool(1);
+    std::atomic<int> counter{0};
+
+    pool.post([]()
+              { throw std::runtime_error("task failed"); });
+    pool.post([&counter]()
+              { ++counter; });
+
+    EXPECT_THROW(pool.wait_idle(), std::runtime_error);
+    EXPECT_EQ(counter, 1);
+
+    pool.post([&counter]()
+              { ++counter; });
+
+    EXPECT_NO_THROW(pool.wait_idle());
+    EXPECT_EQ(counter, 2);
+}
+
+/**
+ * @brief
+ * Checks that threads outside of the pool submitting to a full queue
+ * wait for room and every task still runs
+ * @param TaskQueueTest - Test suite
+ * @param PoolBlocksOutsideSubmitters - Test name
+ */
+TEST(TaskQueueTest, PoolBlocksOutsideSubmitters)
+{
+    ThreadPool pool(2, false, 2);
+    std::atomic<int> counter{0};
+    std::vector<std::thread> submitters;
+
+    for (int i{}; i < 4; ++i)
+        submitters.emplace_back([&pool, &counter]()
+                                {
+            for (int j{}; j < 50; ++j)
+                pool.post([&counter]()
+                          {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    ++counter; }); });
+
+    for (auto &submitter : submitters)
+        submitter.join();
+
+    pool.wait_idle();
+    EXPECT_EQ(counter, 200);
+}
@@ -0,0 +1,71 @@
+/**
+ * @file token_registry_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the token registry
+ * @version 0.1
+ * @date 2023-06-25
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <string>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/token/token_registry.h"
+
+/**
+ * @brief
+ * Checks that the names and the HTML tags generated at compile time match
+ * the registry for every token type
+ * @param TokenRegistryTest - Test suite
+ * @param TablesFollowRegistry - Test name
+ */
+TEST(TokenRegistryTest, TablesFollowRegistry)
+{
+    static_assert(token_html_tags[static_cast<std::size_t>(TokenType::Keyword)] ==
+                  "<span class=\"Keyword\">");
+
+    for (std::size_t i{}; i < token_type_count; ++i)
+    {
+        const auto type = static_cast<TokenType>(i);
+        const auto &info = token_info(type);
+
+        EXPECT_EQ(to_string(type), info.name);
+        EXPECT_EQ(token_html_tags[i].empty(), !info.highlighted);
+
+        if (info.highlighted)
+        {
+            EXPECT_EQ(token_html_tags[i],
+                      "<span class=\"" + std::string(info.name) + "\">");
+        }
+    }
+
+    EXPECT_TRUE(token_html_tags[static_cast<std::size_t>(TokenType::Other)].empty());
+    EXPECT_EQ(token_word_count(), 175u);
+}
+
+/**
+ * @brief
+ * Checks that the stylesheet has a color and a class for every token type
+ * @param TokenRegistryTest - Test suite
+ * @param StylesCoverEveryType - Test name
+ */
+TEST(TokenRegistryTest, StylesCoverEveryType)
+{
+    const auto css = generate_styles();
+
+    EXPECT_NE(css.find("--numeric-literal-color: #d19a66;"), std::string::npos);
+    EXPECT_NE(css.find(".Keyword {\n  color: var(--keyword-color);\n"
+                       "  font-weight: bold;\n}"),
+              std::string::npos);
+
+    for (const auto &info : token_types)
+        EXPECT_NE(css.find("." + std::string(info.name) + " {"), std::string::npos)
+            << info.name;
+}
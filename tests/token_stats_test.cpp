@@ -0,0 +1,130 @@
+/**
+ * @file token_stats_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the TokenStats class
+ * @version 0.1
+ * @date 2023-06-09
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/lexer/lexer.h"
+#include "../src/stats/token_stats.h"
+
+/**
+ * @brief
+ * Checks that a token cut by the maximum token length counts once at its
+ * whole length, and that inactive regions are not counted as code
+ * @param TokenStatsTest - Test suite
+ * @param CountsWholeTokensAndInactiveCode - Test name
+ */
+TEST(TokenStatsTest, CountsWholeTokensAndInactiveCode)
+{
+    namespace fs = std::filesystem;
+
+    const auto root = fs::temp_directory_path() / "lexer_stats_test_run";
+    fs::remove_all(root);
+    fs::create_directories(root / "b");
+    fs::create_directories(root / "outputSingle");
+
+    const auto source = (root / "a.cs").string();
+    const std::string name(40, 'x');
+    std::ofstream(source) << "int " << name << ";\n#if false\nint b;\n#endif\n";
+
+    // The lexer writes to ../outputSingle
+    const auto previous = fs::current_path();
+    fs::current_path(root / "b");
+
+    Lexer whole;
+    whole.set_collect_stats(true);
+    whole.start_single({source});
+
+    Lexer cut;
+    cut.set_max_token_length(16);
+    cut.set_collect_stats(true);
+    cut.start_single({source});
+
+    fs::current_path(previous);
+    fs::remove_all(root);
+
+    EXPECT_EQ(cut.get_stats().to_json(), whole.get_stats().to_json());
+
+    const auto &stats = cut.get_stats().get_total();
+    EXPECT_EQ(stats.get_longest().front().length, name.size());
+    EXPECT_EQ(stats.get_inactive_bytes(), 8u);
+
+    // int, the name, ';' and the directives
+    EXPECT_EQ(stats.get_code_bytes(),
+              std::string("int;#if false#endif").size() + name.size());
+}
+
+/**
+ * @brief
+ * Checks that a file lexed in chunks by a parallel run gets the same
+ * statistics as when it is lexed whole, long tokens and whitespace runs
+ * cut at chunk boundaries included
+ * @param TokenStatsTest - Test suite
+ * @param SplitFilesMatchWholeFiles - Test name
+ */
+TEST(TokenStatsTest, SplitFilesMatchWholeFiles)
+{
+    namespace fs = std::filesystem;
+
+    const auto root = fs::temp_directory_path() / "lexer_split_stats_test";
+    fs::remove_all(root);
+    fs::create_directories(root / "b");
+    fs::create_directories(root / "outputParallel");
+
+    const auto source = (root / "a.cs").string();
+
+    {
+        std::ofstream output(source);
+
+        for (int i{}; i < 2000; ++i)
+        {
+            output << "int v" << i << " = " << i << "; // line\n\n";
+
+            if (i == 1000)
+                output << "var " << std::string(5000, 'x') << " = 1;\n";
+
+            if (i % 300 == 0)
+                output << "#if false\nint q;\n#endif\n";
+        }
+    }
+
+    // The lexer writes to ../outputParallel
+    const auto previous = fs::current_path();
+    fs::current_path(root / "b");
+
+    auto run = [&source](std::size_t split_size)
+    {
+        Lexer lexer;
+        lexer.set_worker_count(4);
+        lexer.set_max_token_length(1000);
+        lexer.set_split_size(split_size);
+        lexer.set_collect_stats(true);
+        lexer.start_multi({source});
+
+        return lexer.get_stats().to_json();
+    };
+
+    const auto whole = run(0);
+    const auto split = run(4096);
+
+    fs::current_path(previous);
+    fs::remove_all(root);
+
+    EXPECT_EQ(split, whole);
+    EXPECT_NE(whole.find("\"length\": 5000"), std::string::npos);
+}
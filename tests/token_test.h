@@ -14,7 +14,7 @@
 #include <gtest/gtest.h>
 
 // Project files
-#include "../src/token.h"
+#include "../src/token/token.h"
 
 /**
  * @brief
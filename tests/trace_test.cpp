@@ -0,0 +1,91 @@
+/**
+ * @file trace_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the Trace class
+ * @version 0.1
+ * @date 2023-06-23
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <string>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/stats/trace.h"
+#include "../src/threads/batch.h"
+
+/**
+ * @brief
+ * Checks that spans are only recorded while the trace is enabled, and
+ * that their file, size and thread name end up in the events
+ * @param TraceTest - Test suite
+ * @param RecordsEnabledSpans - Test name
+ */
+TEST(TraceTest, RecordsEnabledSpans)
+{
+    Trace trace;
+
+    {
+        Trace::Span span(trace, "ignored", "cpu");
+    }
+
+    EXPECT_EQ(trace.get_event_count(), 0u);
+
+    trace.set_enabled(true);
+    trace.set_thread_name("main");
+
+    {
+        Trace::Span outer(trace, "lex", "cpu", "a \"quoted\".cs", 42);
+        Trace::Span inner(trace, "read", "io");
+    }
+
+    const auto json = trace.to_json();
+
+    EXPECT_EQ(trace.get_event_count(), 2u);
+    EXPECT_NE(json.find("\"name\":\"main\""), std::string::npos);
+    EXPECT_NE(json.find("\"file\":\"a \\\"quoted\\\".cs\",\"bytes\":42"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"read\",\"cat\":\"io\",\"ph\":\"X\""),
+              std::string::npos);
+
+    trace.clear();
+    EXPECT_EQ(trace.get_event_count(), 0u);
+}
+
+/**
+ * @brief
+ * Checks that a traced pool records every task on its worker with the
+ * time it spent in the queue
+ * @param TraceTest - Test suite
+ * @param PoolTasksCarryQueueWait - Test name
+ */
+TEST(TraceTest, PoolTasksCarryQueueWait)
+{
+    Trace trace;
+    trace.set_enabled(true);
+
+    ThreadPool pool(2);
+    pool.set_trace(&trace);
+
+    Batch batch(pool);
+    batch.submit_bulk(0, 10, [](std::size_t) {});
+    batch.wait();
+    pool.wait_idle();
+
+    const auto json = trace.to_json();
+    std::size_t tasks{};
+
+    for (auto position = json.find("\"name\":\"task\""); position != std::string::npos;
+         position = json.find("\"name\":\"task\"", position + 1))
+        ++tasks;
+
+    EXPECT_EQ(tasks, 10u);
+    EXPECT_NE(json.find("\"queue_wait_us\":"), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"worker\""), std::string::npos);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file watcher_test.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Tests for the Watcher class
+ * @version 0.1
+ * @date 2023-06-05
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Project files
+#include "../src/watch/watcher.h"
+
+namespace
+{
+    /**
+     * @brief
+     * Waits for a condition to hold
+     * @param condition Condition to check
+     * @return true If it held within five seconds
+     */
+    bool wait_for(const std::function<bool()> &condition)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        return true;
+    }
+}
+
+/**
+ * @brief
+ * Checks that the outputs follow the files of the directory: missing
+ * ones are written first, a file rewritten nonstop is highlighted once the
+ * maximum delay passes, and a removed file loses its output and its pages
+ * @param WatcherTest - Test suite
+ * @param FollowsTheDirectory - Test name
+ */
+TEST(WatcherTest, FollowsTheDirectory)
+{
+    namespace fs = std::filesystem;
+
+    const auto root = fs::temp_directory_path() / "lexer_watcher_test";
+    fs::remove_all(root);
+    fs::create_directories(root / "in");
+    fs::create_directories(root / "b");
+    fs::create_directories(root / "outputParallel");
+
+    std::ofstream(root / "in" / "a.cs") << "int a = 1;\n";
+
+    // The lexer writes to ../outputParallel
+    const auto previous = fs::current_path();
+    fs::current_path(root / "b");
+
+    const auto output = root / "outputParallel";
+
+    {
+        Lexer lexer;
+        lexer.set_worker_count(2);
+
+        Watcher watcher(lexer, (root / "in").string(),
+                        std::chrono::milliseconds(100),
+                        std::chrono::milliseconds(300));
+        std::thread thread([&watcher]()
+                           { watcher.run(); });
+
+        EXPECT_TRUE(wait_for([&]()
+                             { return fs::exists(output / "a.html"); }));
+
+        // Writes every 20 ms never leave the directory quiet for 100 ms
+        bool highlighted = false;
+
+        for (int i{}; i < 100 && !highlighted; ++i)
+        {
+            std::ofstream(root / "in" / "busy.cs") << "int b = " << i << ";\n";
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            highlighted = fs::exists(output / "busy.html");
+        }
+
+        EXPECT_TRUE(highlighted);
+
+        // Pages of a paginated run go with the output
+        std::ofstream(output / "a.p1.html") << "page";
+        fs::remove(root / "in" / "a.cs");
+
+        EXPECT_TRUE(wait_for([&]()
+                             { return !fs::exists(output / "a.html") &&
+                                      !fs::exists(output / "a.p1.html"); }));
+
+        watcher.stop();
+        thread.join();
+    }
+
+    fs::current_path(previous);
+    fs::remove_all(root);
+}
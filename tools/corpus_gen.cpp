@@ -0,0 +1,721 @@
+/**
+ * @file corpus_gen.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Generator of reproducible synthetic C# corpora
+ * @version 0.1
+ * @date 2023-06-24
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief
+     * Shapes of the distribution of file sizes
+     * @enum Distribution
+     */
+    enum class Distribution
+    {
+        Fixed,
+        Uniform,
+        Lognormal,
+        Pareto
+    };
+
+    /**
+     * @brief
+     * Parameters of a corpus
+     * @struct Config
+     */
+    struct Config
+    {
+        std::string output_directory;
+        std::uint64_t seed{1};
+        std::size_t files{0};
+        std::uint64_t total_size{0};
+        Distribution distribution{Distribution::Lognormal};
+        std::uint64_t mean_size{8 * 1024};
+        std::uint64_t max_size{64 * 1024 * 1024};
+        double pareto_alpha{1.2};
+        double comment_density{0.15};
+        double string_density{0.2};
+        double pathological{0.0};
+        std::size_t threads{0};
+    };
+
+    /**
+     * @brief
+     * Small, fast random generator (SplitMix64) whose sequence, unlike
+     * the standard distributions, is the same with every compiler and
+     * library, so a seed always gives the same corpus
+     * @class Random
+     */
+    class Random
+    {
+    public:
+        /**
+         * @brief
+         * Construct a new Random object
+         * @param seed Seed of the sequence
+         */
+        explicit Random(std::uint64_t seed) : m_state(seed) {}
+
+        /**
+         * @brief
+         * Gets the next 64 random bits
+         * @return std::uint64_t Random bits
+         */
+        std::uint64_t next()
+        {
+            std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        /**
+         * @brief
+         * Gets a number uniformly distributed in [0, 1)
+         * @return double Random number
+         */
+        double uniform()
+        {
+            return static_cast<double>(next() >> 11) * 0x1.0p-53;
+        }
+
+        /**
+         * @brief
+         * Gets an integer uniformly distributed in [0, bound)
+         * @param bound Upper bound, excluded
+         * @return std::size_t Random integer
+         */
+        std::size_t below(std::size_t bound)
+        {
+            return static_cast<std::size_t>(uniform() * static_cast<double>(bound));
+        }
+
+        /**
+         * @brief
+         * Gets true with a given probability
+         * @param probability Probability of true
+         * @return true With the given probability
+         */
+        bool chance(double probability)
+        {
+            return uniform() < probability;
+        }
+
+        /**
+         * @brief
+         * Gets a normally distributed number (Box-Muller)
+         * @return double Random number of mean 0 and deviation 1
+         */
+        double normal()
+        {
+            const double u = 1.0 - uniform();
+            const double v = uniform();
+            return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * M_PI * v);
+        }
+
+        /**
+         * @brief
+         * Picks an element of a list
+         * @tparam T Element type
+         * @param items List to pick from
+         * @return const T& Picked element
+         */
+        template <class T>
+        const T &pick(const std::vector<T> &items)
+        {
+            return items[below(items.size())];
+        }
+
+    private:
+        std::uint64_t m_state;
+    };
+
+    /**
+     * @brief
+     * Seed of one file, independent of the number of files generated, so
+     * a larger corpus starts with the files of a smaller one
+     * @param seed Seed of the corpus
+     * @param index Index of the file
+     * @param stream Purpose of the numbers, so sizes and contents differ
+     * @return std::uint64_t Seed of the file
+     */
+    std::uint64_t file_seed(std::uint64_t seed, std::size_t index, std::uint64_t stream)
+    {
+        Random random(seed ^ (stream * 0xD6E8FEB86659FD93ull));
+
+        for (std::size_t i{}; i < 2; ++i)
+            random.next();
+
+        return random.next() ^ (static_cast<std::uint64_t>(index) * 0x9E3779B97F4A7C15ull);
+    }
+
+    const std::vector<std::string_view> types{
+        "int", "long", "string", "bool", "double", "var", "object",
+        "List<int>", "Dictionary<string, int>", "Task<string>", "byte[]"};
+
+    const std::vector<std::string_view> words{
+        "value", "count", "index", "result", "buffer", "item", "node",
+        "customer", "order", "total", "name", "path", "stream", "token",
+        "cache", "entry", "handler", "request", "response", "context",
+        "parent", "child", "offset", "length", "state", "config", "logger"};
+
+    const std::vector<std::string_view> prose{
+        "the", "value", "is", "checked", "before", "it", "is", "used",
+        "this", "returns", "null", "when", "nothing", "matches", "see",
+        "remarks", "for", "details", "TODO", "handle", "overflow", "fast",
+        "path", "keeps", "allocations", "low"};
+
+    /**
+     * @brief
+     * Builds an identifier from the word list
+     * @param random Random generator
+     * @param capitalized Whether the first letter is uppercase
+     * @return std::string Identifier
+     */
+    std::string identifier(Random &random, bool capitalized = false)
+    {
+        std::string name(random.pick(words));
+
+        if (random.chance(0.5))
+        {
+            std::string second(random.pick(words));
+            second[0] = static_cast<char>(std::toupper(second[0]));
+            name += second;
+        }
+
+        if (capitalized)
+            name[0] = static_cast<char>(std::toupper(name[0]));
+
+        return name;
+    }
+
+    /**
+     * @brief
+     * Builds a sentence for comments and strings
+     * @param random Random generator
+     * @param length Number of words
+     * @return std::string Sentence
+     */
+    std::string sentence(Random &random, std::size_t length)
+    {
+        std::string text;
+
+        for (std::size_t i{}; i < length; ++i)
+        {
+            if (i != 0)
+                text += ' ';
+
+            text += random.pick(prose);
+        }
+
+        return text;
+    }
+
+    /**
+     * @brief
+     * Builds an expression with literals, calls and operators
+     * @param random Random generator
+     * @param config Densities of the corpus
+     * @return std::string Expression
+     */
+    std::string expression(Random &random, const Config &config)
+    {
+        if (random.chance(config.string_density))
+        {
+            switch (random.below(3))
+            {
+            case 0:
+                return "\"" + sentence(random, 1 + random.below(8)) + "\"";
+            case 1:
+                return "$\"{" + identifier(random) + "} " +
+                       sentence(random, 1 + random.below(4)) + "\"";
+            default:
+                return "@\"C:\\" + identifier(random) + "\\" +
+                       identifier(random) + ".txt\"";
+            }
+        }
+
+        switch (random.below(5))
+        {
+        case 0:
+            return std::to_string(random.below(100000));
+        case 1:
+            return std::to_string(random.below(1000)) + "." +
+                   std::to_string(random.below(100));
+        case 2:
+            return identifier(random) + "." + identifier(random, true) + "(" +
+                   identifier(random) + ")";
+        case 3:
+            return identifier(random) + " " +
+                   std::string(random.pick(std::vector<std::string_view>{
+                       "+", "-", "*", "/", "%", "&&", "||", "==", "!=", "<=", ">="})) +
+                   " " + identifier(random);
+        default:
+            return identifier(random) + "[" + std::to_string(random.below(16)) + "]";
+        }
+    }
+
+    /**
+     * @brief
+     * Appends one statement, possibly preceded or followed by a comment
+     * @param output Source to append to
+     * @param random Random generator
+     * @param config Densities of the corpus
+     * @param indent Indentation of the statement
+     */
+    void append_statement(std::string &output, Random &random,
+                          const Config &config, const std::string &indent)
+    {
+        if (random.chance(config.comment_density))
+        {
+            if (random.chance(0.7))
+                output += indent + "// " + sentence(random, 3 + random.below(10)) + "\n";
+            else
+                output += indent + "/* " + sentence(random, 5 + random.below(20)) +
+                          "\n" + indent + "   " + sentence(random, 3 + random.below(10)) +
+                          " */\n";
+        }
+
+        switch (random.below(6))
+        {
+        case 0:
+            output += indent + std::string(random.pick(types)) + " " +
+                      identifier(random) + " = " + expression(random, config) + ";\n";
+            break;
+        case 1:
+            output += indent + "if (" + expression(random, config) + ")\n" + indent +
+                      "{\n" + indent + "    return " + expression(random, config) +
+                      ";\n" + indent + "}\n";
+            break;
+        case 2:
+            output += indent + "for (int i = 0; i < " + identifier(random) +
+                      ".Count; i++)\n" + indent + "    " + identifier(random) +
+                      " += " + expression(random, config) + ";\n";
+            break;
+        case 3:
+            output += indent + "Console.WriteLine(" + expression(random, config) + ");\n";
+            break;
+        case 4:
+            output += indent + "await " + identifier(random) + "." +
+                      identifier(random, true) + "Async(" + expression(random, config) +
+                      ").ConfigureAwait(false);\n";
+            break;
+        default:
+            output += indent + identifier(random) + " = " + expression(random, config) +
+                      ";";
+
+            if (random.chance(config.comment_density))
+                output += " // " + sentence(random, 2 + random.below(6));
+
+            output += "\n";
+            break;
+        }
+    }
+
+    /**
+     * @brief
+     * Generates ordinary C# source of about a given size: usings, a
+     * namespace, and classes of documented methods
+     * @param random Random generator
+     * @param config Densities of the corpus
+     * @param size Size to reach; the file ends at the first class end past it
+     * @return std::string Source code
+     */
+    std::string generate_source(Random &random, const Config &config,
+                                std::uint64_t size)
+    {
+        std::string output;
+        output.reserve(size + 4096);
+
+        output += "using System;\nusing System.Collections.Generic;\n"
+                  "using System.Threading.Tasks;\n\nnamespace " +
+                  identifier(random, true) + "." + identifier(random, true) + "\n{\n";
+
+        while (output.size() < size)
+        {
+            output += "    public class " + identifier(random, true) + "\n    {\n";
+
+            for (std::size_t method = 1 + random.below(6);
+                 method != 0 && output.size() < size; --method)
+            {
+                if (random.chance(config.comment_density * 2))
+                    output += "        /// <summary>\n        /// " +
+                              sentence(random, 4 + random.below(12)) +
+                              "\n        /// </summary>\n";
+
+                output += "        " +
+                          std::string(random.pick(std::vector<std::string_view>{
+                              "public", "private", "protected", "internal"})) +
+                          (random.chance(0.3) ? " static " : " ") +
+                          std::string(random.pick(types)) + " " +
+                          identifier(random, true) + "(" +
+                          std::string(random.pick(types)) + " " + identifier(random) +
+                          ")\n        {\n";
+
+                for (std::size_t statement = 2 + random.below(12); statement != 0;
+                     --statement)
+                    append_statement(output, random, config, "            ");
+
+                output += "        }\n\n";
+            }
+
+            output += "    }\n\n";
+        }
+
+        output += "}\n";
+        return output;
+    }
+
+    /**
+     * @brief
+     * Generates one of the inputs known to be hard for lexers
+     * @param random Random generator
+     * @param size Size of the input
+     * @return std::string Source code
+     */
+    std::string generate_pathological(Random &random, std::uint64_t size)
+    {
+        auto repeat = [size](std::string_view pattern, std::string prefix = {})
+        {
+            std::string result = std::move(prefix);
+            result.reserve(size + pattern.size());
+
+            while (result.size() < size)
+                result.append(pattern);
+
+            result.resize(size);
+            return result;
+        };
+
+        switch (random.below(8))
+        {
+        case 0:
+            return repeat("if(a==b){c=d+1.5;}else{e=f[g]-0x2;}");
+        case 1:
+            return repeat("a", "\"") + "\"";
+        case 2:
+            return repeat("ab cd ", "\"");
+        case 3:
+            return repeat("x *\n", "/*") + "*/";
+        case 4:
+            return repeat("x ", "/*");
+        case 5:
+            return repeat("/* ");
+        case 6:
+            return repeat("{(");
+        default:
+            return repeat("VeryLongIdentifier_");
+        }
+    }
+
+    /**
+     * @brief
+     * Draws the size of a file from the configured distribution
+     * @param random Random generator of the file
+     * @param config Distribution and its parameters
+     * @return std::uint64_t Size in bytes, at least 64
+     */
+    std::uint64_t draw_size(Random &random, const Config &config)
+    {
+        const double mean = static_cast<double>(config.mean_size);
+        double size{};
+
+        switch (config.distribution)
+        {
+        case Distribution::Fixed:
+            size = mean;
+            break;
+        case Distribution::Uniform:
+            size = 2 * mean * random.uniform();
+            break;
+        case Distribution::Lognormal:
+        {
+            // Most files near the median, a long tail of large ones
+            constexpr double sigma = 1.0;
+            size = std::exp(std::log(mean) - sigma * sigma / 2 + sigma * random.normal());
+            break;
+        }
+        case Distribution::Pareto:
+        {
+            // Heavy tail: a few files hold a large part of the corpus
+            const double alpha = std::max(config.pareto_alpha, 1.01);
+            const double minimum = mean * (alpha - 1) / alpha;
+            size = minimum / std::pow(1.0 - random.uniform(), 1.0 / alpha);
+            break;
+        }
+        }
+
+        return std::clamp<std::uint64_t>(static_cast<std::uint64_t>(size), 64,
+                                         std::max<std::uint64_t>(config.max_size, 64));
+    }
+
+    /**
+     * @brief
+     * Parses a size with an optional K, M or G suffix
+     * @param name Option name, used in the error message
+     * @param value Value to parse
+     * @return std::uint64_t Size in bytes
+     * @throw std::invalid_argument If the value is not a size
+     */
+    std::uint64_t parse_size(const std::string &name, const std::string &value)
+    {
+        try
+        {
+            std::size_t end{};
+            const auto number = std::stoull(value, &end);
+            const auto suffix = value.substr(end);
+            std::uint64_t unit = 1;
+
+            if (suffix == "K" || suffix == "k")
+                unit = 1024;
+            else if (suffix == "M" || suffix == "m")
+                unit = 1024 * 1024;
+            else if (suffix == "G" || suffix == "g")
+                unit = 1024 * 1024 * 1024;
+            else if (!suffix.empty() || value[0] == '-')
+                throw std::invalid_argument(value);
+
+            return number * unit;
+        }
+        catch (const std::exception &)
+        {
+            throw std::invalid_argument("Invalid value for " + name + ": " + value);
+        }
+    }
+
+    /**
+     * @brief
+     * Parses a fraction between 0 and 1
+     * @param name Option name, used in the error message
+     * @param value Value to parse
+     * @return double Fraction
+     * @throw std::invalid_argument If the value is not a fraction
+     */
+    double parse_fraction(const std::string &name, const std::string &value)
+    {
+        try
+        {
+            std::size_t end{};
+            const auto fraction = std::stod(value, &end);
+
+            if (end != value.size() || fraction < 0 || fraction > 1)
+                throw std::invalid_argument(value);
+
+            return fraction;
+        }
+        catch (const std::exception &)
+        {
+            throw std::invalid_argument("Invalid value for " + name + ": " + value);
+        }
+    }
+
+    /**
+     * @brief
+     * Parses the command line of the generator
+     * @param argc Number of arguments
+     * @param argv Arguments
+     * @return Config Parameters of the corpus
+     * @throw std::invalid_argument If the command line is invalid
+     */
+    Config parse_config(int argc, char **argv)
+    {
+        Config config;
+
+        for (int i{1}; i < argc; ++i)
+        {
+            const std::string argument{argv[i]};
+            const auto equals = argument.find('=');
+            const auto name = argument.substr(0, equals);
+            const auto value = equals == std::string::npos ? std::string{}
+                                                            : argument.substr(equals + 1);
+
+            if (equals == std::string::npos)
+                throw std::invalid_argument("Unknown option: " + argument);
+
+            if (name == "--out")
+                config.output_directory = value;
+            else if (name == "--seed")
+                config.seed = parse_size(name, value);
+            else if (name == "--files")
+                config.files = parse_size(name, value);
+            else if (name == "--total-size")
+                config.total_size = parse_size(name, value);
+            else if (name == "--mean-size")
+                config.mean_size = std::max<std::uint64_t>(parse_size(name, value), 64);
+            else if (name == "--max-size")
+                config.max_size = parse_size(name, value);
+            else if (name == "--pareto-alpha")
+                config.pareto_alpha = std::stod(value);
+            else if (name == "--comment-density")
+                config.comment_density = parse_fraction(name, value);
+            else if (name == "--string-density")
+                config.string_density = parse_fraction(name, value);
+            else if (name == "--pathological")
+                config.pathological = parse_fraction(name, value);
+            else if (name == "--threads")
+                config.threads = parse_size(name, value);
+            else if (name == "--distribution")
+            {
+                if (value == "fixed")
+                    config.distribution = Distribution::Fixed;
+                else if (value == "uniform")
+                    config.distribution = Distribution::Uniform;
+                else if (value == "lognormal")
+                    config.distribution = Distribution::Lognormal;
+                else if (value == "pareto")
+                    config.distribution = Distribution::Pareto;
+                else
+                    throw std::invalid_argument("Invalid value for --distribution: " + value);
+            }
+            else
+                throw std::invalid_argument("Unknown option: " + argument);
+        }
+
+        if (config.output_directory.empty())
+            throw std::invalid_argument("Missing --out");
+
+        if (config.files == 0 && config.total_size == 0)
+            throw std::invalid_argument("Missing --files or --total-size");
+
+        return config;
+    }
+
+    /**
+     * @brief
+     * Builds the usage message of the generator
+     * @param program Name of the executable
+     * @return std::string Usage message
+     */
+    std::string usage(const std::string &program)
+    {
+        return "Usage: " + program + " --out=DIR (--files=N | --total-size=BYTES) [--seed=N]\n"
+               "       [--distribution=fixed|uniform|lognormal|pareto] [--mean-size=BYTES]\n"
+               "       [--max-size=BYTES] [--pareto-alpha=A] [--comment-density=F]\n"
+               "       [--string-density=F] [--pathological=F] [--threads=N]\n"
+               "Sizes take a K, M or G suffix, densities are fractions between 0 and 1.\n";
+    }
+}
+
+/**
+ * @brief
+ * Generates a corpus of C# files. File sizes are drawn first, from a
+ * generator per file, until the file count or the total size is reached;
+ * the files are then written in parallel. The same options and seed
+ * always produce byte-identical files.
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int 0 if success, 1 if error
+ */
+int main(int argc, char **argv)
+{
+    Config config;
+
+    try
+    {
+        config = parse_config(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << "\n"
+                  << usage(argv[0]);
+        return 1;
+    }
+
+    // Sizes, and which files are pathological, only depend on the seed
+    std::vector<std::pair<std::uint64_t, bool>> plan;
+    std::uint64_t planned{};
+
+    while (config.files != 0 ? plan.size() < config.files
+                             : planned < config.total_size)
+    {
+        Random random(file_seed(config.seed, plan.size(), 1));
+        auto size = draw_size(random, config);
+
+        if (config.files == 0)
+            size = std::min(size, config.total_size - planned);
+
+        plan.emplace_back(size, random.chance(config.pathological));
+        planned += size;
+    }
+
+    try
+    {
+        std::filesystem::create_directories(config.output_directory);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    const std::size_t thread_count =
+        config.threads != 0 ? config.threads
+                            : std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::uint64_t> written{0};
+    std::atomic<std::size_t> pathological{0};
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> threads;
+
+    for (std::size_t t{}; t < thread_count; ++t)
+        threads.emplace_back([&]()
+                             {
+            for (auto index = next++; index < plan.size() && !failed; index = next++)
+            {
+                const auto [size, is_pathological] = plan[index];
+                Random random(file_seed(config.seed, index, 2));
+                const auto source = is_pathological
+                                        ? generate_pathological(random, size)
+                                        : generate_source(random, config, size);
+
+                char name[32];
+                std::snprintf(name, sizeof(name), "file%07zu.cs", index);
+
+                std::ofstream output(std::filesystem::path(config.output_directory) / name,
+                                     std::ios::out | std::ios::binary | std::ios::trunc);
+                output.write(source.data(), static_cast<std::streamsize>(source.size()));
+
+                if (!output)
+                {
+                    std::cerr << "Error: cannot write " << name << std::endl;
+                    failed = true;
+                }
+
+                written += source.size();
+                pathological += is_pathological;
+            } });
+
+    for (auto &thread : threads)
+        thread.join();
+
+    if (failed)
+        return 1;
+
+    std::cout << "Generated " << plan.size() << " files, " << written
+              << " bytes, " << pathological << " pathological, seed "
+              << config.seed << " in " << config.output_directory << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file styles_gen.cpp
+ * @author Carlos Salguero
+ * @author Sergio Garnica
+ * @brief Generator of the stylesheet of the HTML output
+ * @version 0.1
+ * @date 2023-06-25
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+// C++ standard library
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+// Project files
+#include "../src/token/token_registry.h"
+
+/**
+ * @brief
+ * Writes styles.css from the token registry, to the given file or to the
+ * standard output
+ * @param argc Number of arguments
+ * @param argv Arguments, optionally the path of the stylesheet
+ * @return int 0 if success, 1 if error
+ */
+int main(int argc, char **argv)
+{
+    const auto css = generate_styles();
+
+    if (argc < 2)
+    {
+        std::cout << css;
+        return 0;
+    }
+
+    // An existing stylesheet keeps its line breaks, so regenerating it
+    // does not rewrite every line
+    bool crlf = false;
+
+    if (std::ifstream input{argv[1], std::ios::in | std::ios::binary})
+    {
+        const std::string current((std::istreambuf_iterator<char>(input)),
+                                  std::istreambuf_iterator<char>());
+        crlf = current.find("\r\n") != std::string::npos;
+    }
+
+    std::ofstream output(argv[1], std::ios::out | std::ios::binary | std::ios::trunc);
+
+    for (const char c : css)
+    {
+        if (c == '\n' && crlf)
+            output << '\r';
+
+        output << c;
+    }
+
+    if (!output)
+    {
+        std::cerr << "Error: cannot write " << argv[1] << std::endl;
+        return 1;
+    }
+
+    return 0;
+}